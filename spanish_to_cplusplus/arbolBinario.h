@@ -0,0 +1,284 @@
+#ifndef ARBOL_BINARIO_H
+#define ARBOL_BINARIO_H
+
+#include "arbolPlano.h"
+#include "fuente.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Formato binario del AST (out/ast.bin): el ArbolPlano tal como está en
+// memoria, para que las herramientas lo abran con mmap y lo recorran en el
+// lugar, sin deserializar ni reconstruir nodos.
+//
+//   CabeceraArbol       magia "STCA", versión, tamaño de registro y el
+//                       desplazamiento de cada sección (alineado a 8)
+//   RegistroNodo[]      los registros del ArbolPlano, en orden por niveles;
+//                       los hijos son rangos [primero, primero + cantidad)
+//   EntradaCadena[]     tabla de cadenas sin repetidos: desplazamiento y
+//                       largo de cada una en la sección de texto
+//   char[]              bytes de texto
+//
+// En el archivo, el dato de una declaración, variable, literal, llamada o
+// incluir es el índice de su texto en la tabla de cadenas (los SimboloId
+// solo valen dentro del proceso que los internó) y longitud queda en 0. El
+// operador de una operación binaria sigue siendo su TokenType.
+//
+// Los enteros van en el orden de bytes de la máquina que escribió el
+// archivo; el campo orden permite rechazar los de la otra arquitectura.
+
+constexpr char MAGIA_ARBOL[4] = {'S', 'T', 'C', 'A'};
+constexpr uint16_t VERSION_ARBOL = 1;
+constexpr uint32_t ORDEN_ARBOL = 0x01020304u;
+
+struct CabeceraArbol {
+    char magia[4];
+    uint16_t version;
+    uint16_t tamRegistro;     // sizeof(RegistroNodo) al escribir
+    uint32_t orden;           // ORDEN_ARBOL
+    uint32_t cantidadNodos;
+    uint32_t cantidadCadenas;
+    uint32_t bytesTexto;
+    uint64_t inicioNodos;
+    uint64_t inicioCadenas;
+    uint64_t inicioTexto;
+    uint64_t tamArchivo;
+};
+
+struct EntradaCadena {
+    uint32_t desplazamiento;
+    uint32_t longitud;
+};
+
+static_assert(std::is_trivially_copyable<CabeceraArbol>::value, "CabeceraArbol debe copiarse con memcpy");
+static_assert(sizeof(CabeceraArbol) % 8 == 0 && sizeof(RegistroNodo) % 4 == 0,
+              "Las secciones del archivo deben quedar alineadas");
+
+// Nodos cuyo dato es un texto en el archivo
+inline bool datoEsCadena(TipoNodo tipo) {
+    return tipo == NODO_DECLARACION || tipo == NODO_VARIABLE || tipo == NODO_LITERAL ||
+           tipo == NODO_LLAMADA_FUNCION || tipo == NODO_INCLUIR;
+}
+
+namespace detalle_binario {
+
+inline uint64_t alinear(uint64_t desplazamiento) { return (desplazamiento + 7) & ~uint64_t(7); }
+
+} // namespace detalle_binario
+
+// Arma el archivo completo en memoria
+inline std::string serializarArbol(const ArbolPlano& arbol) {
+    using detalle_binario::alinear;
+    std::vector<RegistroNodo> nodos = arbol.registros();
+    std::vector<EntradaCadena> cadenas;
+    std::string texto;
+    std::unordered_map<std::string_view, uint32_t> indices;
+
+    auto internar = [&](std::string_view valor) {
+        auto [it, nuevo] = indices.emplace(valor, static_cast<uint32_t>(cadenas.size()));
+        if (nuevo) {
+            cadenas.push_back({static_cast<uint32_t>(texto.size()), static_cast<uint32_t>(valor.size())});
+            texto.append(valor);
+        }
+        return it->second;
+    };
+
+    for (RegistroNodo& nodo : nodos) {
+        TipoNodo tipo = static_cast<TipoNodo>(nodo.tipo);
+        if (tipo == NODO_DECLARACION || tipo == NODO_VARIABLE) {
+            if (nodo.dato != SIN_SIMBOLO) nodo.dato = internar(cadenasGlobales().texto(nodo.dato));
+        } else if (datoEsCadena(tipo)) {
+            nodo.dato = internar(arbol.texto(nodo));
+        }
+        if (datoEsCadena(tipo)) nodo.longitud = 0;
+    }
+
+    CabeceraArbol cabecera{};
+    std::memcpy(cabecera.magia, MAGIA_ARBOL, sizeof(MAGIA_ARBOL));
+    cabecera.version = VERSION_ARBOL;
+    cabecera.tamRegistro = sizeof(RegistroNodo);
+    cabecera.orden = ORDEN_ARBOL;
+    cabecera.cantidadNodos = static_cast<uint32_t>(nodos.size());
+    cabecera.cantidadCadenas = static_cast<uint32_t>(cadenas.size());
+    cabecera.bytesTexto = static_cast<uint32_t>(texto.size());
+    cabecera.inicioNodos = sizeof(CabeceraArbol);
+    cabecera.inicioCadenas = alinear(cabecera.inicioNodos + nodos.size() * sizeof(RegistroNodo));
+    cabecera.inicioTexto = alinear(cabecera.inicioCadenas + cadenas.size() * sizeof(EntradaCadena));
+    cabecera.tamArchivo = cabecera.inicioTexto + texto.size();
+
+    std::string bytes(cabecera.tamArchivo, '\0');
+    std::memcpy(&bytes[0], &cabecera, sizeof(cabecera));
+    if (!nodos.empty()) std::memcpy(&bytes[cabecera.inicioNodos], nodos.data(), nodos.size() * sizeof(RegistroNodo));
+    if (!cadenas.empty()) {
+        std::memcpy(&bytes[cabecera.inicioCadenas], cadenas.data(), cadenas.size() * sizeof(EntradaCadena));
+    }
+    if (!texto.empty()) std::memcpy(&bytes[cabecera.inicioTexto], texto.data(), texto.size());
+    return bytes;
+}
+
+// Escribe el árbol en un archivo temporal y lo renombra al final, para que
+// quien lo tenga abierto (o lo abra en ese momento) nunca vea uno a medias
+inline bool guardarArbolBinario(const ArbolPlano& arbol, const std::string& ruta) {
+    std::string bytes = serializarArbol(arbol);
+    std::string temporal = ruta + ".tmp";
+    // Se renombra solo si todos los bytes llegaron al archivo: un error al
+    // vaciar el buffer o al cerrar deja el ast.bin anterior en su lugar
+    std::ofstream archivo(temporal, std::ios::binary | std::ios::trunc);
+    archivo.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    archivo.flush();
+    archivo.close();
+    if (!archivo) {
+        std::remove(temporal.c_str());
+        return false;
+    }
+    if (std::rename(temporal.c_str(), ruta.c_str()) != 0) {
+        std::remove(temporal.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Vista de solo lectura sobre un archivo de árbol ya en memoria (mapeado o
+// leído). Abrirlo solo revisa la cabecera y que las secciones entren en el
+// buffer, así que cuesta lo mismo para cualquier tamaño; verificar() revisa
+// además cada registro y cada cadena, para archivos de origen dudoso.
+class LectorArbol {
+public:
+    LectorArbol() = default;
+
+    // Devuelve un lector vacío (valido() == false) si el buffer no es un
+    // árbol de esta versión o está truncado
+    static LectorArbol desdeMemoria(const void* datos, size_t tam) {
+        LectorArbol lector;
+        const char* base = static_cast<const char*>(datos);
+        if (!base || tam < sizeof(CabeceraArbol) || reinterpret_cast<uintptr_t>(base) % 8 != 0) return lector;
+
+        const CabeceraArbol* cabecera = reinterpret_cast<const CabeceraArbol*>(base);
+        if (std::memcmp(cabecera->magia, MAGIA_ARBOL, sizeof(MAGIA_ARBOL)) != 0 ||
+            cabecera->version != VERSION_ARBOL || cabecera->tamRegistro != sizeof(RegistroNodo) ||
+            cabecera->orden != ORDEN_ARBOL || cabecera->tamArchivo != tam) {
+            return lector;
+        }
+        auto seccionValida = [tam](uint64_t inicio, uint64_t bytes, uint64_t alineacion) {
+            return inicio % alineacion == 0 && inicio <= tam && bytes <= tam - inicio;
+        };
+        if (!seccionValida(cabecera->inicioNodos, uint64_t(cabecera->cantidadNodos) * sizeof(RegistroNodo), 4) ||
+            !seccionValida(cabecera->inicioCadenas, uint64_t(cabecera->cantidadCadenas) * sizeof(EntradaCadena), 4) ||
+            !seccionValida(cabecera->inicioTexto, cabecera->bytesTexto, 1)) {
+            return lector;
+        }
+
+        lector.cabecera = cabecera;
+        lector.nodos = reinterpret_cast<const RegistroNodo*>(base + cabecera->inicioNodos);
+        lector.cadenas = reinterpret_cast<const EntradaCadena*>(base + cabecera->inicioCadenas);
+        lector.textos = base + cabecera->inicioTexto;
+        return lector;
+    }
+
+    bool valido() const { return cabecera != nullptr; }
+    // 0 si el lector no es válido
+    uint16_t version() const { return cabecera ? cabecera->version : 0; }
+
+    bool vacio() const { return size() == 0; }
+    size_t size() const { return cabecera ? cabecera->cantidadNodos : 0; }
+
+    // Requiere valido() && !vacio(): un lector inválido no tiene nodos y el
+    // archivo de un ArbolPlano vacío (desdeArbol(nullptr)) no tiene raíz
+    const RegistroNodo& raiz() const {
+        assert(valido() && !vacio());
+        return nodos[0];
+    }
+    const RegistroNodo& operator[](uint32_t indice) const { return nodos[indice]; }
+    uint32_t indice(const RegistroNodo& nodo) const { return static_cast<uint32_t>(&nodo - nodos); }
+
+    Lista<const RegistroNodo> hijos(const RegistroNodo& nodo) const { return {nodos + nodo.primero, nodo.cantidad}; }
+
+    TipoNodo tipo(const RegistroNodo& nodo) const { return static_cast<TipoNodo>(nodo.tipo); }
+
+    // Identificador de la declaración o variable, valor del literal, nombre
+    // de la llamada o archivo incluido; vacío para el resto de los nodos
+    std::string_view texto(const RegistroNodo& nodo) const {
+        if (!datoEsCadena(tipo(nodo))) return std::string_view();
+        return cadena(nodo.dato);
+    }
+
+    size_t cantidadCadenas() const { return cabecera ? cabecera->cantidadCadenas : 0; }
+    std::string_view cadena(uint32_t indice) const {
+        if (indice >= cantidadCadenas()) return std::string_view();
+        return std::string_view(textos + cadenas[indice].desplazamiento, cadenas[indice].longitud);
+    }
+
+    // Recorre el archivo entero: hijos dentro del arreglo y posteriores a su
+    // padre (no hay ciclos), cadenas dentro del texto y datos de texto que
+    // apuntan a la tabla
+    bool verificar() const {
+        if (!valido()) return false;
+        uint64_t totalNodos = cabecera->cantidadNodos;
+        for (uint32_t i = 0; i < totalNodos; ++i) {
+            const RegistroNodo& nodo = nodos[i];
+            if (nodo.cantidad > 0 && (nodo.primero <= i || uint64_t(nodo.primero) + nodo.cantidad > totalNodos)) {
+                return false;
+            }
+            if (datoEsCadena(tipo(nodo)) && nodo.dato >= cabecera->cantidadCadenas && nodo.dato != SIN_SIMBOLO) {
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < cabecera->cantidadCadenas; ++i) {
+            if (uint64_t(cadenas[i].desplazamiento) + cadenas[i].longitud > cabecera->bytesTexto) return false;
+        }
+        return true;
+    }
+
+private:
+    const CabeceraArbol* cabecera = nullptr;
+    const RegistroNodo* nodos = nullptr;
+    const EntradaCadena* cadenas = nullptr;
+    const char* textos = nullptr;
+};
+
+// Archivo de árbol abierto: el mapa (o la copia en memoria donde no hay
+// mmap) vive lo mismo que el lector que apunta a él
+class ArchivoArbol {
+public:
+    static ArchivoArbol abrir(const std::string& ruta) {
+        ArchivoArbol archivo;
+        archivo.fuente = CodigoFuente::desdeArchivo(ruta, std::ios::in | std::ios::binary);
+        archivo.leer();
+        return archivo;
+    }
+
+    ArchivoArbol() = default;
+    ArchivoArbol(ArchivoArbol&& otro) noexcept : fuente(std::move(otro.fuente)) {
+        leer();
+        otro.lector = LectorArbol();
+    }
+    ArchivoArbol& operator=(ArchivoArbol&& otro) noexcept {
+        fuente = std::move(otro.fuente);
+        leer();
+        otro.lector = LectorArbol();
+        return *this;
+    }
+
+    bool valido() const { return lector.valido(); }
+    const LectorArbol& arbol() const { return lector; }
+
+private:
+    CodigoFuente fuente;
+    LectorArbol lector;
+
+    void leer() {
+        lector = LectorArbol();
+        if (!fuente.estaAbierto()) return;
+        std::string_view bytes = fuente.texto();
+        lector = LectorArbol::desdeMemoria(bytes.data(), bytes.size());
+    }
+};
+
+#endif // ARBOL_BINARIO_H
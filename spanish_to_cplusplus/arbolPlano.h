@@ -0,0 +1,174 @@
+#ifndef ARBOL_PLANO_H
+#define ARBOL_PLANO_H
+
+#include "parser.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// AST plano: todos los nodos en un único std::vector<RegistroNodo> y los
+// hijos referidos por rangos de índices de 32 bits en lugar de punteros.
+//
+// Los registros van en orden por niveles (BFS), así los hijos de cada nodo
+// quedan contiguos: las declaraciones del programa, las instrucciones de
+// configurar y bucle_principal, los argumentos de una llamada, la
+// expresión de una declaración y los dos operandos de una operación
+// binaria son un rango [primero, primero + cantidad).
+// Recorrer el árbol es leer el vector de corrido, y como registros y
+// textos son datos planos, el árbol entero se copia, compara o escribe con
+// un memcpy por arreglo.
+
+struct RegistroNodo {
+    uint8_t tipo;          // TipoNodo
+    uint8_t tipoDato;      // TipoDato (declaración) o su código de tipoDato (literal, variable)
+    uint16_t reservado;
+    int32_t linea;
+    int32_t columna;
+    uint32_t primero;      // Índice del primer hijo
+    uint32_t cantidad;     // Cantidad de hijos
+    uint32_t dato;         // SimboloId internado (declaración, variable), TokenType del operador
+                           // (operación binaria) o desplazamiento en textos
+    uint32_t longitud;     // Largo del texto (literal, llamada, incluir)
+};
+
+static_assert(std::is_trivially_copyable<RegistroNodo>::value, "RegistroNodo debe copiarse con memcpy");
+
+class ArbolPlano {
+public:
+    // Aplana un AST. Las declaraciones nulas que deja el parser al
+    // recuperarse de un error no se copian.
+    static ArbolPlano desdeArbol(NodoPrograma* raiz);
+
+    bool vacio() const { return nodos.empty(); }
+    size_t size() const { return nodos.size(); }
+    const RegistroNodo& raiz() const { return nodos[0]; }
+    const RegistroNodo& operator[](uint32_t indice) const { return nodos[indice]; }
+
+    Lista<const RegistroNodo> hijos(const RegistroNodo& nodo) const {
+        return {nodos.data() + nodo.primero, nodo.cantidad};
+    }
+
+    // Valor del literal, nombre de la llamada o archivo incluido
+    std::string_view texto(const RegistroNodo& nodo) const {
+        return std::string_view(textos.data() + nodo.dato, nodo.longitud);
+    }
+
+    TipoNodo tipo(const RegistroNodo& nodo) const { return static_cast<TipoNodo>(nodo.tipo); }
+
+    const std::vector<RegistroNodo>& registros() const { return nodos; }
+    const std::vector<char>& bytesTexto() const { return textos; }
+    size_t bytesUsados() const { return nodos.size() * sizeof(RegistroNodo) + textos.size(); }
+
+    // FNV-1a de los registros y los textos
+    uint64_t huella() const {
+        uint64_t hash = 14695981039346656037ull;
+        auto mezclar = [&hash](const void* datos, size_t bytes) {
+            const unsigned char* p = static_cast<const unsigned char*>(datos);
+            for (size_t i = 0; i < bytes; ++i) hash = (hash ^ p[i]) * 1099511628211ull;
+        };
+        mezclar(nodos.data(), nodos.size() * sizeof(RegistroNodo));
+        mezclar(textos.data(), textos.size());
+        return hash;
+    }
+
+    bool operator==(const ArbolPlano& otro) const {
+        return textos == otro.textos && nodos.size() == otro.nodos.size() &&
+               std::memcmp(nodos.data(), otro.nodos.data(), nodos.size() * sizeof(RegistroNodo)) == 0;
+    }
+
+private:
+    friend class AplanadorAST;
+
+    std::vector<RegistroNodo> nodos;
+    std::vector<char> textos;
+};
+
+// Llena el registro de cada nodo al visitarlo y encola sus hijos juntos al
+// final, de modo que el índice de un registro es su posición en la cola
+class AplanadorAST : public VisitanteAST<AplanadorAST> {
+    friend class VisitanteAST<AplanadorAST>;
+
+public:
+    explicit AplanadorAST(ArbolPlano& arbol) : arbol(arbol) {}
+
+    void aplanar(NodoPrograma* raiz) {
+        encolar(raiz);
+        for (actual = 0; actual < cola.size(); ++actual) visitar(cola[actual]);
+    }
+
+private:
+    ArbolPlano& arbol;
+    std::vector<Nodo*> cola;
+    uint32_t actual = 0;
+
+    RegistroNodo& registro() { return arbol.nodos[actual]; }
+
+    void encolar(Nodo* nodo) {
+        RegistroNodo nuevo{};
+        nuevo.tipo = static_cast<uint8_t>(nodo->tipo);
+        nuevo.linea = nodo->linea;
+        nuevo.columna = nodo->columna;
+        arbol.nodos.push_back(nuevo);
+        cola.push_back(nodo);
+    }
+
+    template <typename T>
+    void encolarHijos(const Lista<T*>& hijos) {
+        uint32_t primero = static_cast<uint32_t>(cola.size());
+        for (T* hijo : hijos) {
+            if (hijo) encolar(hijo);
+        }
+        registro().primero = primero;
+        registro().cantidad = static_cast<uint32_t>(cola.size()) - primero;
+    }
+
+    void guardarTexto(std::string_view texto) {
+        registro().dato = static_cast<uint32_t>(arbol.textos.size());
+        registro().longitud = static_cast<uint32_t>(texto.size());
+        arbol.textos.insert(arbol.textos.end(), texto.begin(), texto.end());
+    }
+
+    void visitarPrograma(NodoPrograma* programa) { encolarHijos(programa->declaraciones); }
+    void visitarConfigurar(NodoConfigurar* config) { encolarHijos(config->instrucciones); }
+    void visitarBuclePrincipal(NodoBuclePrincipal* bucle) { encolarHijos(bucle->instrucciones); }
+    void visitarIncluir(NodoIncluir* incluir) { guardarTexto(incluir->archivo); }
+
+    void visitarDeclaracion(NodoDeclaracion* decl) {
+        registro().tipoDato = static_cast<uint8_t>(decl->tipoDeclarado);
+        registro().dato = decl->simbolo;
+        NodoExpresion* expresion[] = {decl->expresion};
+        encolarHijos(Lista<NodoExpresion*>{expresion, 1});
+    }
+
+    void visitarLlamadaFuncion(NodoLlamadaFuncion* llamada) {
+        guardarTexto(llamada->nombre);
+        encolarHijos(llamada->argumentos);
+    }
+
+    void visitarLiteral(NodoLiteral* literal) {
+        registro().tipoDato = static_cast<uint8_t>(literal->tipoDato[0]);
+        guardarTexto(literal->valor);
+    }
+
+    void visitarOperacionBinaria(NodoOperacionBinaria* operacion) {
+        registro().dato = static_cast<uint32_t>(operacion->operador);
+        NodoExpresion* operandos[] = {operacion->izquierda, operacion->derecha};
+        encolarHijos(Lista<NodoExpresion*>{operandos, 2});
+    }
+
+    void visitarVariable(NodoVariable* variable) {
+        registro().tipoDato = static_cast<uint8_t>(variable->tipoDato[0]);
+        registro().dato = variable->simbolo;
+    }
+};
+
+inline ArbolPlano ArbolPlano::desdeArbol(NodoPrograma* raiz) {
+    ArbolPlano arbol;
+    if (raiz) AplanadorAST(arbol).aplanar(raiz);
+    return arbol;
+}
+
+#endif // ARBOL_PLANO_H
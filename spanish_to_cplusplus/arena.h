@@ -0,0 +1,135 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Arena de asignación por avance (bump allocator) para el AST.
+//
+// Cada compilación reserva sus nodos, sus textos y sus listas de hijos en
+// bloques grandes y los libera todos juntos al destruir el arena, sin
+// recorrer el árbol. Los objetos creados aquí nunca se destruyen uno a
+// uno, así que no deben poseer memoria propia: sus textos y listas
+// también se copian al arena (copiarTexto, copiarLista).
+
+// Vista de una lista de elementos guardada en un arena
+template <typename T>
+struct Lista {
+    T* datos = nullptr;
+    uint32_t cantidad = 0;
+
+    T* begin() const { return datos; }
+    T* end() const { return datos + cantidad; }
+    size_t size() const { return cantidad; }
+    bool empty() const { return cantidad == 0; }
+    T& operator[](size_t i) const { return datos[i]; }
+};
+
+class Arena {
+public:
+    Arena() = default;
+
+    // Para arenas chicos (un elemento del parser incremental): el primer
+    // bloque es de primerBloque bytes y los siguientes crecen desde ahí
+    explicit Arena(size_t primerBloque) : siguienteBloque(std::max<size_t>(primerBloque, 64)) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // El arena movido queda vacío, como recién construido: sus punteros al
+    // bloque actual ya no le pertenecen
+    Arena(Arena&& otro) noexcept
+        : bloques(std::move(otro.bloques)), actual(std::exchange(otro.actual, nullptr)),
+          usado(std::exchange(otro.usado, 0)), capacidad(std::exchange(otro.capacidad, 0)),
+          siguienteBloque(std::exchange(otro.siguienteBloque, TAM_BLOQUE_INICIAL)),
+          reservados(std::exchange(otro.reservados, 0)) {
+        otro.bloques.clear();
+    }
+
+    Arena& operator=(Arena&& otro) noexcept {
+        if (this != &otro) {
+            bloques = std::move(otro.bloques);
+            otro.bloques.clear();
+            actual = std::exchange(otro.actual, nullptr);
+            usado = std::exchange(otro.usado, 0);
+            capacidad = std::exchange(otro.capacidad, 0);
+            siguienteBloque = std::exchange(otro.siguienteBloque, TAM_BLOQUE_INICIAL);
+            reservados = std::exchange(otro.reservados, 0);
+        }
+        return *this;
+    }
+
+    void* reservar(size_t bytes, size_t alineacion) {
+        size_t inicio = (usado + alineacion - 1) & ~(alineacion - 1);
+        if (inicio + bytes > capacidad) {
+            nuevoBloque(bytes + alineacion);
+            inicio = 0; // Los bloques vienen alineados para cualquier tipo básico
+        }
+        usado = inicio + bytes;
+        return actual + inicio;
+    }
+
+    template <typename T, typename... Argumentos>
+    T* crear(Argumentos&&... argumentos) {
+        return new (reservar(sizeof(T), alignof(T))) T(std::forward<Argumentos>(argumentos)...);
+    }
+
+    std::string_view copiarTexto(std::string_view texto) {
+        if (texto.empty()) return std::string_view();
+        char* destino = static_cast<char*>(reservar(texto.size(), 1));
+        std::memcpy(destino, texto.data(), texto.size());
+        return std::string_view(destino, texto.size());
+    }
+
+    // Copia los elementos [desde, fin) de una pila de trabajo del parser
+    template <typename T>
+    Lista<T> copiarLista(const std::vector<T>& elementos, size_t desde = 0) {
+        Lista<T> lista;
+        lista.cantidad = static_cast<uint32_t>(elementos.size() - desde);
+        if (lista.cantidad == 0) return lista;
+        lista.datos = static_cast<T*>(reservar(sizeof(T) * lista.cantidad, alignof(T)));
+        std::uninitialized_copy(elementos.begin() + desde, elementos.end(), lista.datos);
+        return lista;
+    }
+
+    // Se queda con los bloques de otro arena (lo creado allí vive ahora lo
+    // mismo que este); se sigue reservando en el bloque actual
+    void absorber(Arena&& otro) {
+        Arena tomado(std::move(otro));
+        for (auto& bloque : tomado.bloques) bloques.push_back(std::move(bloque));
+        reservados += tomado.reservados;
+    }
+
+    size_t bytesReservados() const { return reservados; }
+
+private:
+    static constexpr size_t TAM_BLOQUE_INICIAL = 64 * 1024;
+    static constexpr size_t TAM_BLOQUE_MAXIMO = 4 * 1024 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> bloques;
+    char* actual = nullptr;
+    size_t usado = 0;
+    size_t capacidad = 0;
+    size_t siguienteBloque = TAM_BLOQUE_INICIAL;
+    size_t reservados = 0;
+
+    // Los bloques crecen al doble hasta TAM_BLOQUE_MAXIMO
+    void nuevoBloque(size_t minimo) {
+        size_t tam = std::max(siguienteBloque, minimo);
+        siguienteBloque = std::min(siguienteBloque * 2, TAM_BLOQUE_MAXIMO);
+        bloques.emplace_back(new char[tam]);
+        actual = bloques.back().get();
+        usado = 0;
+        capacidad = tam;
+        reservados += tam;
+    }
+};
+
+#endif // ARENA_H
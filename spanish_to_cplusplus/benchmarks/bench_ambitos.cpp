@@ -0,0 +1,98 @@
+// Benchmark de los ámbitos anidados de TablaSimbolos: simula programas con
+// bloques anidados hasta distintas profundidades, cada uno con algunas
+// declaraciones (la mitad tapa un nombre de afuera) y búsquedas de
+// nombres visibles. Compara el registro para deshacer contra copiar la
+// tabla en cada ámbito nuevo, que es cuadrático en la profundidad.
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_ambitos.cpp -o bench_ambitos
+#include "../simbolos.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const size_t DECLARACIONES_POR_AMBITO = 4;
+const size_t BUSQUEDAS_POR_AMBITO = 16;
+const size_t OPERACIONES = 2000000; // Por prueba, repartidas en bloques anidados
+
+volatile size_t sumidero = 0;
+
+// Copia de la tabla por ámbito: abrir copia todo lo visible
+class TablaCopiada {
+public:
+    TablaCopiada() : pila(1) {}
+    void abrirAmbito() { pila.push_back(pila.back()); }
+    void cerrarAmbito() { pila.pop_back(); }
+    void insertar(const Simbolo& simbolo) { pila.back().insertar(simbolo); }
+    Simbolo* buscar(SimboloId id) { return pila.back().buscar(id); }
+
+private:
+    std::vector<TablaSimbolos> pila;
+};
+
+// Id del i-ésimo nombre declarado en un nivel: la mitad son propios del
+// nivel y la otra mitad se repite cada 64 niveles y tapa al de afuera
+SimboloId nombre(size_t nivel, size_t i) {
+    if (i % 2 == 0) return static_cast<SimboloId>(nivel * DECLARACIONES_POR_AMBITO + i);
+    return static_cast<SimboloId>(0x40000000u + (nivel % 64) * DECLARACIONES_POR_AMBITO + i);
+}
+
+// Anida profundidad bloques, los cierra todos y repite hasta cubrir las
+// operaciones. Cada nivel busca nombres suyos y de los ocho de afuera.
+template <typename Tabla>
+double recorrer(size_t profundidad, size_t& encontrados) {
+    size_t porBloque = DECLARACIONES_POR_AMBITO + BUSQUEDAS_POR_AMBITO + 2;
+    size_t repeticiones = std::max<size_t>(1, OPERACIONES / (profundidad * porBloque));
+    encontrados = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeticiones; ++r) {
+        Tabla tabla;
+        for (size_t nivel = 0; nivel < profundidad; ++nivel) {
+            tabla.abrirAmbito();
+            for (size_t i = 0; i < DECLARACIONES_POR_AMBITO; ++i) {
+                SimboloId id = nombre(nivel, i);
+                tabla.insertar({id, ENTERO, static_cast<int>(nivel), ""});
+            }
+            for (size_t i = 0; i < BUSQUEDAS_POR_AMBITO; ++i) {
+                SimboloId id = nombre(nivel - std::min(nivel, i % 8), i % DECLARACIONES_POR_AMBITO);
+                encontrados += tabla.buscar(id) != nullptr;
+            }
+        }
+        for (size_t nivel = 0; nivel < profundidad; ++nivel) tabla.cerrarAmbito();
+    }
+    auto fin = std::chrono::steady_clock::now();
+    sumidero = encontrados;
+    return std::chrono::duration<double, std::nano>(fin - inicio).count() / (repeticiones * profundidad * porBloque);
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::left << std::setw(14) << "Profundidad" << std::right << std::setw(18) << "Deshacer (ns/op)"
+              << std::setw(18) << "Copia (ns/op)" << "\n"
+              << std::fixed << std::setprecision(1);
+    for (size_t profundidad : {1, 10, 100, 1000, 10000, 100000}) {
+        size_t encontradosDeshacer = 0;
+        double deshacer = recorrer<TablaSimbolos>(profundidad, encontradosDeshacer);
+        std::cout << std::left << std::setw(14) << profundidad << std::right << std::setw(18) << deshacer;
+        if (profundidad <= 1000) {
+            size_t encontradosCopia = 0;
+            double copia = recorrer<TablaCopiada>(profundidad, encontradosCopia);
+            if (encontradosCopia != encontradosDeshacer) {
+                std::cerr << "\nLas tablas no coinciden con profundidad " << profundidad << "\n";
+                return 1;
+            }
+            std::cout << std::setw(18) << copia;
+        } else {
+            std::cout << std::setw(18) << "-";
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+// Benchmark del formato binario del AST (arbolBinario.h): escribe el árbol
+// de un programa con un bucle_principal de cientos de miles de llamadas
+// como ast.json y como ast.bin, y compara lo que tarda una herramienta en
+// cargar cada uno y en recorrerlo contando las llamadas y los bytes de sus
+// nombres. El JSON se analiza entero con nlohmann; el binario se abre con
+// mmap y se lee en el lugar. Verifica además que el binario tenga los
+// mismos nodos, hijos y textos que el ArbolPlano del que salió.
+//
+// Uso: bench_arbol_binario [llamadas, 400000 por defecto]
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_arbol_binario.cpp -o bench_arbol_binario
+#include "generador.h"
+#include "../arbolBinario.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* RUTA_JSON = "bench_ast.json";
+const char* RUTA_BINARIO = "bench_ast.bin";
+
+using generador::medir;
+
+struct Recuento {
+    size_t llamadas = 0;
+    size_t bytesNombres = 0;
+    bool operator==(const Recuento& otro) const {
+        return llamadas == otro.llamadas && bytesNombres == otro.bytesNombres;
+    }
+};
+
+Recuento recorrerJson(const nlohmann::json& nodo) {
+    Recuento recuento;
+    if (nodo.is_object()) {
+        auto tipo = nodo.find("tipo");
+        if (tipo != nodo.end() && *tipo == "LLAMADA_FUNCION") {
+            recuento.llamadas++;
+            recuento.bytesNombres += nodo["nombre"].get_ref<const std::string&>().size();
+        }
+    }
+    if (nodo.is_structured()) {
+        for (const nlohmann::json& hijo : nodo) {
+            Recuento parcial = recorrerJson(hijo);
+            recuento.llamadas += parcial.llamadas;
+            recuento.bytesNombres += parcial.bytesNombres;
+        }
+    }
+    return recuento;
+}
+
+// Recorre el árbol desde la raíz por sus rangos de hijos, como una
+// herramienta que no conoce el orden de los registros
+Recuento recorrerBinario(const LectorArbol& arbol, const RegistroNodo& nodo) {
+    Recuento recuento;
+    if (arbol.tipo(nodo) == NODO_LLAMADA_FUNCION) {
+        recuento.llamadas++;
+        recuento.bytesNombres += arbol.texto(nodo).size();
+    }
+    for (const RegistroNodo& hijo : arbol.hijos(nodo)) {
+        Recuento parcial = recorrerBinario(arbol, hijo);
+        recuento.llamadas += parcial.llamadas;
+        recuento.bytesNombres += parcial.bytesNombres;
+    }
+    return recuento;
+}
+
+bool mismoArbol(const ArbolPlano& plano, const LectorArbol& binario) {
+    if (!binario.verificar() || binario.size() != plano.size()) return false;
+    for (uint32_t i = 0; i < plano.size(); ++i) {
+        const RegistroNodo& a = plano[i];
+        const RegistroNodo& b = binario[i];
+        if (a.tipo != b.tipo || a.tipoDato != b.tipoDato || a.linea != b.linea || a.columna != b.columna ||
+            a.primero != b.primero || a.cantidad != b.cantidad) {
+            return false;
+        }
+        TipoNodo tipo = plano.tipo(a);
+        std::string_view esperado;
+        if (tipo == NODO_DECLARACION || tipo == NODO_VARIABLE) {
+            esperado = cadenasGlobales().texto(a.dato);
+        } else if (datoEsCadena(tipo)) {
+            esperado = plano.texto(a);
+        } else if (a.dato != b.dato) {
+            return false;
+        }
+        if (binario.texto(b) != esperado) return false;
+    }
+    return true;
+}
+
+size_t tamArchivo(const char* ruta) {
+    std::ifstream archivo(ruta, std::ios::binary | std::ios::ate);
+    return static_cast<size_t>(archivo.tellg());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t llamadas = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 400000;
+    std::string texto = generador::generarBucleLargo(llamadas);
+    std::vector<Error> errores;
+    std::vector<Token> tokens = analizadorLexico(texto, errores);
+    Parser parser(tokens, errores);
+    ArbolSintactico arbol = parser.analizar();
+    if (!errores.empty()) {
+        std::cerr << "El programa generado tiene " << errores.size() << " errores\n";
+        return 1;
+    }
+
+    ArbolPlano plano = ArbolPlano::desdeArbol(arbol.get());
+    {
+        std::ofstream json(RUTA_JSON);
+        json << parser.generarJsonAST(arbol) << std::endl;
+    }
+    if (!guardarArbolBinario(plano, RUTA_BINARIO)) {
+        std::cerr << "No se pudo escribir " << RUTA_BINARIO << "\n";
+        return 1;
+    }
+    std::cout << "Programa: " << llamadas << " llamadas, " << plano.size() << " nodos\n"
+              << "ast.json " << tamArchivo(RUTA_JSON) / 1024 << " KiB, ast.bin " << tamArchivo(RUTA_BINARIO) / 1024
+              << " KiB\n";
+
+    ArchivoArbol archivo = ArchivoArbol::abrir(RUTA_BINARIO);
+    if (!archivo.valido() || !mismoArbol(plano, archivo.arbol())) {
+        std::cerr << "ast.bin no coincide con el arbol escrito\n";
+        return 1;
+    }
+
+    Recuento desdeJson, desdeBinario;
+    nlohmann::json cargado;
+    double cargarJson = medir([&] {
+        std::ifstream entrada(RUTA_JSON);
+        cargado = nlohmann::json::parse(entrada);
+    });
+    double recorrerJsonT = medir([&] { desdeJson = recorrerJson(cargado); });
+
+    double cargarBinario = medir([&] { archivo = ArchivoArbol::abrir(RUTA_BINARIO); });
+    double recorrerBinarioT = medir([&] { desdeBinario = recorrerBinario(archivo.arbol(), archivo.arbol().raiz()); });
+
+    if (!(desdeJson == desdeBinario) || desdeBinario.llamadas != llamadas + 64) {
+        std::cerr << "Los recorridos no coinciden: " << desdeJson.llamadas << " llamadas en JSON, "
+                  << desdeBinario.llamadas << " en binario\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(3) << std::left << std::setw(12) << "" << std::right
+              << std::setw(14) << "Cargar (ms)" << std::setw(14) << "Recorrer (ms)" << "\n"
+              << std::left << std::setw(12) << "ast.json" << std::right << std::setw(14) << cargarJson * 1e3
+              << std::setw(14) << recorrerJsonT * 1e3 << "\n"
+              << std::left << std::setw(12) << "ast.bin" << std::right << std::setw(14) << cargarBinario * 1e3
+              << std::setw(14) << recorrerBinarioT * 1e3 << "\n";
+
+    std::remove(RUTA_JSON);
+    std::remove(RUTA_BINARIO);
+    return 0;
+}
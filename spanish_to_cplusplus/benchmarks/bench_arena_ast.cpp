@@ -0,0 +1,402 @@
+// Benchmark del AST en arena (arena.h) contra el AST anterior, con cada
+// nodo en su propio std::unique_ptr, hijos en std::vector<std::unique_ptr>
+// y textos en std::string. El parser anterior se conserva aquí, reducido a
+// la gramática y a la tabla de símbolos, como referencia. Mide
+// Parser::analizar y la destrucción del árbol por separado, y verifica que
+// ambos árboles tengan la misma forma y el mismo contenido.
+//
+// Uso: bench_arena_ast [megabytes de fuente, 32 por defecto]
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_arena_ast.cpp -o bench_arena_ast
+#include "generador.h"
+#include "../parser.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace referencia {
+
+struct Nodo {
+    virtual ~Nodo() = default;
+    TipoNodo tipo;
+    int linea;
+    int columna;
+};
+
+struct NodoExpresion : public Nodo {};
+
+struct NodoLiteral : public NodoExpresion {
+    std::string valor;
+    std::string tipoDato;
+};
+
+struct NodoVariable : public NodoExpresion {
+    SimboloId simbolo = SIN_SIMBOLO;
+    std::string tipoDato;
+};
+
+struct NodoLlamadaFuncion : public Nodo {
+    std::string nombre;
+    std::vector<std::unique_ptr<NodoExpresion>> argumentos;
+};
+
+struct NodoDeclaracion : public Nodo {
+    SimboloId simbolo = SIN_SIMBOLO;
+    std::unique_ptr<NodoExpresion> expresion;
+    TipoDato tipoDeclarado;
+};
+
+struct NodoPrograma : public Nodo {
+    std::vector<std::unique_ptr<Nodo>> declaraciones;
+};
+
+struct NodoIncluir : public Nodo {
+    std::string archivo;
+};
+
+struct NodoBloque : public Nodo {
+    std::vector<std::unique_ptr<Nodo>> instrucciones;
+};
+
+// Parser anterior sobre el mismo TokenStream, sin límite de errores
+class Parser {
+public:
+    Parser(std::vector<Token> tokens, std::vector<Error>& errores)
+        : flujo(std::move(tokens)), ast(new NodoPrograma), errores(errores) {
+        ast->tipo = NODO_PROGRAMA;
+    }
+
+    std::unique_ptr<NodoPrograma> analizar() {
+        coincidir(TOKEN_PROGRAMA);
+        coincidir(TOKEN_IDENTIFICADOR);
+        while (tipoActual() != TOKEN_FIN_PROGRAMA) {
+            switch (tipoActual()) {
+                case TOKEN_INCLUIR: ast->declaraciones.push_back(funcionIncluir()); break;
+                case TOKEN_ENTERO:
+                case TOKEN_FLOTANTE:
+                case TOKEN_CADENA:
+                case TOKEN_BOOLEANO: ast->declaraciones.push_back(declaracionVariable()); break;
+                case TOKEN_CONFIGURAR: ast->declaraciones.push_back(bloque(NODO_CONFIGURAR)); break;
+                case TOKEN_BUCLE_PRINCIPAL: ast->declaraciones.push_back(bloque(NODO_BUCLE_PRINCIPAL)); break;
+                default:
+                    error("Declaracion o instruccion invalida");
+                    recuperarError();
+            }
+        }
+        coincidir(TOKEN_FIN_PROGRAMA);
+        return std::move(ast);
+    }
+
+private:
+    TokenStream flujo;
+    size_t posActual = 0;
+    TablaSimbolos tablaSimbolos;
+    std::unique_ptr<NodoPrograma> ast;
+    std::vector<Error>& errores;
+
+    const Token& actual() {
+        static const Token tokenError = {TOKEN_DESCONOCIDO, SIN_SIMBOLO, "", 0, 0};
+        const Token* token = flujo.en(posActual);
+        if (!token) {
+            posActual++;
+            return tokenError;
+        }
+        return *token;
+    }
+
+    TokenType tipoActual() {
+        TokenType tipo;
+        return flujo.tipoEn(posActual, tipo) ? tipo : actual().type;
+    }
+
+    SimboloId simboloActual() {
+        const Token& token = actual();
+        return token.simbolo != SIN_SIMBOLO ? token.simbolo : cadenasGlobales().internar(token.value);
+    }
+
+    void avanzar() {
+        TokenType tipo;
+        if (flujo.tipoEn(posActual, tipo)) posActual++;
+    }
+
+    void error(const std::string& mensaje) { errores.push_back({mensaje, actual().line, actual().column, "Sintactico"}); }
+
+    void recuperarError() {
+        size_t posInicial = posActual;
+        TokenType tipo;
+        while (flujo.tipoEn(posActual, tipo) && tipo != TOKEN_PUNTO_COMA && tipo != TOKEN_LLAVE_DER &&
+               tipo != TOKEN_FIN_PROGRAMA) {
+            posActual++;
+        }
+        if (posInicial == posActual) posActual++;
+    }
+
+    void coincidir(TokenType esperado) {
+        if (tipoActual() != esperado) {
+            error("Token inesperado");
+            recuperarError();
+            return;
+        }
+        avanzar();
+    }
+
+    bool finalBloque() {
+        TokenType tipo = tipoActual();
+        return tipo == TOKEN_FIN_CONFIGURAR || tipo == TOKEN_FIN_BUCLE || tipo == TOKEN_FIN_PROGRAMA;
+    }
+
+    static TipoDato tokenToTipoDato(TokenType tipo) {
+        switch (tipo) {
+            case TOKEN_ENTERO: case TOKEN_NUMERO_LIT: return ENTERO;
+            case TOKEN_FLOTANTE: case TOKEN_DECIMAL_LIT: return DECIMAL;
+            case TOKEN_CADENA: case TOKEN_CADENA_LIT: return CADENA;
+            case TOKEN_BOOLEANO: case TOKEN_VERDADERO: case TOKEN_FALSO: return BOOLEANO;
+            default: return INDEFINIDO;
+        }
+    }
+
+    static bool esLiteral(TokenType tipo) {
+        return tipo == TOKEN_NUMERO_LIT || tipo == TOKEN_DECIMAL_LIT || tipo == TOKEN_CADENA_LIT ||
+               tipo == TOKEN_VERDADERO || tipo == TOKEN_FALSO;
+    }
+
+    std::unique_ptr<Nodo> declaracionVariable() {
+        auto nodo = std::make_unique<NodoDeclaracion>();
+        nodo->tipo = NODO_DECLARACION;
+        nodo->linea = actual().line;
+        nodo->columna = actual().column;
+        nodo->tipoDeclarado = tokenToTipoDato(tipoActual());
+        avanzar();
+        if (tipoActual() != TOKEN_IDENTIFICADOR) {
+            error("Se esperaba identificador despues de tipo de dato");
+            recuperarError();
+            return nullptr;
+        }
+        nodo->simbolo = simboloActual();
+        if (tablaSimbolos.buscar(nodo->simbolo)) error("Variable ya declarada");
+        avanzar();
+        if (tipoActual() == TOKEN_ASIGNACION) {
+            avanzar();
+            nodo->expresion = expresion();
+        }
+        coincidir(TOKEN_PUNTO_COMA);
+        tablaSimbolos.insertar(Simbolo{nodo->simbolo, nodo->tipoDeclarado, nodo->linea, ""});
+        return nodo;
+    }
+
+    std::unique_ptr<NodoExpresion> expresion() {
+        auto expr = std::make_unique<NodoExpresion>();
+        expr->linea = actual().line;
+        expr->columna = actual().column;
+        if (tipoActual() == TOKEN_IDENTIFICADOR) {
+            auto var = std::make_unique<NodoVariable>();
+            var->simbolo = simboloActual();
+            auto simbolo = tablaSimbolos.buscar(var->simbolo);
+            if (!simbolo) error("Variable no declarada");
+            var->tipoDato = simbolo ? simbolo->tipo : INDEFINIDO;
+            expr = std::move(var);
+            avanzar();
+        } else if (esLiteral(tipoActual())) {
+            auto lit = std::make_unique<NodoLiteral>();
+            lit->valor = actual().value;
+            lit->tipoDato = tokenToTipoDato(tipoActual());
+            expr = std::move(lit);
+            avanzar();
+        } else {
+            error("Expresion invalida");
+            recuperarError();
+            return nullptr;
+        }
+        return expr;
+    }
+
+    std::unique_ptr<Nodo> funcionIncluir() {
+        auto nodo = std::make_unique<NodoIncluir>();
+        nodo->tipo = NODO_INCLUIR;
+        nodo->linea = actual().line;
+        nodo->columna = actual().column;
+        avanzar();
+        coincidir(TOKEN_MENOR_QUE);
+        if (tipoActual() != TOKEN_CADENA_LIT) {
+            error("Se esperaba nombre de archivo entre comillas");
+            recuperarError();
+            return nullptr;
+        }
+        nodo->archivo = actual().value;
+        avanzar();
+        coincidir(TOKEN_MAYOR_QUE);
+        return nodo;
+    }
+
+    std::unique_ptr<Nodo> bloque(TipoNodo tipo) {
+        auto nodo = std::make_unique<NodoBloque>();
+        nodo->tipo = tipo;
+        nodo->linea = actual().line;
+        nodo->columna = actual().column;
+        avanzar();
+        while (!finalBloque()) {
+            TokenType actualTipo = tipoActual();
+            bool valida = tipo == NODO_CONFIGURAR ? actualTipo == TOKEN_CONFIGURAR_PIN
+                                                  : actualTipo == TOKEN_ESCRIBIR || actualTipo == TOKEN_ESPERAR;
+            if (valida) {
+                auto llamada = llamadaFuncion();
+                if (llamada) nodo->instrucciones.push_back(std::move(llamada));
+            } else {
+                error("Instruccion invalida");
+                recuperarError();
+            }
+        }
+        coincidir(tipo == NODO_CONFIGURAR ? TOKEN_FIN_CONFIGURAR : TOKEN_FIN_BUCLE);
+        return nodo;
+    }
+
+    std::unique_ptr<NodoLlamadaFuncion> llamadaFuncion() {
+        auto nodo = std::make_unique<NodoLlamadaFuncion>();
+        nodo->tipo = NODO_LLAMADA_FUNCION;
+        nodo->linea = actual().line;
+        nodo->columna = actual().column;
+        nodo->nombre = actual().value;
+        avanzar();
+        if (tipoActual() != TOKEN_PARENTESIS_IZQ) {
+            error("Se esperaba '(' despues de nombre de funcion");
+            recuperarError();
+            return nullptr;
+        }
+        avanzar();
+        while (tipoActual() != TOKEN_PARENTESIS_DER && !finalBloque()) {
+            auto expr = expresion();
+            if (expr) nodo->argumentos.push_back(std::move(expr));
+            if (tipoActual() == TOKEN_COMA) {
+                avanzar();
+            } else if (tipoActual() != TOKEN_PARENTESIS_DER) {
+                error("Se esperaba ',' o ')' en lista de argumentos");
+                recuperarError();
+            }
+        }
+        if (tipoActual() != TOKEN_PARENTESIS_DER) error("Llave no cerrada en llamada a funcion");
+        else avanzar();
+        if (tipoActual() != TOKEN_PUNTO_COMA) error("Se esperaba ';' despues de llamada a funcion");
+        else avanzar();
+        return nodo;
+    }
+};
+
+} // namespace referencia
+
+namespace {
+
+using generador::medir;
+
+// Resumen textual de ambos árboles para compararlos
+void resumirExpresion(std::ostream& salida, const NodoExpresion* expr) {
+    if (auto var = comoNodo<NodoVariable>(expr)) salida << " v" << var->simbolo;
+    else if (auto lit = comoNodo<NodoLiteral>(expr)) salida << " l" << lit->valor;
+}
+
+void resumirExpresion(std::ostream& salida, const referencia::NodoExpresion* expr) {
+    if (auto var = dynamic_cast<const referencia::NodoVariable*>(expr)) salida << " v" << var->simbolo;
+    else if (auto lit = dynamic_cast<const referencia::NodoLiteral*>(expr)) salida << " l" << lit->valor;
+}
+
+std::string resumir(const NodoPrograma& programa) {
+    std::ostringstream salida;
+    for (const Nodo* decl : programa.declaraciones) {
+        salida << decl->tipo << "@" << decl->linea << ":" << decl->columna;
+        if (auto nodo = comoNodo<NodoDeclaracion>(decl)) {
+            salida << " " << nodo->simbolo << " " << nodo->tipoDeclarado;
+            if (nodo->expresion) resumirExpresion(salida, nodo->expresion);
+        } else if (auto nodo = comoNodo<NodoIncluir>(decl)) {
+            salida << " " << nodo->archivo;
+        } else {
+            const Lista<Nodo*>& instrucciones = decl->tipo == NODO_CONFIGURAR
+                ? static_cast<const NodoConfigurar*>(decl)->instrucciones
+                : static_cast<const NodoBuclePrincipal*>(decl)->instrucciones;
+            for (const Nodo* instruccion : instrucciones) {
+                auto llamada = static_cast<const NodoLlamadaFuncion*>(instruccion);
+                salida << "\n  " << llamada->nombre << "@" << llamada->linea << ":" << llamada->columna;
+                for (const NodoExpresion* arg : llamada->argumentos) resumirExpresion(salida, arg);
+            }
+        }
+        salida << "\n";
+    }
+    return salida.str();
+}
+
+std::string resumir(const referencia::NodoPrograma& programa) {
+    std::ostringstream salida;
+    for (const auto& decl : programa.declaraciones) {
+        salida << decl->tipo << "@" << decl->linea << ":" << decl->columna;
+        if (auto nodo = dynamic_cast<const referencia::NodoDeclaracion*>(decl.get())) {
+            salida << " " << nodo->simbolo << " " << nodo->tipoDeclarado;
+            if (nodo->expresion) resumirExpresion(salida, nodo->expresion.get());
+        } else if (auto nodo = dynamic_cast<const referencia::NodoIncluir*>(decl.get())) {
+            salida << " " << nodo->archivo;
+        } else {
+            for (const auto& instruccion : static_cast<const referencia::NodoBloque*>(decl.get())->instrucciones) {
+                auto llamada = static_cast<const referencia::NodoLlamadaFuncion*>(instruccion.get());
+                salida << "\n  " << llamada->nombre << "@" << llamada->linea << ":" << llamada->columna;
+                for (const auto& arg : llamada->argumentos) resumirExpresion(salida, arg.get());
+            }
+        }
+        salida << "\n";
+    }
+    return salida.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t megas = argc > 1 ? std::max(1ul, std::strtoul(argv[1], nullptr, 10)) : 32;
+    const std::string fuente = generador::generarPrograma(megas << 20, false);
+    std::vector<Error> erroresLexicos;
+    const std::vector<Token> tokens = analizadorLexico(fuente, erroresLexicos);
+
+    // Cada árbol se arma dos veces: la primera calienta el asignador
+    double tArena = 0, tArenaLiberar = 0, tReferencia = 0, tReferenciaLiberar = 0;
+    std::string resumenArena, resumenReferencia;
+    size_t bytesArena = 0;
+    for (int intento = 0; intento < 2; ++intento) {
+        std::vector<Error> errores;
+        ArbolSintactico ast;
+        {
+            // Armar y destruir el parser (y su copia de los tokens) queda fuera
+            Parser parser(tokens, errores);
+            tArena = medir([&] { ast = parser.analizar(); }, 1);
+        }
+        if (intento == 1) {
+            resumenArena = resumir(*ast.get());
+            bytesArena = ast.bytesReservados();
+        }
+        tArenaLiberar = medir([&] { ast = ArbolSintactico(); }, 1);
+
+        std::unique_ptr<referencia::NodoPrograma> arbol;
+        {
+            referencia::Parser parser(tokens, errores);
+            tReferencia = medir([&] { arbol = parser.analizar(); }, 1);
+        }
+        if (intento == 1) resumenReferencia = resumir(*arbol);
+        tReferenciaLiberar = medir([&] { arbol.reset(); }, 1);
+    }
+
+    if (resumenArena != resumenReferencia) {
+        std::cerr << "Los arboles son distintos\n";
+        return 1;
+    }
+
+    const double fuenteMb = fuente.size() / (1024.0 * 1024.0);
+    std::cout << std::fixed << std::setprecision(1) << "Fuente: " << fuenteMb << " MB, " << tokens.size()
+              << " tokens; arena " << bytesArena / (1024.0 * 1024.0) << " MB\n"
+              << std::setprecision(3)
+              << "                       analizar (MB/s)   liberar (s)\n"
+              << "unique_ptr por nodo    " << std::setw(15) << fuenteMb / tReferencia << std::setw(14)
+              << tReferenciaLiberar << "\n"
+              << "Arena                  " << std::setw(15) << fuenteMb / tArena << std::setw(14)
+              << tArenaLiberar << "\n";
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Benchmark del AST plano (arbolPlano.h) contra el AST de punteros en
+// arena: recorrer el árbol completo (visitante contra lectura lineal de
+// los registros), aplanarlo y copiarlo. Se verifica que ambos recorridos
+// vean los mismos nodos y textos.
+//
+// Uso: bench_ast_plano [megabytes de fuente, 32 por defecto]
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_ast_plano.cpp -o bench_ast_plano
+#include "generador.h"
+#include "../arbolPlano.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using generador::medir;
+
+struct Resumen {
+    uint64_t nodos = 0;
+    uint64_t lineas = 0;
+    uint64_t bytesTexto = 0;
+
+    bool operator==(const Resumen& otro) const {
+        return nodos == otro.nodos && lineas == otro.lineas && bytesTexto == otro.bytesTexto;
+    }
+};
+
+// Recorrido del árbol de punteros
+class Recorrido : public VisitanteAST<Recorrido> {
+    friend class VisitanteAST<Recorrido>;
+
+public:
+    Resumen resumen;
+
+private:
+    void contar(Nodo* nodo, size_t texto = 0) {
+        ++resumen.nodos;
+        resumen.lineas += nodo->linea;
+        resumen.bytesTexto += texto;
+    }
+
+    template <typename T>
+    void hijos(const Lista<T*>& lista) {
+        for (T* hijo : lista) {
+            if (hijo) visitar(hijo);
+        }
+    }
+
+    void visitarPrograma(NodoPrograma* n) { contar(n); hijos(n->declaraciones); }
+    void visitarConfigurar(NodoConfigurar* n) { contar(n); hijos(n->instrucciones); }
+    void visitarBuclePrincipal(NodoBuclePrincipal* n) { contar(n); hijos(n->instrucciones); }
+    void visitarIncluir(NodoIncluir* n) { contar(n, n->archivo.size()); }
+    void visitarLlamadaFuncion(NodoLlamadaFuncion* n) { contar(n, n->nombre.size()); hijos(n->argumentos); }
+    void visitarLiteral(NodoLiteral* n) { contar(n, n->valor.size()); }
+
+    void visitarOperacionBinaria(NodoOperacionBinaria* n) {
+        contar(n);
+        visitar(n->izquierda);
+        visitar(n->derecha);
+    }
+    void visitarOtro(Nodo* n) { contar(n); }
+
+    void visitarDeclaracion(NodoDeclaracion* n) {
+        contar(n);
+        if (n->expresion) visitar(n->expresion);
+    }
+};
+
+Resumen recorrerPlano(const ArbolPlano& arbol) {
+    Resumen resumen;
+    for (const RegistroNodo& nodo : arbol.registros()) {
+        ++resumen.nodos;
+        resumen.lineas += nodo.linea;
+        resumen.bytesTexto += nodo.longitud;
+    }
+    return resumen;
+}
+
+volatile uint64_t sumidero = 0;
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t megas = argc > 1 ? std::max(1ul, std::strtoul(argv[1], nullptr, 10)) : 32;
+    const std::string fuente = generador::generarPrograma(megas << 20, false);
+    std::vector<Error> errores;
+    Parser parser(analizadorLexico(fuente, errores), errores);
+    ArbolSintactico ast = parser.analizar();
+
+    ArbolPlano plano;
+    double tAplanar = medir([&] { plano = ArbolPlano::desdeArbol(ast.get()); });
+
+    Resumen resumenArbol, resumenPlano;
+    double tArbol = medir([&] {
+        Recorrido recorrido;
+        recorrido.visitar(ast.get());
+        resumenArbol = recorrido.resumen;
+    });
+    double tPlano = medir([&] { resumenPlano = recorrerPlano(plano); });
+    if (!(resumenArbol == resumenPlano)) {
+        std::cerr << "Los recorridos no coinciden\n";
+        return 1;
+    }
+
+    double tCopia = medir([&] {
+        ArbolPlano copia = plano;
+        sumidero = sumidero + copia.size();
+    });
+    double tHuella = medir([&] { sumidero = sumidero + plano.huella(); });
+
+    const double nodos = static_cast<double>(plano.size());
+    std::cout << std::fixed << std::setprecision(2) << "Nodos: " << plano.size() << ", AST plano "
+              << plano.bytesUsados() / (1024.0 * 1024.0) << " MB, arena " << ast.bytesReservados() / (1024.0 * 1024.0)
+              << " MB\n"
+              << "Recorrer  punteros (visitante) " << std::setw(8) << tArbol * 1e9 / nodos << " ns/nodo\n"
+              << "Recorrer  registros (lineal)   " << std::setw(8) << tPlano * 1e9 / nodos << " ns/nodo\n"
+              << "Aplanar                        " << std::setw(8) << tAplanar * 1e9 / nodos << " ns/nodo\n"
+              << "Copiar AST plano               " << std::setw(8) << tCopia * 1e9 / nodos << " ns/nodo\n"
+              << "Huella FNV-1a                  " << std::setw(8) << tHuella * 1e9 / nodos << " ns/nodo\n";
+    return 0;
+}
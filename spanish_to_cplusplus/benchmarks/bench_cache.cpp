@@ -0,0 +1,97 @@
+// Benchmark de la caché de compilaciones (cacheCompilacion.h): para un
+// programa con un bucle_principal de cientos de miles de llamadas compara
+// producir tokens.json y ast.json desde cero (lexer, parser y escritores
+// JSON) contra un acierto de la caché, que calcula la clave del fuente y
+// enlaza los archivos de la entrada en out/. Verifica que los archivos
+// restaurados sean iguales a los generados.
+//
+// Uso: bench_cache [llamadas, 200000 por defecto]
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_cache.cpp -o bench_cache
+#include "generador.h"
+#include "../cacheCompilacion.h"
+#include "../jsonParser.h"
+#include "../parser.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* DIRECTORIO_CACHE = "bench_cache_dir";
+const char* DIRECTORIO_SALIDA = "bench_cache_out";
+
+using generador::medir;
+
+// Lo que hace main.cpp sin caché, sin la consola ni el análisis semántico
+void compilar(const std::string& texto, const std::filesystem::path& salida) {
+    std::vector<Error> errores;
+    std::vector<Token> tokens = analizadorLexico(texto, errores);
+    EscritorJsonTokens jsonTokens((salida / "tokens.json").string());
+    for (const Token& token : tokens) jsonTokens.agregar(token);
+    jsonTokens.cerrar();
+    Parser parser(tokens, errores);
+    ArbolSintactico arbol = parser.analizar();
+    std::ofstream jsonAst(salida / "ast.json");
+    jsonAst << parser.generarJsonAST(arbol) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    namespace fs = std::filesystem;
+    size_t llamadas = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::string texto = generador::generarBucleLargo(llamadas);
+    std::error_code ec;
+    fs::remove_all(DIRECTORIO_CACHE, ec);
+    fs::remove_all(DIRECTORIO_SALIDA, ec);
+    fs::create_directories(DIRECTORIO_SALIDA);
+
+    CacheCompilacion cache(DIRECTORIO_CACHE, uint64_t(1) << 30);
+    ClaveCache clave = CacheCompilacion::calcularClave(texto, "hilos=1;max-errors=1000");
+
+    double desdeCero = medir([&] {
+        CacheCompilacion::prepararSalidas(DIRECTORIO_SALIDA);
+        compilar(texto, DIRECTORIO_SALIDA);
+    });
+    std::string tokensJson, astJson;
+    detalle_cache::leerArchivo(fs::path(DIRECTORIO_SALIDA) / "tokens.json", tokensJson);
+    detalle_cache::leerArchivo(fs::path(DIRECTORIO_SALIDA) / "ast.json", astJson);
+    if (!cache.guardar(clave, DIRECTORIO_SALIDA, "", "")) {
+        std::cerr << "No se pudo guardar la entrada\n";
+        return 1;
+    }
+
+    double soloClave = medir([&] { clave = CacheCompilacion::calcularClave(texto, "hilos=1;max-errors=1000"); });
+    bool restaurada = true;
+    double acierto = medir([&] {
+        std::string consola, errores;
+        ClaveCache buscada = CacheCompilacion::calcularClave(texto, "hilos=1;max-errors=1000");
+        restaurada = restaurada && cache.restaurar(buscada, DIRECTORIO_SALIDA, consola, errores);
+    });
+
+    std::string tokensRestaurados, astRestaurado;
+    detalle_cache::leerArchivo(fs::path(DIRECTORIO_SALIDA) / "tokens.json", tokensRestaurados);
+    detalle_cache::leerArchivo(fs::path(DIRECTORIO_SALIDA) / "ast.json", astRestaurado);
+    fs::remove_all(DIRECTORIO_CACHE, ec);
+    fs::remove_all(DIRECTORIO_SALIDA, ec);
+    if (!restaurada || tokensRestaurados != tokensJson || astRestaurado != astJson) {
+        std::cerr << "La entrada restaurada no coincide con la compilacion\n";
+        return 1;
+    }
+
+    std::cout << "Programa: " << llamadas << " llamadas, " << texto.size() / 1024 << " KiB de fuente, "
+              << (tokensJson.size() + astJson.size()) / 1024 << " KiB de JSON\n"
+              << std::fixed << std::setprecision(2) << "desde cero      " << std::setw(10) << desdeCero * 1e3
+              << " ms\n"
+              << "clave del fuente" << std::setw(10) << soloClave * 1e3 << " ms  ("
+              << texto.size() / soloClave / 1e9 << " GB/s)\n"
+              << "acierto         " << std::setw(10) << acierto * 1e3 << " ms  (x" << std::setprecision(0)
+              << desdeCero / acierto << ")\n";
+    return 0;
+}
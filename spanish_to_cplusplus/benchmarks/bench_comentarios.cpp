@@ -0,0 +1,74 @@
+// Benchmark del lexer sobre un programa con mucha indentación y con
+// banners de comentarios de línea y de bloque. Mide analizadorLexico con
+// cada implementación de escaneo.h (escalar, SSE2 y AVX2).
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_comentarios.cpp -o bench_comentarios
+#include "generador.h"
+#include "../lexer.h"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using generador::medir;
+
+std::string generarCorpus(size_t bytesObjetivo) {
+    std::string banner(78, '=');
+    std::string fuente = "programa Comentarios\n";
+    int bloque = 0;
+    while (fuente.size() < bytesObjetivo) {
+        fuente += "    /*" + banner + "\n";
+        fuente += "     * Bloque " + std::to_string(bloque) + ": secuencia de pines generada\n";
+        fuente += "     *                                                      \n";
+        fuente += "     " + banner + "*/\n";
+        fuente += "    // " + banner + "\n";
+        fuente += "            entero pin" + std::to_string(bloque) + " = " + std::to_string(bloque % 14) + ";\n";
+        fuente += "\n\n                                    // fin del bloque\n";
+        bloque++;
+    }
+    fuente += "fin_programa\n";
+    return fuente;
+}
+
+const char* nombreNivel(escaneo::Nivel nivel) {
+    switch (nivel) {
+        case escaneo::Nivel::AVX2: return "AVX2";
+        case escaneo::Nivel::SSE2: return "SSE2";
+        default: return "escalar";
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::string fuente = generarCorpus(64u << 20);
+    const double megas = fuente.size() / (1024.0 * 1024.0);
+    std::cout << "Corpus: " << std::fixed << std::setprecision(1) << megas << " MB\n";
+
+    size_t tokensReferencia = 0;
+    for (escaneo::Nivel nivel : {escaneo::Nivel::ESCALAR, escaneo::Nivel::SSE2, escaneo::Nivel::AVX2}) {
+        escaneo::forzarNivel(nivel);
+        std::vector<Error> errores;
+        std::vector<Token> tokens;
+        // Los tokens de la corrida anterior se liberan fuera de la medición
+        double mejor = medir(3, [&] {
+            tokens = std::vector<Token>();
+            errores.clear();
+        }, [&] { tokens = analizadorLexico(fuente, errores); });
+        size_t cantidad = tokens.size();
+        if (tokensReferencia == 0) tokensReferencia = cantidad;
+        if (cantidad != tokensReferencia) {
+            std::cerr << "Cantidad de tokens distinta con " << nombreNivel(nivel) << "\n";
+            return 1;
+        }
+        std::cout << std::left << std::setw(9) << nombreNivel(nivel)
+                  << std::right << std::setw(10) << std::setprecision(1) << megas / mejor << " MB/s  "
+                  << std::setw(8) << std::setprecision(3) << mejor << " s\n";
+    }
+    escaneo::forzarNivel(escaneo::detectarNivel());
+    return 0;
+}
@@ -0,0 +1,314 @@
+// Benchmark del lexer guiado por tablas (clases de caracter y autómata de
+// operadores en lexer.h) contra la versión anterior, una cadena de
+// std::isspace/isdigit/isalpha y peek() para los operadores de dos
+// caracteres. La versión anterior se conserva aquí tal cual, como
+// referencia; se verifica que ambas den los mismos tokens y errores.
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_lexer_dfa.cpp -o bench_lexer_dfa
+#include "generador.h"
+#include "../lexer.h"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using generador::medir;
+using generador::mismosErrores;
+using generador::mismosTokens;
+
+// Lexer anterior (sin el modo especulativo del lexer paralelo)
+class LexerReferencia {
+public:
+    LexerReferencia(std::string_view fuente, std::vector<Error>& errores)
+        : fuente(fuente), datos(fuente.data()), n(fuente.size()), errores(errores),
+          busqueda(escaneo::operacionesActivas()) {}
+
+    std::vector<Token> analizar() {
+        std::vector<Token> tokens;
+        for (Token token = siguiente(); token.type != TOKEN_EOF; token = siguiente()) tokens.push_back(token);
+        return tokens;
+    }
+
+private:
+    std::string_view fuente;
+    const char* datos;
+    size_t n;
+    size_t pos = 0;
+    char c = 0;
+    int linea = 1;
+    int columna = 1;
+    bool bufferVacio = true;
+    TokenType ultimoTipo = TOKEN_DESCONOCIDO;
+    bool hayTokens = false;
+    std::vector<Error>& errores;
+    const escaneo::Operaciones& busqueda;
+
+    int siguienteCaracter() const {
+        return pos < n ? static_cast<unsigned char>(datos[pos]) : std::char_traits<char>::eof();
+    }
+
+    void avanzarPosicion(size_t desde, size_t hasta) {
+        size_t ultimoSalto = 0;
+        size_t saltos = busqueda.contarSaltos(datos, desde, hasta, ultimoSalto);
+        if (saltos > 0) {
+            linea += static_cast<int>(saltos);
+            columna = 1 + static_cast<int>(hasta - ultimoSalto - 1);
+        } else {
+            columna += static_cast<int>(hasta - desde);
+        }
+    }
+
+    void saltarComentarioBloque() {
+        size_t cierre = busqueda.buscarCierreComentario(datos, n, pos);
+        if (cierre < n) {
+            avanzarPosicion(pos, cierre + 1);
+            pos = cierre + 2;
+            return;
+        }
+        avanzarPosicion(pos, n);
+        pos = n;
+        errores.push_back({"Comentario sin terminar en linea", linea, columna, "Lexico"});
+    }
+
+    Token emitir(TokenType tipo, std::string_view valor, int lin, int col, SimboloId simbolo = SIN_SIMBOLO) {
+        ultimoTipo = tipo;
+        hayTokens = true;
+        return Token{tipo, simbolo, valor, lin, col};
+    }
+
+    Token siguiente() {
+        while (pos < n) {
+            c = datos[pos++];
+
+            if (std::isspace(c)) {
+                if (pos < n && std::isspace(datos[pos])) {
+                    size_t fin = busqueda.finEspacios(datos, n, pos);
+                    avanzarPosicion(pos - 1, fin);
+                    pos = fin;
+                    continue;
+                }
+                if (c == '\n') {
+                    linea++;
+                    columna = 1;
+                } else {
+                    columna++;
+                }
+                continue;
+            }
+
+            if (c == '/') {
+                char nextChar = static_cast<char>(siguienteCaracter());
+                if (nextChar == '/') {
+                    pos++;
+                    size_t salto = busqueda.buscarSalto(datos, n, pos);
+                    if (salto < n) {
+                        pos = salto + 1;
+                        linea++;
+                        columna = 1;
+                    } else {
+                        pos = n;
+                    }
+                    continue;
+                } else if (nextChar == '*') {
+                    pos++;
+                    saltarComentarioBloque();
+                    continue;
+                }
+            }
+
+            if (c == '"') {
+                int inicio_linea = linea;
+                int inicio_columna = columna;
+                bool salto = false;
+                size_t inicio = pos;
+                size_t fin = pos;
+                columna++;
+
+                while (pos < n) {
+                    c = datos[pos++];
+                    if (c == '"') break;
+                    if (c == '\n') {
+                        salto = true;
+                        break;
+                    }
+                    fin = pos;
+                    columna++;
+                }
+                std::string_view buffer = fuente.substr(inicio, fin - inicio);
+                bufferVacio = buffer.empty();
+                if (c != '"') {
+                    errores.push_back({"Cadena sin comillas de cierre", inicio_linea, inicio_columna, "Lexico"});
+                    linea++;
+                } else if (salto) {
+                    errores.push_back({"Salto de linea no valido", inicio_linea, inicio_columna, "Lexico"});
+                } else {
+                    Token token = emitir(TOKEN_CADENA_LIT, buffer, linea, inicio_columna);
+                    columna++;
+                    return token;
+                }
+                continue;
+            }
+
+            if (std::isdigit(c)) {
+                size_t inicio = pos - 1;
+                bool punto = false;
+                columna++;
+
+                while (pos < n && (std::isdigit(datos[pos]) || datos[pos] == '.')) {
+                    if (datos[pos] == '.') {
+                        if (punto) {
+                            errores.push_back({MENSAJE_PUNTOS_MULTIPLES, linea, columna, "Lexico"});
+                            break;
+                        }
+                        punto = true;
+                    }
+                    pos++;
+                    columna++;
+                }
+                std::string_view buffer = fuente.substr(inicio, pos - inicio);
+                bufferVacio = buffer.empty();
+                return emitir(punto ? TOKEN_DECIMAL_LIT : TOKEN_NUMERO_LIT, buffer,
+                              linea, columna - static_cast<int>(buffer.length()));
+            }
+
+            if (std::isalpha(c) || c == '_') {
+                size_t inicio = pos - 1;
+                columna++;
+
+                while (pos < n && (std::isalnum(datos[pos]) || datos[pos] == '_')) {
+                    pos++;
+                    columna++;
+                }
+                std::string_view buffer = fuente.substr(inicio, pos - inicio);
+                bufferVacio = buffer.empty();
+
+                if (buffer.length() > 32) {
+                    errores.push_back({"Identificador excede longitud maxima (32 caracteres)", linea,
+                                       columna - static_cast<int>(buffer.length()), "Lexico"});
+                    continue;
+                }
+                TokenType tipo = identificarPalabraReservada(buffer);
+                SimboloId simbolo = tipo == TOKEN_IDENTIFICADOR ? cadenasGlobales().internar(buffer) : SIN_SIMBOLO;
+                return emitir(tipo, buffer, linea, columna - static_cast<int>(buffer.length()), simbolo);
+            }
+
+            TokenType tipo;
+            size_t longitud = 1;
+            switch (c) {
+                case '(': tipo = TOKEN_PARENTESIS_IZQ; break;
+                case ')': tipo = TOKEN_PARENTESIS_DER; break;
+                case '{': tipo = TOKEN_LLAVE_IZQ; break;
+                case '}': tipo = TOKEN_LLAVE_DER; break;
+                case ';': tipo = TOKEN_PUNTO_COMA; break;
+                case ',': tipo = TOKEN_COMA; break;
+                case '+': tipo = TOKEN_MAS; break;
+                case '-': tipo = TOKEN_MENOS; break;
+                case '*': tipo = TOKEN_MULT; break;
+                case '=':
+                    if (siguienteCaracter() == '=') {
+                        pos++;
+                        tipo = TOKEN_IGUALDAD;
+                        longitud = 2;
+                    } else {
+                        tipo = TOKEN_ASIGNACION;
+                    }
+                    break;
+                case '!':
+                    if (siguienteCaracter() == '=') {
+                        pos++;
+                        tipo = TOKEN_DESIGUALDAD;
+                        longitud = 2;
+                        break;
+                    }
+                    errores.push_back({"Operador '!' no valido (quizas quiso usar '!='?)", linea, columna, "Lexico"});
+                    columna++;
+                    continue;
+                case '>':
+                    if (siguienteCaracter() == '=') {
+                        pos++;
+                        tipo = TOKEN_MAYOR_IGUAL;
+                        longitud = 2;
+                    } else {
+                        tipo = TOKEN_MAYOR_QUE;
+                    }
+                    break;
+                case '<':
+                    if (siguienteCaracter() == '=') {
+                        pos++;
+                        tipo = TOKEN_MENOR_IGUAL;
+                        longitud = 2;
+                    } else {
+                        tipo = TOKEN_MENOR_QUE;
+                    }
+                    break;
+                case '/':
+                    if (bufferVacio && hayTokens && ultimoTipo == TOKEN_ASIGNACION) {
+                        errores.push_back({"Operador '/' invalido en asignacion", linea, columna, "Lexico"});
+                        columna++;
+                        continue;
+                    }
+                    tipo = TOKEN_DIV;
+                    break;
+                default:
+                    errores.push_back({"Caracter no reconocido: '" + std::string(1, c) + "'", linea, columna, "Lexico"});
+                    columna++;
+                    continue;
+            }
+            Token token = emitir(tipo, fuente.substr(pos - longitud, longitud), linea, columna);
+            columna += static_cast<int>(longitud);
+            return token;
+        }
+        return Token{TOKEN_EOF, SIN_SIMBOLO, fuente.substr(n, 0), linea, columna};
+    }
+};
+
+// Programa con mucha densidad de operadores, comparaciones y literales
+std::string generarPrograma(int pasos) {
+    std::string fuente = "programa automata\nentero pin1 = 2;\ndecimal umbral = 0.75;\n"
+                         "configurar\nconfigurar_pin(pin1, \"SALIDA\");\nfin_configurar\nbucle_principal\n";
+    for (int i = 0; i < pasos; ++i) {
+        std::string k = std::to_string(i % 997);
+        fuente += "    si (pin1 >= " + k + " && umbral <= 1.5) { escribir(pin1, \"ALTO\"); }\n";
+        fuente += "    si (pin1 != " + k + ") { pin1 = pin1 + 1 * (2 - 3) / 4; } // c\n";
+        fuente += "    mientras (pin1 == 0) { esperar(" + k + "); } /* bloque */ @\n";
+    }
+    fuente += "fin_bucle\nfin_programa\n";
+    return fuente;
+}
+
+} // namespace
+
+int main() {
+    const std::string fuente = generarPrograma(200000);
+    const double megas = fuente.size() / (1024.0 * 1024.0);
+
+    std::vector<Token> tokensTabla, tokensReferencia;
+    std::vector<Error> erroresTabla, erroresReferencia;
+    double tTabla = medir([&] {
+        erroresTabla.clear();
+        AnalizadorLexico lexer(fuente, erroresTabla);
+        tokensTabla.clear();
+        for (Token token = lexer.siguiente(); token.type != TOKEN_EOF; token = lexer.siguiente()) {
+            tokensTabla.push_back(token);
+        }
+    });
+    double tReferencia = medir([&] {
+        erroresReferencia.clear();
+        tokensReferencia = LexerReferencia(fuente, erroresReferencia).analizar();
+    });
+
+    if (!mismosTokens(tokensTabla, tokensReferencia) || !mismosErrores(erroresTabla, erroresReferencia)) {
+        std::cerr << "Los lexers dieron resultados distintos\n";
+        return 1;
+    }
+
+    std::cout << "Fuente: " << std::fixed << std::setprecision(1) << megas << " MB, "
+              << tokensTabla.size() << " tokens, " << erroresTabla.size() << " errores\n"
+              << "Cadena de if (isspace/isdigit/peek) " << std::setw(8) << megas / tReferencia << " MB/s\n"
+              << "Tablas y autómata                   " << std::setw(8) << megas / tTabla << " MB/s\n";
+    return 0;
+}
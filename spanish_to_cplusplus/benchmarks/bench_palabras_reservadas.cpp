@@ -0,0 +1,68 @@
+// Microbenchmark del clasificador de palabras reservadas.
+// Compara la cadena de comparaciones original contra el hash perfecto de
+// identificarPalabraReservada, midiendo cada palabra por su posición en la
+// tabla y algunos identificadores comunes.
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_palabras_reservadas.cpp -o bench_palabras
+#include "../lexer.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Versión anterior: una comparación de std::string por palabra reservada
+TokenType identificarLineal(const std::string& valor) {
+#define X(tipo, palabra) if (sizeof(palabra) > 1 && valor == palabra) return tipo;
+    STC_TOKENS(X)
+#undef X
+    return TOKEN_IDENTIFICADOR;
+}
+
+volatile int sumidero = 0;
+
+template <typename F>
+double nsPorLlamada(const std::string& palabra, F&& clasificar) {
+    const int repeticiones = 2000000;
+    auto inicio = std::chrono::steady_clock::now();
+    // Leer la entrada a través de un puntero volátil evita que el
+    // compilador saque la llamada del bucle
+    const std::string* volatile entrada = &palabra;
+    int acumulado = 0;
+    for (int i = 0; i < repeticiones; ++i) {
+        acumulado += clasificar(*entrada);
+    }
+    auto fin = std::chrono::steady_clock::now();
+    sumidero = acumulado;
+    return std::chrono::duration<double, std::nano>(fin - inicio).count() / repeticiones;
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> entradas;
+    for (const auto& p : detalle_palabras::PALABRAS) entradas.emplace_back(p.palabra);
+    for (const char* id : {"pin1", "estadoAlto", "x", "contador_de_vueltas", "led"}) entradas.emplace_back(id);
+
+    // Verificación: ambas versiones deben clasificar igual
+    for (const auto& e : entradas) {
+        if (identificarLineal(e) != identificarPalabraReservada(e)) {
+            std::cerr << "Clasificacion distinta para '" << e << "'\n";
+            return 1;
+        }
+    }
+
+    std::cout << std::left << std::setw(5) << "#" << std::setw(22) << "Entrada"
+              << std::setw(14) << "Lineal (ns)" << "Hash (ns)\n";
+    for (size_t i = 0; i < entradas.size(); ++i) {
+        double lineal = nsPorLlamada(entradas[i], [](const std::string& s) { return static_cast<int>(identificarLineal(s)); });
+        double hash = nsPorLlamada(entradas[i], [](const std::string& s) { return static_cast<int>(identificarPalabraReservada(s)); });
+        std::cout << std::setw(5) << i << std::setw(22) << entradas[i]
+                  << std::setw(14) << std::fixed << std::setprecision(2) << lineal << hash << "\n";
+    }
+    return 0;
+}
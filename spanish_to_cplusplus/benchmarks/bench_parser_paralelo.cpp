@@ -0,0 +1,72 @@
+// Benchmark del análisis de bloques en paralelo (parserParalelo.h): un
+// programa con un bucle_principal de cientos de miles de llamadas, algunas
+// con variables sin declarar y líneas con errores. Compara Parser::analizar
+// en serie contra analizar los tramos con varios hilos y luego el
+// programa con Parser::usarTramos, y verifica que ambos den el mismo
+// árbol, los mismos errores en el mismo orden y la misma tabla.
+//
+// Uso: bench_parser_paralelo [llamadas, 400000 por defecto]
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -pthread -I../../lib bench_parser_paralelo.cpp -o bench_parser_paralelo
+#include "generador.h"
+#include "../arbolPlano.h"
+#include "../parserParalelo.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using generador::medir;
+using generador::mismaTabla;
+using generador::mismosErrores;
+
+int main(int argc, char* argv[]) {
+    size_t llamadas = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 400000;
+    std::string texto = generador::generarBucleLargo(llamadas, true);
+    std::vector<Error> erroresLexicos;
+    std::vector<Token> tokens = analizadorLexico(texto, erroresLexicos);
+    std::cout << "Programa: " << llamadas << " llamadas, " << tokens.size() << " tokens, "
+              << std::thread::hardware_concurrency() << " nucleos\n";
+
+    std::vector<Error> erroresSerie;
+    Parser serie(tokens, erroresSerie);
+    ArbolSintactico arbolSerie = serie.analizar();
+    ArbolPlano planoSerie = ArbolPlano::desdeArbol(arbolSerie.get());
+    double tiempoSerie = medir([&] {
+        std::vector<Error> errores;
+        Parser parser(tokens, errores);
+        parser.analizar();
+    });
+    std::cout << std::fixed << std::setprecision(1) << "serie        " << std::setw(8) << tiempoSerie * 1e3
+              << " ms  (" << erroresSerie.size() << " errores)\n";
+
+    for (unsigned hilos : {2u, 4u, 8u}) {
+        size_t cantidadTramos = 0;
+        double tiempo = medir([&] {
+            std::vector<TramoInstrucciones> tramos = analizarTramosEnParalelo(tokens, hilos);
+            cantidadTramos = tramos.size();
+            std::vector<Error> errores;
+            Parser parser(tokens, errores);
+            parser.usarTramos(tramos);
+            parser.analizar();
+        });
+
+        std::vector<TramoInstrucciones> tramos = analizarTramosEnParalelo(tokens, hilos);
+        std::vector<Error> errores;
+        Parser parser(tokens, errores);
+        parser.usarTramos(tramos);
+        ArbolSintactico arbol = parser.analizar();
+        if (!(ArbolPlano::desdeArbol(arbol.get()) == planoSerie) || !mismosErrores(errores, erroresSerie) ||
+            !mismaTabla(parser.obtenerTablaSimbolos(), serie.obtenerTablaSimbolos())) {
+            std::cerr << "El analisis con " << hilos << " hilos difiere del analisis en serie\n";
+            return 1;
+        }
+        std::cout << hilos << " hilos      " << std::setw(8) << tiempo * 1e3 << " ms  (" << cantidadTramos
+                  << " tramos, x" << std::setprecision(2) << tiempoSerie / tiempo << std::setprecision(1) << ")\n";
+    }
+    return 0;
+}
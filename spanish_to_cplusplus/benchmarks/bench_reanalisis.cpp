@@ -0,0 +1,86 @@
+// Benchmark del reanálisis incremental: un programa generado de 1 MB
+// (generador.h) al que se le edita una palabra cada vez (cambiar un
+// número, renombrar una variable, borrarla). Después de relexarEdicion
+// compara ParserIncremental::actualizar contra volver a correr Parser::analizar
+// sobre toda la lista, y verifica que ambos den el mismo árbol, los mismos
+// errores y la misma tabla de símbolos.
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_reanalisis.cpp -o bench_reanalisis
+#include "generador.h"
+#include "../arbolPlano.h"
+#include "../parserIncremental.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using generador::mismaTabla;
+using generador::mismosErrores;
+
+int main() {
+    const size_t BYTES = size_t(1) << 20;
+    const int EDICIONES = 1000;
+    const char* reemplazos[] = {"7", "pinRenombrado", "1.5", "pin3", ""};
+
+    std::string texto = generador::generarPrograma(BYTES, false);
+    texto.reserve(texto.size() * 2); // Las ediciones no mueven el buffer
+    std::vector<Error> erroresLexicos;
+    TokensEditables tokens(texto, analizadorLexico(texto, erroresLexicos));
+    ParserIncremental incremental;
+    incremental.analizar(tokens);
+    std::cout << "Programa: " << std::count(texto.begin(), texto.end(), '\n') << " lineas, " << texto.size()
+              << " bytes, " << tokens.size() << " tokens, " << incremental.cantidadElementos() << " elementos\n";
+
+    std::mt19937 aleatorio(42);
+    double totalIncremental = 0;
+    double totalCompleto = 0;
+    size_t reanalizados = 0;
+    size_t tokensAnalizados = 0;
+    size_t completos = 0;
+    for (int i = 0; i < EDICIONES; ++i) {
+        // Reemplaza una palabra cualquiera de una línea al azar
+        size_t inicio = aleatorio() % texto.size();
+        while (inicio > 0 && texto[inicio - 1] != ' ' && texto[inicio - 1] != '\n') inicio--;
+        size_t fin = inicio;
+        while (fin < texto.size() && texto[fin] != ' ' && texto[fin] != '\n') fin++;
+        std::string nuevo = reemplazos[aleatorio() % std::size(reemplazos)];
+
+        texto.replace(inicio, fin - inicio, nuevo);
+        EdicionTexto edicion{inicio, fin - inicio, nuevo.size()};
+        ResultadoRelexado relexado = relexarEdicion(texto, edicion, tokens, erroresLexicos);
+        const std::vector<Token> lista = tokens.lista(); // Para el análisis completo
+
+        auto t0 = std::chrono::steady_clock::now();
+        ResultadoReanalisis resultado = incremental.actualizar(tokens, relexado);
+        auto t1 = std::chrono::steady_clock::now();
+        std::vector<Error> erroresCompletos;
+        Parser parser(lista, erroresCompletos);
+        ArbolSintactico arbol = parser.analizar();
+        auto t2 = std::chrono::steady_clock::now();
+
+        totalIncremental += std::chrono::duration<double>(t1 - t0).count();
+        totalCompleto += std::chrono::duration<double>(t2 - t1).count();
+        reanalizados += resultado.elementosReanalizados;
+        tokensAnalizados += resultado.tokensAnalizados;
+        completos += resultado.completo;
+        if (!(ArbolPlano::desdeArbol(incremental.arbol()) == ArbolPlano::desdeArbol(arbol.get())) ||
+            !mismosErrores(incremental.errores(), erroresCompletos) ||
+            !mismaTabla(incremental.obtenerTablaSimbolos(), parser.obtenerTablaSimbolos())) {
+            std::cerr << "El reanalisis difiere del analisis completo en la edicion " << i << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "ParserIncremental  " << std::setw(10) << totalIncremental / EDICIONES * 1e6 << " us/edicion  ("
+              << static_cast<double>(reanalizados) / EDICIONES << " elementos y "
+              << tokensAnalizados / EDICIONES << " tokens analizados en promedio, " << completos
+              << " analisis completos)\n"
+              << "Parser::analizar   " << std::setw(10) << totalCompleto / EDICIONES * 1e6 << " us/edicion\n";
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Benchmark de regresión de la recuperación de errores del parser: el
+// tiempo de Parser::analizar sobre entradas rotas por completo tiene que
+// crecer en forma lineal con la cantidad de tokens. Mide ns por token en
+// varios tamaños, sin límite de errores, con la lista de tokens y con
+// BufferTokens, y falla si el costo por token del tamaño más grande supera
+// en más de 3 veces al del más chico. Sobre el mismo BufferTokens compara
+// la recuperación que recorre los tipos con la que salta con el índice de
+// sincronización del lexer, así la diferencia es solo la del índice y no
+// la de guardar los tokens en columnas.
+//
+// Entradas:
+//   puntos y comas   un bucle_principal con solo ';': un error por token
+//   tramos largos    basura sin ';' salvo uno cada 4096 tokens
+//   sin sincronizar  basura sin ningún punto de sincronización
+//   llamadas rotas   "escribir((,);" repetido: errores dentro de argumentos
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_recuperacion.cpp -o bench_recuperacion
+#include "generador.h"
+#include "../parser.h"
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string generar(int entrada, size_t tokens) {
+    std::string fuente = "programa Roto\nbucle_principal\n";
+    for (size_t i = 0; i < tokens; ++i) {
+        switch (entrada) {
+            case 0: fuente += ";"; break;
+            case 1: fuente += i % 4096 == 4095 ? ";" : ")"; break;
+            case 2: fuente += ")"; break;
+            default: {
+                const char* llamada[] = {"escribir", "(", "(", ",", ")", ";"};
+                fuente += llamada[i % 6];
+                break;
+            }
+        }
+        fuente += i % 16 == 15 ? '\n' : ' ';
+    }
+    fuente += "\nfin_bucle\nfin_programa\n";
+    return fuente;
+}
+
+// Mejor de tres análisis; el flujo de cada uno se arma fuera de la medición
+template <typename ArmarFlujo>
+double medirAnalisis(ArmarFlujo&& armar, std::vector<Error>& encontrados) {
+    std::unique_ptr<TokenStream> flujo;
+    double mejor = generador::medir(3, [&] {
+        flujo = armar();
+        encontrados.clear();
+    }, [&] {
+        Parser parser(*flujo, encontrados);
+        parser.analizar();
+    });
+    return mejor;
+}
+
+} // namespace
+
+int main() {
+    const char* nombres[] = {"puntos y comas", "tramos largos", "sin sincronizar", "llamadas rotas"};
+    const size_t tamanos[] = {100000, 400000, 1600000};
+    bool lineal = true;
+
+    std::cout << std::left << std::setw(18) << "Entrada" << std::right << std::setw(10) << "Tokens"
+              << std::setw(10) << "Errores" << std::setw(16) << "Lista" << std::setw(16) << "Recorrido"
+              << std::setw(16) << "Indice" << "   (ns/token)\n"
+              << std::fixed << std::setprecision(1);
+    for (int entrada = 0; entrada < 4; ++entrada) {
+        double primeroLista = 0, primeroRecorrido = 0, primeroIndice = 0;
+        for (size_t tamano : tamanos) {
+            std::string texto = generar(entrada, tamano);
+            std::vector<Error> erroresLexicos;
+            std::vector<Token> tokens = analizadorLexico(texto, erroresLexicos);
+            BufferTokens columnas = BufferTokens::desdeTokens(texto, tokens);
+
+            auto sobreBuffer = [&](bool usarIndice) {
+                return [&columnas, usarIndice] {
+                    auto flujo = std::make_unique<TokenStream>(BufferTokens(columnas));
+                    flujo->usarIndiceSincronizacion(usarIndice);
+                    return flujo;
+                };
+            };
+            std::vector<Error> erroresLista, erroresRecorrido, erroresIndice;
+            const double porToken = 1e9 / tokens.size();
+            double lista = medirAnalisis([&] { return std::make_unique<TokenStream>(tokens); }, erroresLista) *
+                           porToken;
+            double recorrido = medirAnalisis(sobreBuffer(false), erroresRecorrido) * porToken;
+            double indice = medirAnalisis(sobreBuffer(true), erroresIndice) * porToken;
+            if (!generador::mismosErrores(erroresLista, erroresRecorrido) ||
+                !generador::mismosErrores(erroresRecorrido, erroresIndice)) {
+                std::cerr << "Lista, recorrido e indice dieron distintos errores en " << nombres[entrada] << "\n";
+                return 1;
+            }
+
+            if (tamano == tamanos[0]) {
+                primeroLista = lista;
+                primeroRecorrido = recorrido;
+                primeroIndice = indice;
+            } else if (lista > 3 * primeroLista || recorrido > 3 * primeroRecorrido || indice > 3 * primeroIndice) {
+                lineal = false;
+            }
+            std::cout << std::left << std::setw(18) << nombres[entrada] << std::right << std::setw(10)
+                      << tokens.size() << std::setw(10) << erroresLista.size() << std::setw(16) << lista
+                      << std::setw(16) << recorrido << std::setw(16) << indice << "\n";
+        }
+    }
+
+    if (!lineal) {
+        std::cerr << "El costo por token crece con el tamano: la recuperacion no es lineal\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Benchmark del relexado incremental: un programa de 50 000 líneas al que
+// se le edita una línea cada vez (cambiar un número, renombrar una
+// variable, abrir y cerrar un comentario). Compara relexarEdicion contra
+// volver a correr analizadorLexico completo y verifica que ambos den la
+// misma lista de tokens y los mismos errores. El texto se edita en el
+// mismo buffer, como lo haría un editor.
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_relexado.cpp -o bench_relexado
+#include "generador.h"
+#include "../lexerIncremental.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string generarPrograma(int lineas) {
+    std::string fuente = "programa Relexado\n";
+    for (int i = 0; i < lineas - 2; ++i) {
+        switch (i % 4) {
+            case 0: fuente += "entero pin" + std::to_string(i) + " = " + std::to_string(i % 14) + ";\n"; break;
+            case 1: fuente += "    escribir(pin" + std::to_string(i - 1) + ", \"ALTO\");\n"; break;
+            case 2: fuente += "    esperar(" + std::to_string(100 + i % 900) + "); // pausa\n"; break;
+            default: fuente += "decimal factor" + std::to_string(i) + " = 0.5;\n"; break;
+        }
+    }
+    fuente += "fin_programa\n";
+    return fuente;
+}
+
+} // namespace
+
+int main() {
+    const int LINEAS = 50000;
+    const int EDICIONES = 2000;
+    const char* reemplazos[] = {"7", "pinRenombrado", "/* comentario */", "\"texto\"", "1.5", ""};
+
+    std::string texto = generarPrograma(LINEAS);
+    texto.reserve(texto.size() * 2); // Las ediciones no mueven el buffer
+    std::vector<Error> errores;
+    TokensEditables tokens(texto, analizadorLexico(texto, errores));
+    std::cout << "Programa: " << LINEAS << " lineas, " << texto.size() << " bytes, "
+              << tokens.size() << " tokens\n";
+
+    std::mt19937 aleatorio(42);
+    double totalIncremental = 0;
+    double totalCompleto = 0;
+    size_t bytesAnalizados = 0;
+    for (int i = 0; i < EDICIONES; ++i) {
+        // Reemplaza una palabra cualquiera de una línea al azar
+        size_t inicio = aleatorio() % texto.size();
+        while (inicio > 0 && texto[inicio - 1] != ' ' && texto[inicio - 1] != '\n') inicio--;
+        size_t fin = inicio;
+        while (fin < texto.size() && texto[fin] != ' ' && texto[fin] != '\n') fin++;
+        std::string nuevo = reemplazos[aleatorio() % std::size(reemplazos)];
+
+        texto.replace(inicio, fin - inicio, nuevo);
+        EdicionTexto edicion{inicio, fin - inicio, nuevo.size()};
+
+        auto t0 = std::chrono::steady_clock::now();
+        ResultadoRelexado resultado = relexarEdicion(texto, edicion, tokens, errores);
+        auto t1 = std::chrono::steady_clock::now();
+        std::vector<Error> erroresCompletos;
+        std::vector<Token> completos = analizadorLexico(texto, erroresCompletos);
+        auto t2 = std::chrono::steady_clock::now();
+
+        totalIncremental += std::chrono::duration<double>(t1 - t0).count();
+        totalCompleto += std::chrono::duration<double>(t2 - t1).count();
+        bytesAnalizados += resultado.bytesAnalizados;
+        if (!generador::mismosTokens(tokens.lista(), completos, true) || !generador::mismosErrores(errores, erroresCompletos)) {
+            std::cerr << "El relexado difiere del analisis completo en la edicion " << i << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "relexarEdicion     " << std::setw(10) << totalIncremental / EDICIONES * 1e6 << " us/edicion  ("
+              << bytesAnalizados / EDICIONES << " bytes analizados en promedio)\n"
+              << "analizadorLexico   " << std::setw(10) << totalCompleto / EDICIONES * 1e6 << " us/edicion\n";
+    return 0;
+}
@@ -0,0 +1,294 @@
+// Suite de rendimiento del compilador sobre programas sintéticos
+// (generador.h) de 1 KB, 1 MB y 100 MB, y de 1 GB a pedido, cada uno en
+// variante limpia y con errores. Para cada etapa reporta MB/s (bytes de
+// fuente) y tokens/s: analizadorLexico, Parser::analizar,
+// AnalizadorSemantico::analizar y cada generador de JSON por separado
+// (tokens en DOM y en flujo, AST, símbolos y errores). Los resultados se
+// escriben además en JSON para comparar entre versiones.
+//
+// Uso:
+//   bench_suite [--tamanos 1k,1m,100m,1g] [--salida resultados.json]
+//               [--repeticiones N] [--max-dom 64m]
+// Los generadores que arman el documento completo en memoria
+// (generarJsonTokens y generarJsonAST) se omiten por encima de --max-dom.
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_suite.cpp -o bench_suite
+#include "generador.h"
+#include "../jsonParser.h"
+#include "../lexer.h"
+#include "../parser.h"
+#include "../semantic.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+using generador::medir;
+
+struct Tamano {
+    std::string etiqueta;
+    size_t bytes;
+};
+
+struct Etapa {
+    std::string nombre;
+    double segundos = 0;    // Mejor de las repeticiones
+    std::string omitida;    // Motivo, si no se midió
+};
+
+struct Resultado {
+    std::string tamano;
+    std::string variante;
+    size_t bytes = 0;
+    size_t tokens = 0;
+    size_t errores = 0;
+    std::vector<Etapa> etapas;
+};
+
+// "1k", "1m", "100m", "1g" -> bytes
+bool leerTamano(const std::string& texto, Tamano& tamano) {
+    char* fin = nullptr;
+    unsigned long long valor = std::strtoull(texto.c_str(), &fin, 10);
+    if (fin == texto.c_str()) return false;
+    switch (*fin) {
+        case 'k': case 'K': valor <<= 10; break;
+        case 'm': case 'M': valor <<= 20; break;
+        case 'g': case 'G': valor <<= 30; break;
+        case '\0': break;
+        default: return false;
+    }
+    tamano = {texto, static_cast<size_t>(valor)};
+    return valor > 0;
+}
+
+// Descarta los avisos "JSON generado" de los generadores
+class SalidaNula : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+class Silencio {
+public:
+    Silencio() : anterior(std::cout.rdbuf(&nula)) {}
+    ~Silencio() { std::cout.rdbuf(anterior); }
+
+private:
+    SalidaNula nula;
+    std::streambuf* anterior;
+};
+
+Resultado ejecutar(const Tamano& tamano, bool conErrores, int repeticiones, size_t maxDom,
+                   const std::string& carpeta) {
+    Resultado resultado;
+    resultado.tamano = tamano.etiqueta;
+    resultado.variante = conErrores ? "errores" : "limpio";
+
+    const std::string fuente = generador::generarPrograma(tamano.bytes, conErrores);
+    resultado.bytes = fuente.size();
+    const auto nada = [] {};
+
+    std::vector<Token> tokens;
+    std::vector<Error> erroresLexicos;
+    double tLexer = medir(repeticiones, [&] {
+        tokens = std::vector<Token>();
+        erroresLexicos.clear();
+    }, [&] { tokens = analizadorLexico(fuente, erroresLexicos); });
+    resultado.tokens = tokens.size();
+    resultado.etapas.push_back({"analizadorLexico", tLexer, ""});
+
+    // El parser recorre la lista prestada, sin copiarla
+    std::vector<Error> erroresParser;
+    std::unique_ptr<Parser> parser;
+    ArbolSintactico ast;
+    double tParser = medir(repeticiones, [&] {
+        ast = ArbolSintactico();
+        parser.reset();
+        erroresParser.clear();
+    }, [&] {
+        parser = std::make_unique<Parser>(tokens, erroresParser);
+        ast = parser->analizar();
+    });
+    resultado.etapas.push_back({"Parser::analizar", tParser, ""});
+
+    // Como en main, el análisis semántico y ast.json solo se hacen sobre un
+    // AST sin errores (con errores puede tener declaraciones nulas)
+    const bool astValido = erroresLexicos.empty() && erroresParser.empty();
+    const std::string conErroresTexto = "el programa tiene errores";
+    std::vector<Error> erroresSemanticos;
+    if (astValido) {
+        double tSemantico = medir(repeticiones, [&] { erroresSemanticos.clear(); }, [&] {
+            AnalizadorSemantico semantico(erroresSemanticos, parser->obtenerTablaSimbolos());
+            semantico.analizar(ast.get());
+        });
+        resultado.etapas.push_back({"AnalizadorSemantico::analizar", tSemantico, ""});
+    } else {
+        resultado.etapas.push_back({"AnalizadorSemantico::analizar", 0, conErroresTexto});
+    }
+
+    std::vector<Error> errores = erroresLexicos;
+    errores.insert(errores.end(), erroresParser.begin(), erroresParser.end());
+    errores.insert(errores.end(), erroresSemanticos.begin(), erroresSemanticos.end());
+    resultado.errores = errores.size();
+
+    const std::string base = carpeta + "/" + tamano.etiqueta + "_" + resultado.variante;
+    const std::string muyGrande = "fuente mayor que --max-dom";
+    Silencio silencio;
+
+    if (fuente.size() <= maxDom) {
+        double t = medir(repeticiones, nada, [&] { GeneradorJSON::generarJsonTokens(tokens, base + "_tokens.json"); });
+        resultado.etapas.push_back({"GeneradorJSON::generarJsonTokens", t, ""});
+    } else {
+        resultado.etapas.push_back({"GeneradorJSON::generarJsonTokens", 0, muyGrande});
+    }
+
+    double tEscritor = medir(repeticiones, nada, [&] {
+        EscritorJsonTokens escritor(base + "_tokens_flujo.json");
+        for (const Token& token : tokens) escritor.agregar(token);
+        escritor.cerrar();
+    });
+    resultado.etapas.push_back({"EscritorJsonTokens", tEscritor, ""});
+
+    if (!astValido) {
+        resultado.etapas.push_back({"Parser::generarJsonAST", 0, conErroresTexto});
+    } else if (fuente.size() <= maxDom) {
+        double t = medir(repeticiones, nada, [&] {
+            std::ofstream archivo(base + "_ast.json");
+            archivo << parser->generarJsonAST(ast) << std::endl;
+        });
+        resultado.etapas.push_back({"Parser::generarJsonAST", t, ""});
+    } else {
+        resultado.etapas.push_back({"Parser::generarJsonAST", 0, muyGrande});
+    }
+
+    double tSimbolos = medir(repeticiones, nada, [&] {
+        GeneradorJSON::generarJsonSimbolos(parser->obtenerTablaSimbolos(), base + "_simbolos.json");
+    });
+    resultado.etapas.push_back({"GeneradorJSON::generarJsonSimbolos", tSimbolos, ""});
+
+    double tErrores = medir(repeticiones, nada, [&] {
+        GeneradorJSON::generarJsonError(errores, base + "_errores.json");
+    });
+    resultado.etapas.push_back({"GeneradorJSON::generarJsonError", tErrores, ""});
+
+    return resultado;
+}
+
+json aJson(const std::vector<Resultado>& resultados, int repeticiones) {
+    json documento;
+    documento["version"] = 1;
+    documento["compilador"] = __VERSION__;
+    documento["repeticiones"] = repeticiones;
+    documento["resultados"] = json::array();
+    for (const auto& resultado : resultados) {
+        json entrada = {
+            {"tamano", resultado.tamano},
+            {"variante", resultado.variante},
+            {"bytes", resultado.bytes},
+            {"tokens", resultado.tokens},
+            {"errores", resultado.errores}};
+        json etapas = json::object();
+        for (const auto& etapa : resultado.etapas) {
+            if (!etapa.omitida.empty()) {
+                etapas[etapa.nombre] = {{"omitida", etapa.omitida}};
+                continue;
+            }
+            double megas = resultado.bytes / (1024.0 * 1024.0);
+            etapas[etapa.nombre] = {
+                {"segundos", etapa.segundos},
+                {"mbPorSegundo", megas / etapa.segundos},
+                {"tokensPorSegundo", resultado.tokens / etapa.segundos}};
+        }
+        entrada["etapas"] = etapas;
+        documento["resultados"].push_back(entrada);
+    }
+    return documento;
+}
+
+void imprimir(const Resultado& resultado) {
+    double megas = resultado.bytes / (1024.0 * 1024.0);
+    std::cout << "\n" << resultado.tamano << " " << resultado.variante << ": " << resultado.bytes << " bytes, "
+              << resultado.tokens << " tokens, " << resultado.errores << " errores\n";
+    for (const auto& etapa : resultado.etapas) {
+        std::cout << "  " << std::left << std::setw(36) << etapa.nombre << std::right;
+        if (!etapa.omitida.empty()) {
+            std::cout << "omitida (" << etapa.omitida << ")\n";
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(1) << std::setw(10) << megas / etapa.segundos << " MB/s "
+                  << std::setprecision(2) << std::setw(10) << resultado.tokens / etapa.segundos / 1e6
+                  << " Mtokens/s\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<Tamano> tamanos = {{"1k", 1u << 10}, {"1m", 1u << 20}, {"100m", 100u << 20}};
+    std::string salida = "resultados_bench.json";
+    int repeticiones = 3;
+    Tamano maxDom{"64m", 64u << 20};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argumento = argv[i];
+        if (argumento == "--tamanos" && i + 1 < argc) {
+            tamanos.clear();
+            std::stringstream lista(argv[++i]);
+            std::string elemento;
+            while (std::getline(lista, elemento, ',')) {
+                Tamano tamano;
+                if (!leerTamano(elemento, tamano)) {
+                    std::cerr << "Tamano invalido: " << elemento << "\n";
+                    return 1;
+                }
+                tamanos.push_back(tamano);
+            }
+        } else if (argumento == "--salida" && i + 1 < argc) {
+            salida = argv[++i];
+        } else if (argumento == "--repeticiones" && i + 1 < argc) {
+            repeticiones = std::max(1, std::atoi(argv[++i]));
+        } else if (argumento == "--max-dom" && i + 1 < argc) {
+            if (!leerTamano(argv[++i], maxDom)) {
+                std::cerr << "Tamano invalido: " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Opcion desconocida: " << argumento << "\n";
+            return 1;
+        }
+    }
+
+    // Los JSON de cada etapa se escriben en una carpeta temporal
+    std::filesystem::path carpeta = std::filesystem::temp_directory_path() / "stcpp_bench";
+    std::filesystem::create_directories(carpeta);
+
+    std::vector<Resultado> resultados;
+    for (const auto& tamano : tamanos) {
+        for (bool conErrores : {false, true}) {
+            // Los tamaños grandes se miden una sola vez
+            int veces = tamano.bytes >= (size_t(100) << 20) ? 1 : repeticiones;
+            resultados.push_back(ejecutar(tamano, conErrores, veces, maxDom.bytes, carpeta.string()));
+            imprimir(resultados.back());
+            std::cout << std::flush;
+        }
+    }
+    std::filesystem::remove_all(carpeta);
+
+    std::ofstream archivo(salida);
+    if (!archivo.is_open()) {
+        std::cerr << "No se pudo escribir " << salida << "\n";
+        return 1;
+    }
+    archivo << aJson(resultados, repeticiones).dump(4) << std::endl;
+    std::cout << "\nResultados en " << salida << "\n";
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Benchmark de la tabla de símbolos: inserción y búsqueda con 10^5 y 10^6
+// declaraciones. Compara TablaSimbolos (direccionamiento abierto por id)
+// contra las dos versiones anteriores: el std::unordered_map por nombre
+// con el nombre copiado en cada Simbolo, y el arreglo indexado por id con
+// una casilla por cada identificador internado. La última prueba arma
+// muchas tablas chicas con ids dispersos, como las de los parsers de un
+// elemento o de un tramo, donde el arreglo crece hasta el id más alto.
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_tabla_simbolos.cpp -o bench_tabla_simbolos
+#include "generador.h"
+#include "../simbolos.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using generador::medir;
+
+// Versión original: el nombre es la clave y también se copia en el símbolo
+struct SimboloConNombre {
+    std::string nombre;
+    TipoDato tipo;
+    int lineaDeclaracion;
+    std::string valor;
+};
+
+class TablaPorNombre {
+public:
+    void insertar(const SimboloConNombre& simbolo) { simbolos[simbolo.nombre] = simbolo; }
+
+    SimboloConNombre* buscar(const std::string& nombre) {
+        auto it = simbolos.find(nombre);
+        return it != simbolos.end() ? &it->second : nullptr;
+    }
+
+private:
+    std::unordered_map<std::string, SimboloConNombre> simbolos;
+};
+
+// Versión anterior: posición por id en un arreglo del tamaño del id más alto
+class TablaDensa {
+public:
+    void insertar(const Simbolo& simbolo) {
+        if (simbolo.id >= posiciones.size()) posiciones.resize(simbolo.id + 1, 0);
+        uint32_t& posicion = posiciones[simbolo.id];
+        if (posicion != 0) {
+            simbolos[posicion - 1] = simbolo;
+            return;
+        }
+        simbolos.push_back(simbolo);
+        posicion = static_cast<uint32_t>(simbolos.size());
+    }
+
+    Simbolo* buscar(SimboloId id) {
+        if (id >= posiciones.size() || posiciones[id] == 0) return nullptr;
+        return &simbolos[posiciones[id] - 1];
+    }
+
+private:
+    std::vector<Simbolo> simbolos;
+    std::vector<uint32_t> posiciones;
+};
+
+volatile size_t sumidero = 0;
+
+void fila(const char* nombre, double segundos, size_t operaciones, const char* unidad = "op") {
+    std::cout << "  " << std::left << std::setw(30) << nombre << std::right << std::setw(10)
+              << segundos / operaciones * 1e9 << " ns/" << unidad << std::setw(10)
+              << operaciones / segundos / 1e6 << " M" << unidad << "/s\n";
+}
+
+void probar(size_t cantidad) {
+    // Nombres internados antes de medir, como los deja el lexer; la mitad
+    // de las búsquedas son de nombres que nunca se declaran
+    std::vector<std::string> nombres;
+    std::vector<SimboloId> ids;
+    for (size_t i = 0; i < 2 * cantidad; ++i) {
+        nombres.push_back("var" + std::to_string(i));
+        ids.push_back(cadenasGlobales().internar(nombres.back()));
+    }
+    std::vector<size_t> consultas(2 * cantidad);
+    for (size_t i = 0; i < consultas.size(); ++i) consultas[i] = i;
+    std::shuffle(consultas.begin(), consultas.end(), std::mt19937(7));
+
+    std::cout << cantidad << " declaraciones\n" << std::fixed << std::setprecision(1);
+
+    TablaPorNombre porNombre;
+    fila("unordered_map: insertar", medir([&] {
+             porNombre = TablaPorNombre();
+             for (size_t i = 0; i < cantidad; ++i) porNombre.insertar({nombres[i], ENTERO, int(i), "1"});
+         }), cantidad);
+    fila("unordered_map: buscar", medir([&] {
+             size_t encontrados = 0;
+             for (size_t c : consultas) encontrados += porNombre.buscar(nombres[c]) != nullptr;
+             sumidero = encontrados;
+         }), consultas.size());
+
+    TablaDensa densa;
+    fila("arreglo por id: insertar", medir([&] {
+             densa = TablaDensa();
+             for (size_t i = 0; i < cantidad; ++i) densa.insertar({ids[i], ENTERO, int(i), "1"});
+         }), cantidad);
+    fila("arreglo por id: buscar", medir([&] {
+             size_t encontrados = 0;
+             for (size_t c : consultas) encontrados += densa.buscar(ids[c]) != nullptr;
+             sumidero = encontrados;
+         }), consultas.size());
+
+    TablaSimbolos tabla;
+    fila("TablaSimbolos: insertar", medir([&] {
+             tabla = TablaSimbolos();
+             for (size_t i = 0; i < cantidad; ++i) tabla.insertar({ids[i], ENTERO, int(i), "1"});
+         }), cantidad);
+    fila("TablaSimbolos: buscar", medir([&] {
+             size_t encontrados = 0;
+             for (size_t c : consultas) encontrados += tabla.buscar(ids[c]) != nullptr;
+             sumidero = encontrados;
+         }), consultas.size());
+
+    // Verificación: las tres tablas encuentran lo mismo
+    for (size_t c : consultas) {
+        bool declarado = c < cantidad;
+        if ((porNombre.buscar(nombres[c]) != nullptr) != declarado ||
+            (densa.buscar(ids[c]) != nullptr) != declarado || (tabla.buscar(ids[c]) != nullptr) != declarado ||
+            (declarado && tabla.buscar(ids[c])->lineaDeclaracion != int(c))) {
+            std::cerr << "Las tablas no coinciden en " << nombres[c] << "\n";
+            std::exit(1);
+        }
+    }
+
+    // Tablas chicas: 8 declaraciones cada una, con ids de todo el rango
+    const size_t TABLAS = cantidad / 8;
+    std::vector<SimboloId> dispersos(ids.begin(), ids.begin() + cantidad);
+    std::shuffle(dispersos.begin(), dispersos.end(), std::mt19937(11));
+    fila("arreglo por id: tabla de 8", medir([&] {
+             size_t encontrados = 0;
+             for (size_t t = 0; t < TABLAS; ++t) {
+                 TablaDensa chica;
+                 for (size_t i = 0; i < 8; ++i) chica.insertar({dispersos[t * 8 + i], ENTERO, 0, ""});
+                 encontrados += chica.buscar(dispersos[t * 8]) != nullptr;
+             }
+             sumidero = encontrados;
+         }), TABLAS, "tabla");
+    fila("TablaSimbolos: tabla de 8", medir([&] {
+             size_t encontrados = 0;
+             for (size_t t = 0; t < TABLAS; ++t) {
+                 TablaSimbolos chica;
+                 for (size_t i = 0; i < 8; ++i) chica.insertar({dispersos[t * 8 + i], ENTERO, 0, ""});
+                 encontrados += chica.buscar(dispersos[t * 8]) != nullptr;
+             }
+             sumidero = encontrados;
+         }), TABLAS, "tabla");
+}
+
+} // namespace
+
+int main() {
+    probar(100000);
+    probar(1000000);
+    return 0;
+}
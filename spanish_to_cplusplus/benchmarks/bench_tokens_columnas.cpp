@@ -0,0 +1,91 @@
+// Benchmark del almacenamiento de tokens: std::vector<Token> contra
+// BufferTokens (columnas). Mide la memoria por token, un recorrido que solo
+// mira los tipos (contar cierres de bloque) y Parser::analizar sobre cada
+// representación, verificando que el AST y los errores no cambien.
+//
+// Compilar desde spanish_to_cplusplus/benchmarks:
+//   g++ -std=c++17 -O2 -I../../lib bench_tokens_columnas.cpp -o bench_tokens_columnas
+#include "generador.h"
+#include "../bufferTokens.h"
+#include "../parser.h"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using generador::medir;
+
+std::string generarPrograma(int pasos) {
+    std::string fuente = "programa columnas\nentero pin1 = 2;\ncadena alto = \"ALTO\";\n"
+                         "configurar\nconfigurar_pin(pin1, \"SALIDA\");\nfin_configurar\nbucle_principal\n";
+    for (int i = 0; i < pasos; ++i) {
+        fuente += "    escribir(pin1, alto); /* paso */ // " + std::to_string(i) + "\n";
+        fuente += "    esperar(" + std::to_string(i % 1000) + ");\n";
+    }
+    fuente += "fin_bucle\nfin_programa\n";
+    return fuente;
+}
+
+bool esCierre(TokenType tipo) {
+    return tipo == TOKEN_FIN_CONFIGURAR || tipo == TOKEN_FIN_BUCLE || tipo == TOKEN_FIN_PROGRAMA;
+}
+
+volatile size_t sumidero = 0;
+
+} // namespace
+
+int main() {
+    const std::string fuente = generarPrograma(150000);
+    std::vector<Error> errores;
+    std::vector<Token> tokens = analizadorLexico(fuente, errores);
+    BufferTokens columnas = BufferTokens::desdeTokens(fuente, tokens);
+    const double cantidad = static_cast<double>(tokens.size());
+
+    std::cout << "Tokens: " << tokens.size() << "\n" << std::fixed << std::setprecision(1)
+              << "Memoria  vector<Token> " << std::setw(6) << tokens.capacity() * sizeof(Token) / cantidad
+              << " bytes/token   BufferTokens " << std::setw(6) << columnas.bytesUsados() / cantidad
+              << " bytes/token\n";
+
+    double tVector = medir([&] {
+        size_t total = 0;
+        for (const auto& token : tokens) total += esCierre(token.type);
+        sumidero = total;
+    });
+    double tColumnas = medir([&] {
+        size_t total = 0;
+        const uint8_t* tipos = columnas.datosTipos();
+        for (size_t i = 0; i < columnas.size(); ++i) total += esCierre(static_cast<TokenType>(tipos[i]));
+        sumidero = total;
+    });
+    std::cout << std::setprecision(2)
+              << "Recorrer tipos  vector<Token> " << std::setw(8) << tVector * 1e9 / cantidad << " ns/token   "
+              << "BufferTokens " << std::setw(8) << tColumnas * 1e9 / cantidad << " ns/token\n";
+
+    std::string astVector, astColumnas;
+    size_t erroresVector = 0, erroresColumnas = 0;
+    double pVector = medir([&] {
+        std::vector<Error> erroresParser;
+        Parser parser(tokens, erroresParser);
+        auto ast = parser.analizar();
+        astVector = parser.generarJsonAST(ast);
+        erroresVector = erroresParser.size();
+    });
+    double pColumnas = medir([&] {
+        std::vector<Error> erroresParser;
+        Parser parser(BufferTokens::desdeTokens(fuente, tokens), erroresParser);
+        auto ast = parser.analizar();
+        astColumnas = parser.generarJsonAST(ast);
+        erroresColumnas = erroresParser.size();
+    });
+    if (astVector != astColumnas || erroresVector != erroresColumnas) {
+        std::cerr << "El parser dio resultados distintos con BufferTokens\n";
+        return 1;
+    }
+    std::cout << std::setprecision(3)
+              << "Parser::analizar + JSON  vector<Token> " << pVector << " s   BufferTokens (incluye armarlo) "
+              << pColumnas << " s\n";
+    return 0;
+}
@@ -0,0 +1,248 @@
+#ifndef GENERADOR_H
+#define GENERADOR_H
+
+#include "../errores.h"
+#include "../lexer.h"
+#include "../simbolos.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Generador de programas stcpp sintéticos para los benchmarks.
+//
+// Arma un programa válido del tamaño pedido con declaraciones de los
+// cuatro tipos, bloques configurar, cuerpos largos de bucle_principal y
+// comentarios de línea y de bloque. La variante con errores inyecta fallos
+// léxicos y sintácticos (caracteres no reconocidos, números con varios
+// puntos, cadenas sin cerrar, ';' faltantes, declaraciones sin nombre) en
+// una de cada ~25 líneas. Cada error queda en su línea: el parser se
+// recupera antes de la siguiente sin arrastrar el resto del bloque. La
+// salida depende solo de la semilla.
+//
+// generarBucleLargo arma en cambio un único bucle_principal de la cantidad
+// de llamadas pedida, para lo que mira cuerpos de bloque largos (análisis
+// por tramos, AST binario, caché). También trae medir(), la medición
+// "mejor de N" que comparten todos los benchmarks, y las comparaciones
+// campo por campo de tokens, errores y tablas con las que verifican que
+// la variante medida da lo mismo que la de referencia.
+
+namespace generador {
+
+class GeneradorPrograma {
+public:
+    GeneradorPrograma(bool conErrores, uint32_t semilla) : conErrores(conErrores), azar(semilla) {}
+
+    std::string generar(size_t bytesObjetivo) {
+        fuente.clear();
+        fuente.reserve(bytesObjetivo + 4096);
+        fuente += "programa sintetico\n";
+        fuente += "incluir <\"Arduino\">\n\n";
+        while (fuente.size() + 32 < bytesObjetivo) seccion(bytesObjetivo);
+        fuente += "fin_programa\n";
+        return std::move(fuente);
+    }
+
+private:
+    bool conErrores;
+    std::mt19937 azar;
+    std::string fuente;
+    size_t variables = 0; // Declaradas hasta ahora: v0 .. v(variables-1)
+    size_t pines = 0;
+
+    size_t entre(size_t minimo, size_t maximo) { return minimo + azar() % (maximo - minimo + 1); }
+    bool cada(uint32_t n) { return azar() % n == 0; }
+    std::string variable() { return "v" + std::to_string(variables ? azar() % variables : 0); }
+    std::string pin() { return "pin" + std::to_string(pines ? azar() % pines : 0); }
+
+    // Algunas líneas se reemplazan por una con un error. Nada deja dos
+    // argumentos sin ',' entre ellos ("1.2.3", "pin # x"): la lista de
+    // argumentos no se cierra y el error se repite en cada línea siguiente.
+    // Al esperar sin ';' le sigue otra llamada en la misma línea, para que
+    // la recuperación no se lleve la declaración de abajo.
+    bool lineaConError() {
+        if (!conErrores || !cada(25)) return false;
+        switch (azar() % 6) {
+            case 0: fuente += "    escribir(@" + pin() + ", \"ALTO\");\n"; break;
+            case 1: fuente += "    esperar(1.2.);\n"; break;
+            case 2: fuente += "    escribir(" + pin() + ", \"ALTO\"); \"sin cerrar\n"; break;
+            case 3: fuente += "    esperar(" + std::to_string(azar() % 5000) + ") esperar(1);\n"; break;
+            case 4: fuente += "    entero = 5;\n"; break;
+            default: fuente += "    escribir(" + pin() + ", # \"BAJO\");\n"; break;
+        }
+        return true;
+    }
+
+    void comentario() {
+        if (cada(2)) {
+            fuente += "    // paso " + std::to_string(azar() % 100000) + " del ciclo\n";
+        } else {
+            fuente += "    /* bloque de comentario\n       de dos lineas */\n";
+        }
+    }
+
+    void declaraciones() {
+        size_t cantidad = entre(4, 16);
+        for (size_t i = 0; i < cantidad; ++i) {
+            if (lineaConError()) continue;
+            std::string nombre = "v" + std::to_string(variables);
+            switch (azar() % 5) {
+                case 0: fuente += "entero " + nombre + " = " + std::to_string(azar() % 100000) + ";\n"; break;
+                case 1: fuente += "decimal " + nombre + " = " + std::to_string(azar() % 1000) + "." +
+                                  std::to_string(azar() % 100) + ";\n"; break;
+                case 2: fuente += "cadena " + nombre + " = \"texto " + std::to_string(azar() % 1000) + "\";\n"; break;
+                case 3: fuente += "booleano " + nombre + (cada(2) ? " = verdadero;\n" : ";\n"); break;
+                default:
+                    if (variables == 0) {
+                        fuente += "entero " + nombre + " = 0;\n";
+                    } else {
+                        fuente += "entero " + nombre + " = " + variable() + ";\n";
+                    }
+                    break;
+            }
+            ++variables;
+        }
+        size_t nuevosPines = entre(1, 4);
+        for (size_t i = 0; i < nuevosPines; ++i) {
+            fuente += "entero pin" + std::to_string(pines++) + " = " + std::to_string(azar() % 14) + ";\n";
+        }
+        fuente += "\n";
+    }
+
+    void configurar() {
+        fuente += "configurar\n";
+        size_t cantidad = entre(1, 6);
+        for (size_t i = 0; i < cantidad; ++i) {
+            if (lineaConError()) continue;
+            fuente += "    configurar_pin(" + pin() + (cada(2) ? ", \"SALIDA\");\n" : ", \"ENTRADA\");\n");
+        }
+        fuente += "fin_configurar\n\n";
+    }
+
+    void buclePrincipal(size_t bytesObjetivo) {
+        fuente += "bucle_principal\n";
+        size_t cantidad = entre(20, 400);
+        for (size_t i = 0; i < cantidad && fuente.size() + 64 < bytesObjetivo; ++i) {
+            if (lineaConError()) continue;
+            switch (azar() % 8) {
+                case 0: comentario(); break;
+                case 1:
+                case 2: fuente += "    esperar(" + std::to_string(azar() % 5000) + ");\n"; break;
+                case 3: fuente += "    escribir(" + pin() + ", " + variable() + ");\n"; break;
+                default: fuente += "    escribir(" + pin() + (cada(2) ? ", \"ALTO\");\n" : ", \"BAJO\");\n"); break;
+            }
+        }
+        fuente += "fin_bucle\n\n";
+    }
+
+    void seccion(size_t bytesObjetivo) {
+        declaraciones();
+        if (cada(3)) comentario();
+        configurar();
+        buclePrincipal(bytesObjetivo);
+    }
+};
+
+// Programa sintético de unos bytesObjetivo bytes
+inline std::string generarPrograma(size_t bytesObjetivo, bool conErrores, uint32_t semilla = 2024) {
+    return GeneradorPrograma(conErrores, semilla).generar(bytesObjetivo);
+}
+
+// 64 pines declarados y configurados y un bucle_principal de llamadas
+// escribir/esperar. Con errores, una de cada 5000 llamadas no tiene ';' y
+// algunos escribir usan pin64..pin69, que no están declarados.
+inline std::string generarBucleLargo(size_t llamadas, bool conErrores = false) {
+    std::string fuente = "programa BucleLargo\n";
+    for (int i = 0; i < 64; ++i) fuente += "entero pin" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+    fuente += "configurar\n";
+    for (int i = 0; i < 64; ++i) fuente += "    configurar_pin(pin" + std::to_string(i) + ", \"SALIDA\");\n";
+    fuente += "fin_configurar\nbucle_principal\n";
+    size_t pinesEscritos = conErrores ? 70 : 64;
+    for (size_t i = 0; i < llamadas; ++i) {
+        if (conErrores && i % 5000 == 4999) {
+            fuente += "    esperar(100)\n";
+        } else if (i % 3 == 0) {
+            fuente += "    escribir(pin" + std::to_string(i % pinesEscritos) + ", \"ALTO\");\n";
+        } else if (i % 3 == 1) {
+            fuente += "    esperar(pin" + std::to_string(i % 64) + " * 10 + " + std::to_string(i % 1000) + ");\n";
+        } else {
+            fuente += "    escribir(pin" + std::to_string(i % 64) + ", \"BAJO\");\n";
+        }
+    }
+    fuente += "fin_bucle\nfin_programa\n";
+    return fuente;
+}
+
+// Mejor tiempo, en segundos, de varias corridas de funcion
+template <typename F>
+double medir(F&& funcion, int repeticiones = 3) {
+    double mejor = 1e30;
+    for (int intento = 0; intento < repeticiones; ++intento) {
+        auto inicio = std::chrono::steady_clock::now();
+        funcion();
+        auto fin = std::chrono::steady_clock::now();
+        mejor = std::min(mejor, std::chrono::duration<double>(fin - inicio).count());
+    }
+    return mejor;
+}
+
+// Igual, con preparar corriendo antes de cada corrida y fuera de la medición
+template <typename Preparar, typename F>
+double medir(int repeticiones, Preparar&& preparar, F&& funcion) {
+    double mejor = 1e30;
+    for (int intento = 0; intento < repeticiones; ++intento) {
+        preparar();
+        auto inicio = std::chrono::steady_clock::now();
+        funcion();
+        auto fin = std::chrono::steady_clock::now();
+        mejor = std::min(mejor, std::chrono::duration<double>(fin - inicio).count());
+    }
+    return mejor;
+}
+
+// Mismos tokens en el mismo orden. Con mismaMemoria además cada valor
+// tiene que apuntar al mismo lugar del texto, no solo decir lo mismo
+inline bool mismosTokens(const std::vector<Token>& a, const std::vector<Token>& b, bool mismaMemoria = false) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].type != b[i].type || a[i].simbolo != b[i].simbolo || a[i].value != b[i].value ||
+            a[i].line != b[i].line || a[i].column != b[i].column ||
+            (mismaMemoria && a[i].value.data() != b[i].value.data())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Mismos errores en el mismo orden, incluidas las rachas agrupadas
+inline bool mismosErrores(const std::vector<Error>& a, const std::vector<Error>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].mensaje != b[i].mensaje || a[i].linea != b[i].linea || a[i].columna != b[i].columna ||
+            a[i].tipo != b[i].tipo || a[i].repeticiones != b[i].repeticiones || a[i].lineaFin != b[i].lineaFin ||
+            a[i].columnaFin != b[i].columnaFin) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Mismos símbolos declarados en el mismo orden
+inline bool mismaTabla(const TablaSimbolos& a, const TablaSimbolos& b) {
+    if (a.todos().size() != b.todos().size()) return false;
+    for (size_t i = 0; i < a.todos().size(); ++i) {
+        const Simbolo& x = a.todos()[i];
+        const Simbolo& y = b.todos()[i];
+        if (x.id != y.id || x.tipo != y.tipo || x.lineaDeclaracion != y.lineaDeclaracion || x.valor != y.valor) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace generador
+
+#endif // GENERADOR_H
@@ -0,0 +1,198 @@
+#ifndef BUFFER_TOKENS_H
+#define BUFFER_TOKENS_H
+
+#include "lexer.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Lista de tokens en forma de columnas (struct of arrays): un byte de tipo,
+// el offset y la longitud del valor dentro del buffer fuente y el id
+// internado. Son 13 bytes por token en lugar de los 32 de Token, y
+// recorrer solo los tipos lee un arreglo denso.
+//
+// La línea y la columna no se guardan: se calculan al pedirlas con una
+// búsqueda binaria sobre el índice de inicios de línea. Las pocas
+// posiciones que el lexer reporta distinto de lo que da el byte (después
+// de un comentario /* */ en la misma línea o de una cadena sin cerrar) se
+// guardan aparte al agregar el token, así que posicion() devuelve
+// exactamente lo mismo que tenía el Token original.
+//
+// Al agregar cada token se anota también, en un índice aparte, la posición
+// de los puntos de sincronización de la recuperación de errores del parser
+// (';', '}' y fin_programa), para que saltar al siguiente sea una búsqueda
+// en el índice en lugar de recorrer los tokens de en medio.
+//
+// Los offsets son de 32 bits: el fuente no puede pasar de 4 GiB.
+
+struct PosicionToken {
+    int linea;
+    int columna;
+};
+
+class BufferTokens {
+public:
+    explicit BufferTokens(std::string_view fuente)
+        : fuente(fuente), busqueda(&escaneo::operacionesActivas()) {
+        if (fuente.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("BufferTokens: el fuente supera los 4 GiB");
+        }
+        iniciosLinea.push_back(0);
+    }
+
+    // Construye el buffer a partir de tokens cuyos valores apuntan a fuente
+    static BufferTokens desdeTokens(std::string_view fuente, const std::vector<Token>& tokens) {
+        BufferTokens buffer(fuente);
+        buffer.reservar(tokens.size());
+        for (const auto& token : tokens) buffer.agregar(token);
+        return buffer;
+    }
+
+    void reservar(size_t cantidad) {
+        tipos.reserve(cantidad);
+        offsets.reserve(cantidad);
+        longitudes.reserve(cantidad);
+        simbolos.reserve(cantidad);
+    }
+
+    // Agrega un token producido por el lexer sobre el mismo fuente; los
+    // tokens deben llegar en orden
+    void agregar(const Token& token) {
+        uint32_t offset = static_cast<uint32_t>(token.value.data() - fuente.data());
+        tipos.push_back(static_cast<uint8_t>(token.type));
+        offsets.push_back(offset);
+        longitudes.push_back(static_cast<uint32_t>(token.value.size()));
+        simbolos.push_back(token.simbolo);
+        if (esSincronizacion(token.type)) sincronizaciones.push_back(static_cast<uint32_t>(tipos.size() - 1));
+
+        // Con el índice al día hasta el inicio del token, su línea es la última
+        uint32_t inicio = inicioToken(tipos.size() - 1);
+        indexarLineasHasta(inicio);
+        int linea = static_cast<int>(iniciosLinea.size());
+        int columna = static_cast<int>(inicio - iniciosLinea.back()) + 1;
+        if (linea != token.line || columna != token.column) {
+            excepciones.push_back({static_cast<uint32_t>(tipos.size() - 1), token.line, token.column});
+        }
+    }
+
+    size_t size() const { return tipos.size(); }
+    bool empty() const { return tipos.empty(); }
+
+    TokenType tipo(size_t indice) const { return static_cast<TokenType>(tipos[indice]); }
+    std::string_view valor(size_t indice) const { return fuente.substr(offsets[indice], longitudes[indice]); }
+    uint32_t offset(size_t indice) const { return offsets[indice]; }
+    SimboloId simbolo(size_t indice) const { return simbolos[indice]; }
+
+    // Arreglo denso de tipos, para recorridos que solo miran el tipo
+    const uint8_t* datosTipos() const { return tipos.data(); }
+
+    // Tokens donde se detiene la recuperación de errores del parser
+    static bool esSincronizacion(TokenType tipo) {
+        return tipo == TOKEN_PUNTO_COMA || tipo == TOKEN_LLAVE_DER || tipo == TOKEN_FIN_PROGRAMA;
+    }
+
+    // Índice del primer punto de sincronización en desde o después, o
+    // size() si no queda ninguno
+    size_t siguienteSincronizacion(size_t desde) const {
+        size_t pista = 0;
+        return siguienteSincronizacion(desde, pista);
+    }
+
+    // Igual, buscando desde pista (la posición en el índice que dejó la
+    // búsqueda anterior, que queda actualizada) con pasos que se duplican.
+    // Con errores seguidos desde avanza poco entre una búsqueda y otra y la
+    // respuesta está a uno o dos lugares de pista, sin la búsqueda binaria
+    // sobre todo el índice.
+    size_t siguienteSincronizacion(size_t desde, size_t& pista) const {
+        const size_t cantidad = sincronizaciones.size();
+        if (pista > cantidad || (pista > 0 && sincronizaciones[pista - 1] >= desde)) pista = 0;
+        size_t bajo = pista, alto = pista, paso = 1;
+        while (alto < cantidad && sincronizaciones[alto] < desde) {
+            bajo = alto + 1;
+            alto += paso;
+            paso *= 2;
+        }
+        alto = std::min(alto, cantidad);
+        pista = static_cast<size_t>(
+            std::lower_bound(sincronizaciones.begin() + bajo, sincronizaciones.begin() + alto, desde) -
+            sincronizaciones.begin());
+        return pista == cantidad ? size() : sincronizaciones[pista];
+    }
+
+    PosicionToken posicion(size_t indice) const {
+        auto excepcion = std::lower_bound(excepciones.begin(), excepciones.end(), indice,
+            [](const Excepcion& e, size_t i) { return e.indice < i; });
+        if (excepcion != excepciones.end() && excepcion->indice == indice) {
+            return {excepcion->linea, excepcion->columna};
+        }
+        return posicionPorByte(inicioToken(indice));
+    }
+
+    Token token(size_t indice) const {
+        PosicionToken pos = posicion(indice);
+        return Token{tipo(indice), simbolos[indice], valor(indice), pos.linea, pos.columna};
+    }
+
+    // Memoria ocupada por las columnas y los índices
+    size_t bytesUsados() const {
+        return tipos.capacity() * sizeof(uint8_t) + offsets.capacity() * sizeof(uint32_t) +
+               longitudes.capacity() * sizeof(uint32_t) + simbolos.capacity() * sizeof(SimboloId) +
+               iniciosLinea.capacity() * sizeof(uint32_t) +
+               excepciones.capacity() * sizeof(Excepcion) + sincronizaciones.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    struct Excepcion {
+        uint32_t indice;
+        int linea;
+        int columna;
+    };
+
+    std::string_view fuente;
+    const escaneo::Operaciones* busqueda;
+    std::vector<uint8_t> tipos;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> longitudes;
+    std::vector<SimboloId> simbolos;
+    std::vector<uint32_t> iniciosLinea;  // Offset del primer byte de cada línea
+    size_t indexadoHasta = 0;            // Bytes ya revisados en busca de saltos
+    std::vector<Excepcion> excepciones;  // Ordenadas por índice
+    std::vector<uint32_t> sincronizaciones; // Índices de ';', '}' y fin_programa, en orden
+
+    // Las cadenas empiezan en la comilla, un byte antes de su valor
+    uint32_t inicioToken(size_t indice) const {
+        return offsets[indice] - (tipos[indice] == TOKEN_CADENA_LIT ? 1 : 0);
+    }
+
+    void indexarLineasHasta(size_t limite) {
+        while (indexadoHasta < limite) {
+            size_t salto = busqueda->buscarSalto(fuente.data(), limite, indexadoHasta);
+            if (salto >= limite) break;
+            iniciosLinea.push_back(static_cast<uint32_t>(salto + 1));
+            indexadoHasta = salto + 1;
+        }
+        if (indexadoHasta < limite) indexadoHasta = limite;
+    }
+
+    PosicionToken posicionPorByte(uint32_t inicio) const {
+        size_t linea = static_cast<size_t>(
+            std::upper_bound(iniciosLinea.begin(), iniciosLinea.end(), inicio) - iniciosLinea.begin());
+        return {static_cast<int>(linea), static_cast<int>(inicio - iniciosLinea[linea - 1]) + 1};
+    }
+};
+
+// Analiza todo el buffer y guarda los tokens en columnas
+inline BufferTokens analizarEnBuffer(std::string_view fuente, std::vector<Error>& errores) {
+    BufferTokens buffer(fuente);
+    AnalizadorLexico lexer(fuente, errores);
+    Token token;
+    do {
+        token = lexer.siguiente();
+        buffer.agregar(token);
+    } while (token.type != TOKEN_EOF);
+    return buffer;
+}
+
+#endif // BUFFER_TOKENS_H
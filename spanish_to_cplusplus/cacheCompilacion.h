@@ -0,0 +1,325 @@
+#ifndef CACHE_COMPILACION_H
+#define CACHE_COMPILACION_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// Caché de compilaciones en disco, direccionada por contenido: la clave es
+// un hash de 128 bits de la versión del compilador, las opciones que
+// cambian la salida y los bytes del código fuente. Cada entrada guarda los
+// archivos que dejó la compilación en out/ y lo que escribió en consola,
+// así que repetir una compilación es calcular el hash, enlazar (o copiar)
+// los archivos y volver a escribir la consola.
+//
+//   <directorio>/<clave en hex>/indice        archivos presentes, uno por línea
+//   <directorio>/<clave en hex>/tokens.json   ...
+//   <directorio>/<clave en hex>/consola.txt   lo que la compilación escribió en stdout
+//   <directorio>/<clave en hex>/errores.txt   y en stderr
+//
+// Varios procesos pueden compartir el directorio: una entrada se arma en un
+// directorio temporal y se publica renombrándolo, y para desalojarla se la
+// renombra antes de borrarla, así que nunca se ve una a medias. Si otro
+// proceso la desaloja mientras se restaura, faltan archivos del índice y
+// la restauración falla como si no estuviera.
+//
+// Los archivos restaurados se enlazan con hard links cuando se puede, por
+// eso todo lo que escriba en out/ tiene que borrar antes las salidas
+// anteriores (prepararSalidas): escribir encima de un enlace cambiaría la
+// entrada. main.cpp lo hace en cada corrida, con --cache o sin él.
+//
+// El tamaño total se acota desalojando las entradas usadas hace más
+// tiempo; la fecha de modificación del directorio de cada entrada es su
+// último uso.
+
+// Cambia cuando cambia lo que produce el compilador. La fecha de
+// compilación del ejecutable se suma a la clave para que un compilador
+// recompilado no use entradas de otro.
+constexpr char VERSION_COMPILADOR[] = "stc-1";
+
+struct ClaveCache {
+    uint64_t alto = 0;
+    uint64_t bajo = 0;
+
+    std::string hex() const {
+        static const char digitos[] = "0123456789abcdef";
+        std::string texto(32, '0');
+        for (int i = 0; i < 16; ++i) {
+            texto[15 - i] = digitos[(alto >> (4 * i)) & 0xF];
+            texto[31 - i] = digitos[(bajo >> (4 * i)) & 0xF];
+        }
+        return texto;
+    }
+};
+
+namespace detalle_cache {
+
+inline uint64_t rotar(uint64_t x, int bits) { return (x << bits) | (x >> (64 - bits)); }
+
+// Paso final de MurmurHash3: cada bit de entrada cambia la mitad de la salida
+inline uint64_t mezclar(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    return x ^ (x >> 33);
+}
+
+// Dos carriles de 64 bits que leen 8 bytes por paso con multiplicadores
+// distintos. No resiste entradas hechas a propósito para chocar, pero el
+// directorio lo comparten procesos de confianza (CI, la GUI).
+class Hash128 {
+public:
+    void agregar(std::string_view datos) {
+        const char* p = datos.data();
+        size_t resto = datos.size();
+        total += resto;
+        while (resto >= 8) {
+            uint64_t palabra;
+            std::memcpy(&palabra, p, 8);
+            paso(palabra);
+            p += 8;
+            resto -= 8;
+        }
+        uint64_t cola = 0;
+        std::memcpy(&cola, p, resto);
+        paso(cola ^ (uint64_t(resto) << 56));
+    }
+
+    ClaveCache clave() const {
+        uint64_t x = mezclar(a ^ total);
+        uint64_t y = mezclar(b + total);
+        return {x + y, x ^ rotar(y, 32)};
+    }
+
+private:
+    uint64_t a = 0x9E3779B97F4A7C15ull;
+    uint64_t b = 0xC2B2AE3D27D4EB4Full;
+    uint64_t total = 0;
+
+    void paso(uint64_t palabra) {
+        a = rotar((a ^ palabra) * 0x87C37B91114253D5ull, 31);
+        b = rotar(b + palabra * 0x4CF5AD432745937Full, 27) * 5 + 0x52DCE729;
+    }
+};
+
+inline bool leerArchivo(const std::filesystem::path& ruta, std::string& contenido) {
+    std::ifstream archivo(ruta, std::ios::binary);
+    if (!archivo.is_open()) return false;
+    contenido.assign(std::istreambuf_iterator<char>(archivo), std::istreambuf_iterator<char>());
+    return !archivo.bad();
+}
+
+inline bool escribirArchivo(const std::filesystem::path& ruta, std::string_view contenido) {
+    std::ofstream archivo(ruta, std::ios::binary | std::ios::trunc);
+    archivo.write(contenido.data(), static_cast<std::streamsize>(contenido.size()));
+    archivo.close();
+    return static_cast<bool>(archivo);
+}
+
+// Nombre de directorio temporal que no choca con el de otro proceso
+inline std::string nombreTemporal(const char* prefijo) {
+    static std::mt19937_64 generador{std::random_device{}() ^ static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count())};
+    ClaveCache aleatoria{generador(), generador()};
+    return prefijo + aleatoria.hex();
+}
+
+inline bool esClave(const std::string& nombre) {
+    return nombre.size() == 32 && std::all_of(nombre.begin(), nombre.end(), [](char c) {
+               return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+           });
+}
+
+} // namespace detalle_cache
+
+// Copia en un texto todo lo que pasa por un flujo (std::cout, std::cerr)
+// sin dejar de escribirlo en su destino, mientras el objeto vive
+class CapturaSalida : public std::streambuf {
+public:
+    explicit CapturaSalida(std::ostream& flujo) : flujo(flujo), original(flujo.rdbuf(this)) {}
+    ~CapturaSalida() override { flujo.rdbuf(original); }
+    CapturaSalida(const CapturaSalida&) = delete;
+    CapturaSalida& operator=(const CapturaSalida&) = delete;
+
+    const std::string& texto() const { return capturado; }
+
+protected:
+    int overflow(int c) override {
+        if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+        capturado.push_back(traits_type::to_char_type(c));
+        return original->sputc(traits_type::to_char_type(c));
+    }
+
+    std::streamsize xsputn(const char* datos, std::streamsize cantidad) override {
+        capturado.append(datos, static_cast<size_t>(cantidad));
+        return original->sputn(datos, cantidad);
+    }
+
+    int sync() override { return original->pubsync(); }
+
+private:
+    std::ostream& flujo;
+    std::streambuf* original;
+    std::string capturado;
+};
+
+class CacheCompilacion {
+public:
+    // Archivos que la compilación deja en out/; cada uno puede faltar
+    static constexpr const char* SALIDAS[] = {"tokens.json", "ast.json", "ast.bin", "errores.json", "salida.cpp"};
+
+    CacheCompilacion(std::filesystem::path directorio, uint64_t maxBytes)
+        : directorio(std::move(directorio)), maxBytes(maxBytes) {}
+
+    // opciones: las de la línea de comandos que cambian la salida
+    static ClaveCache calcularClave(std::string_view fuente, std::string_view opciones) {
+        detalle_cache::Hash128 hash;
+        hash.agregar(VERSION_COMPILADOR);
+        hash.agregar(__DATE__ " " __TIME__);
+        hash.agregar(opciones);
+        hash.agregar(fuente);
+        return hash.clave();
+    }
+
+    // Deja en salida los archivos de la entrada (y borra los que la
+    // compilación no había producido) y devuelve la consola guardada. Si
+    // la entrada no está o no se pudo restaurar entera, devuelve false.
+    bool restaurar(const ClaveCache& clave, const std::filesystem::path& salida, std::string& consola,
+                   std::string& errores) const {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::path entrada = directorio / clave.hex();
+        std::string indice;
+        if (!detalle_cache::leerArchivo(entrada / "indice", indice)) return false;
+        if (!detalle_cache::leerArchivo(entrada / "consola.txt", consola) ||
+            !detalle_cache::leerArchivo(entrada / "errores.txt", errores)) {
+            return false;
+        }
+
+        fs::create_directories(salida, ec);
+        for (const char* nombre : SALIDAS) {
+            fs::path destino = salida / nombre;
+            fs::remove(destino, ec);
+            if (!enIndice(indice, nombre)) continue;
+            fs::create_hard_link(entrada / nombre, destino, ec);
+            if (ec && !fs::copy_file(entrada / nombre, destino, ec)) return false;
+        }
+
+        // Usada ahora: la última en desalojarse
+        fs::last_write_time(entrada, fs::file_time_type::clock::now(), ec);
+        return true;
+    }
+
+    // Borra las salidas de una compilación anterior antes de compilar, con o
+    // sin caché: así no se escribe dentro de archivos enlazados a una
+    // entrada y al guardar solo están los archivos de esta compilación
+    static void prepararSalidas(const std::filesystem::path& salida) {
+        std::error_code ec;
+        for (const char* nombre : SALIDAS) std::filesystem::remove(salida / nombre, ec);
+    }
+
+    // Guarda los archivos de salida presentes y la consola. Si otro proceso
+    // ya publicó la misma clave, se queda la suya.
+    bool guardar(const ClaveCache& clave, const std::filesystem::path& salida, std::string_view consola,
+                 std::string_view errores) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::create_directories(directorio, ec);
+        fs::path temporal = directorio / detalle_cache::nombreTemporal("tmp-");
+        if (!fs::create_directory(temporal, ec)) return false;
+
+        std::string indice;
+        bool completa = true;
+        for (const char* nombre : SALIDAS) {
+            if (!fs::exists(salida / nombre, ec)) continue;
+            completa = completa && fs::copy_file(salida / nombre, temporal / nombre, ec);
+            indice += nombre;
+            indice += '\n';
+        }
+        completa = completa && detalle_cache::escribirArchivo(temporal / "consola.txt", consola) &&
+                   detalle_cache::escribirArchivo(temporal / "errores.txt", errores) &&
+                   detalle_cache::escribirArchivo(temporal / "indice", indice);
+
+        if (completa) {
+            fs::rename(temporal, directorio / clave.hex(), ec);
+            completa = !ec;
+        }
+        if (!completa) fs::remove_all(temporal, ec);
+        recortar();
+        return completa;
+    }
+
+    // Desaloja las entradas usadas hace más tiempo hasta que el total entre
+    // en maxBytes, y los temporales de procesos que murieron a medias
+    void recortar() {
+        namespace fs = std::filesystem;
+        struct Entrada {
+            fs::path ruta;
+            fs::file_time_type uso;
+            uint64_t bytes;
+        };
+        std::vector<Entrada> entradas;
+        uint64_t total = 0;
+        std::error_code ec;
+        auto ahora = fs::file_time_type::clock::now();
+        for (const fs::directory_entry& item : fs::directory_iterator(directorio, ec)) {
+            std::string nombre = item.path().filename().string();
+            fs::file_time_type uso = fs::last_write_time(item.path(), ec);
+            if (ec) continue;
+            if (!detalle_cache::esClave(nombre)) {
+                if (nombre.compare(0, 4, "tmp-") == 0 && ahora - uso > std::chrono::hours(1)) {
+                    fs::remove_all(item.path(), ec);
+                }
+                continue;
+            }
+            uint64_t bytes = 0;
+            for (const fs::directory_entry& archivo : fs::directory_iterator(item.path(), ec)) {
+                uintmax_t tam = archivo.file_size(ec);
+                if (!ec) bytes += tam;
+            }
+            entradas.push_back({item.path(), uso, bytes});
+            total += bytes;
+        }
+        if (total <= maxBytes) return;
+
+        std::sort(entradas.begin(), entradas.end(),
+                  [](const Entrada& a, const Entrada& b) { return a.uso < b.uso; });
+        for (const Entrada& entrada : entradas) {
+            if (total <= maxBytes) break;
+            total -= entrada.bytes;
+            // Renombrar primero: si otro proceso ya la desalojó, falla y se sigue
+            fs::path desalojada = directorio / detalle_cache::nombreTemporal("tmp-");
+            fs::rename(entrada.ruta, desalojada, ec);
+            if (!ec) fs::remove_all(desalojada, ec);
+        }
+    }
+
+private:
+    std::filesystem::path directorio;
+    uint64_t maxBytes;
+
+    static bool enIndice(const std::string& indice, std::string_view nombre) {
+        size_t inicio = 0;
+        while (inicio < indice.size()) {
+            size_t fin = indice.find('\n', inicio);
+            if (fin == std::string::npos) fin = indice.size();
+            if (std::string_view(indice).substr(inicio, fin - inicio) == nombre) return true;
+            inicio = fin + 1;
+        }
+        return false;
+    }
+};
+
+#endif // CACHE_COMPILACION_H
@@ -0,0 +1,122 @@
+#ifndef CADENAS_H
+#define CADENAS_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Internado de identificadores: cada texto distinto recibe un SimboloId de
+// 32 bits, estable mientras viva la tabla. El lexer interna los
+// identificadores al escanearlos, y tokens, nodos del AST y TablaSimbolos
+// guardan solo el id, así que comparar dos nombres es comparar enteros y
+// buscar un símbolo es buscar un entero.
+//
+// Una TablaCadenas no es segura entre hilos: el lexer paralelo usa una
+// tabla por fragmento y traduce los ids a la global al unir.
+
+using SimboloId = uint32_t;
+constexpr SimboloId SIN_SIMBOLO = 0xFFFFFFFFu;
+
+class TablaCadenas {
+public:
+    TablaCadenas() : celdas(TAM_INICIAL, SIN_SIMBOLO) {}
+
+    TablaCadenas(const TablaCadenas&) = delete;
+    TablaCadenas& operator=(const TablaCadenas&) = delete;
+    TablaCadenas(TablaCadenas&&) = default;
+    TablaCadenas& operator=(TablaCadenas&&) = default;
+
+    // Id del texto, agregándolo si es nuevo
+    SimboloId internar(std::string_view texto) {
+        uint32_t h = hash(texto);
+        size_t mascara = celdas.size() - 1;
+        for (size_t i = h & mascara;; i = (i + 1) & mascara) {
+            SimboloId id = celdas[i];
+            if (id == SIN_SIMBOLO) break;
+            if (hashes[id] == h && textos[id] == texto) return id;
+        }
+
+        SimboloId id = static_cast<SimboloId>(textos.size());
+        textos.push_back(copiar(texto));
+        hashes.push_back(h);
+        if (textos.size() * 2 > celdas.size()) {
+            redimensionar(celdas.size() * 2);
+        } else {
+            colocar(id);
+        }
+        return id;
+    }
+
+    // Id del texto, o SIN_SIMBOLO si nunca se internó
+    SimboloId buscar(std::string_view texto) const {
+        uint32_t h = hash(texto);
+        size_t mascara = celdas.size() - 1;
+        for (size_t i = h & mascara;; i = (i + 1) & mascara) {
+            SimboloId id = celdas[i];
+            if (id == SIN_SIMBOLO) return SIN_SIMBOLO;
+            if (hashes[id] == h && textos[id] == texto) return id;
+        }
+    }
+
+    std::string_view texto(SimboloId id) const { return textos[id]; }
+    size_t size() const { return textos.size(); }
+
+private:
+    static constexpr size_t TAM_INICIAL = 256;       // Potencia de dos
+    static constexpr size_t TAM_BLOQUE = 64 * 1024;  // Bytes por bloque de texto
+
+    std::vector<SimboloId> celdas;       // Direccionamiento abierto, sondeo lineal
+    std::vector<std::string_view> textos; // Por id; apuntan a los bloques
+    std::vector<uint32_t> hashes;         // Por id, para no recalcularlos al crecer
+    std::vector<std::unique_ptr<char[]>> bloques;
+    size_t usadoEnBloque = 0;
+    size_t libreEnBloque = 0;
+
+    // FNV-1a: los identificadores son cortos (32 caracteres como máximo)
+    static uint32_t hash(std::string_view texto) {
+        uint32_t h = 2166136261u;
+        for (char c : texto) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // Los textos se copian a bloques propios para no depender del buffer fuente
+    std::string_view copiar(std::string_view texto) {
+        if (texto.empty()) return std::string_view();
+        if (texto.size() > libreEnBloque) {
+            size_t tam = texto.size() > TAM_BLOQUE ? texto.size() : TAM_BLOQUE;
+            bloques.emplace_back(new char[tam]);
+            libreEnBloque = tam;
+            usadoEnBloque = 0;
+        }
+        char* destino = bloques.back().get() + usadoEnBloque;
+        std::memcpy(destino, texto.data(), texto.size());
+        usadoEnBloque += texto.size();
+        libreEnBloque -= texto.size();
+        return std::string_view(destino, texto.size());
+    }
+
+    void colocar(SimboloId id) {
+        size_t mascara = celdas.size() - 1;
+        size_t i = hashes[id] & mascara;
+        while (celdas[i] != SIN_SIMBOLO) i = (i + 1) & mascara;
+        celdas[i] = id;
+    }
+
+    void redimensionar(size_t tam) {
+        celdas.assign(tam, SIN_SIMBOLO);
+        for (SimboloId id = 0; id < textos.size(); ++id) colocar(id);
+    }
+};
+
+// Tabla compartida por el lexer, el parser y la tabla de símbolos
+inline TablaCadenas& cadenasGlobales() {
+    static TablaCadenas tabla;
+    return tabla;
+}
+
+#endif // CADENAS_H
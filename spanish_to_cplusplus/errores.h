@@ -5,14 +5,69 @@
 #include <string>
 #include <iomanip>
 #include <iostream>
+#include <cstddef>
 
 struct Error {
     std::string mensaje;
     int linea;
     int columna;
     std::string tipo; // "Léxico", "Sintáctico" o "Semántico"
+    // Diagnóstico agrupado: el lexer junta una racha de errores idénticos
+    // seguidos (sin tokens entre ellos) en uno solo, desde linea:columna
+    // hasta lineaFin:columnaFin
+    int repeticiones = 1;
+    int lineaFin = 0;
+    int columnaFin = 0;
 };
 
+// Límite de errores compartido por el lexer y el parser (--max-errors).
+// Al alcanzarse, el lexer deja de escanear y entrega el fin de archivo, y
+// el parser deja de registrar errores y termina. Con agrupar, las rachas
+// de errores léxicos idénticos cuentan como un solo error.
+class LimiteErrores {
+public:
+    explicit LimiteErrores(size_t maximo = 0, bool agrupar = true) // 0 = sin máximo
+        : maximo(maximo), agruparRepetidos(agrupar) {}
+
+    bool agrupar() const { return agruparRepetidos; }
+    bool agotado() const { return maximo != 0 && usados >= maximo; }
+    size_t limite() const { return maximo; }
+    size_t registrados() const { return usados; }
+
+    // Cuenta un error nuevo; devuelve false si ya no cabía
+    bool registrar() {
+        if (agotado()) return false;
+        ++usados;
+        return true;
+    }
+
+    void reiniciar(size_t cantidad = 0) { usados = cantidad; }
+
+private:
+    size_t maximo;
+    bool agruparRepetidos;
+    size_t usados = 0;
+};
+
+// Mismo diagnóstico, para agrupar rachas
+inline bool mismoError(const Error& a, const Error& b) {
+    return a.mensaje == b.mensaje && a.tipo == b.tipo;
+}
+
+// Extiende el diagnóstico agrupado a con la racha b, que lo sigue
+inline void extenderError(Error& a, const Error& b) {
+    a.repeticiones += b.repeticiones;
+    a.lineaFin = b.repeticiones > 1 ? b.lineaFin : b.linea;
+    a.columnaFin = b.repeticiones > 1 ? b.columnaFin : b.columna;
+}
+
+// Texto del mensaje para mostrar, con el rango si el error está agrupado
+inline std::string describirError(const Error& error) {
+    if (error.repeticiones <= 1) return error.mensaje;
+    return error.mensaje + " (x" + std::to_string(error.repeticiones) + ", hasta " +
+           std::to_string(error.lineaFin) + ":" + std::to_string(error.columnaFin) + ")";
+}
+
 inline void imprimirErrores(const std::vector<Error>& errores) {
     if (errores.empty()) return;
 
@@ -27,7 +82,7 @@ inline void imprimirErrores(const std::vector<Error>& errores) {
         std::cout << "\033[0m| " << std::setw(6) << error.linea
                   << " | " << std::setw(6) << error.columna
                   << " | " << std::setw(12) << error.tipo
-                  << " | " << std::setw(37) << error.mensaje << " |\n";
+                  << " | " << std::setw(37) << describirError(error) << " |\n";
     }
     
     std::cout << "\033[1;31m+--------+--------+--------------+---------------------------------------+\033[0m\n"; // Borde inferior en rojo
@@ -0,0 +1,229 @@
+#ifndef ESCANEO_H
+#define ESCANEO_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Rutinas de búsqueda usadas por el lexer para saltar espacios y
+// comentarios varios bytes a la vez. Hay tres implementaciones (AVX2,
+// SSE2 y escalar); la mejor disponible se elige una sola vez en tiempo
+// de ejecución. Los espacios se clasifican como std::isspace en el
+// locale "C", que es en el que corre el compilador.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STC_ESCANEO_X86 1
+#include <immintrin.h>
+#endif
+
+namespace escaneo {
+
+enum class Nivel {
+    ESCALAR,
+    SSE2,
+    AVX2
+};
+
+struct Operaciones {
+    // Primer índice >= desde que no es espacio en blanco (o n)
+    size_t (*finEspacios)(const char* datos, size_t n, size_t desde);
+    // Primer '\n' a partir de desde (o n)
+    size_t (*buscarSalto)(const char* datos, size_t n, size_t desde);
+    // Primer índice i >= desde con "*/" en i (o n)
+    size_t (*buscarCierreComentario)(const char* datos, size_t n, size_t desde);
+    // Cantidad de '\n' en [desde, hasta); ultimo recibe el índice del último
+    size_t (*contarSaltos)(const char* datos, size_t desde, size_t hasta, size_t& ultimo);
+};
+
+//--------------------------------------------------
+// Implementación escalar (también resuelve las colas de las vectoriales)
+//--------------------------------------------------
+inline bool esEspacio(char c) {
+    return c == ' ' || (static_cast<unsigned char>(c) - 9u) <= 4u; // \t \n \v \f \r
+}
+
+inline size_t finEspaciosEscalar(const char* datos, size_t n, size_t desde) {
+    while (desde < n && esEspacio(datos[desde])) desde++;
+    return desde;
+}
+
+inline size_t buscarSaltoEscalar(const char* datos, size_t n, size_t desde) {
+    while (desde < n && datos[desde] != '\n') desde++;
+    return desde;
+}
+
+inline size_t buscarCierreComentarioEscalar(const char* datos, size_t n, size_t desde) {
+    for (; desde + 1 < n; ++desde) {
+        if (datos[desde] == '*' && datos[desde + 1] == '/') return desde;
+    }
+    return n;
+}
+
+inline size_t contarSaltosEscalar(const char* datos, size_t desde, size_t hasta, size_t& ultimo) {
+    size_t total = 0;
+    for (size_t i = desde; i < hasta; ++i) {
+        if (datos[i] == '\n') {
+            total++;
+            ultimo = i;
+        }
+    }
+    return total;
+}
+
+#ifdef STC_ESCANEO_X86
+//--------------------------------------------------
+// SSE2: 16 bytes por iteración
+//--------------------------------------------------
+__attribute__((target("sse2")))
+inline __m128i mascaraEspaciosSse2(__m128i v) {
+    __m128i esp = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i t = _mm_sub_epi8(v, _mm_set1_epi8(9));
+    __m128i ctl = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(4)), t);
+    return _mm_or_si128(esp, ctl);
+}
+
+__attribute__((target("sse2")))
+inline size_t finEspaciosSse2(const char* datos, size_t n, size_t desde) {
+    for (; desde + 16 <= n; desde += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + desde));
+        unsigned mascara = static_cast<unsigned>(_mm_movemask_epi8(mascaraEspaciosSse2(v)));
+        if (mascara != 0xFFFFu) return desde + __builtin_ctz(~mascara);
+    }
+    return finEspaciosEscalar(datos, n, desde);
+}
+
+__attribute__((target("sse2")))
+inline size_t buscarSaltoSse2(const char* datos, size_t n, size_t desde) {
+    const __m128i salto = _mm_set1_epi8('\n');
+    for (; desde + 16 <= n; desde += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + desde));
+        unsigned mascara = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, salto)));
+        if (mascara) return desde + __builtin_ctz(mascara);
+    }
+    return buscarSaltoEscalar(datos, n, desde);
+}
+
+__attribute__((target("sse2")))
+inline size_t buscarCierreComentarioSse2(const char* datos, size_t n, size_t desde) {
+    const __m128i asterisco = _mm_set1_epi8('*');
+    const __m128i barra = _mm_set1_epi8('/');
+    for (; desde + 17 <= n; desde += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + desde));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + desde + 1));
+        unsigned mascara = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, asterisco), _mm_cmpeq_epi8(b, barra))));
+        if (mascara) return desde + __builtin_ctz(mascara);
+    }
+    return buscarCierreComentarioEscalar(datos, n, desde);
+}
+
+__attribute__((target("sse2")))
+inline size_t contarSaltosSse2(const char* datos, size_t desde, size_t hasta, size_t& ultimo) {
+    const __m128i salto = _mm_set1_epi8('\n');
+    size_t total = 0;
+    for (; desde + 16 <= hasta; desde += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + desde));
+        unsigned mascara = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, salto)));
+        if (mascara) {
+            total += __builtin_popcount(mascara);
+            ultimo = desde + 31 - __builtin_clz(mascara);
+        }
+    }
+    return total + contarSaltosEscalar(datos, desde, hasta, ultimo);
+}
+
+//--------------------------------------------------
+// AVX2: 32 bytes por iteración
+//--------------------------------------------------
+__attribute__((target("avx2")))
+inline size_t finEspaciosAvx2(const char* datos, size_t n, size_t desde) {
+    const __m256i espacio = _mm256_set1_epi8(' ');
+    const __m256i nueve = _mm256_set1_epi8(9);
+    const __m256i cuatro = _mm256_set1_epi8(4);
+    for (; desde + 32 <= n; desde += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + desde));
+        __m256i t = _mm256_sub_epi8(v, nueve);
+        __m256i es = _mm256_or_si256(_mm256_cmpeq_epi8(v, espacio),
+                                     _mm256_cmpeq_epi8(_mm256_min_epu8(t, cuatro), t));
+        uint32_t mascara = static_cast<uint32_t>(_mm256_movemask_epi8(es));
+        if (mascara != 0xFFFFFFFFu) return desde + __builtin_ctz(~mascara);
+    }
+    return finEspaciosSse2(datos, n, desde);
+}
+
+__attribute__((target("avx2")))
+inline size_t buscarSaltoAvx2(const char* datos, size_t n, size_t desde) {
+    const __m256i salto = _mm256_set1_epi8('\n');
+    for (; desde + 32 <= n; desde += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + desde));
+        uint32_t mascara = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, salto)));
+        if (mascara) return desde + __builtin_ctz(mascara);
+    }
+    return buscarSaltoSse2(datos, n, desde);
+}
+
+__attribute__((target("avx2")))
+inline size_t buscarCierreComentarioAvx2(const char* datos, size_t n, size_t desde) {
+    const __m256i asterisco = _mm256_set1_epi8('*');
+    const __m256i barra = _mm256_set1_epi8('/');
+    for (; desde + 33 <= n; desde += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + desde));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + desde + 1));
+        uint32_t mascara = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, asterisco), _mm256_cmpeq_epi8(b, barra))));
+        if (mascara) return desde + __builtin_ctz(mascara);
+    }
+    return buscarCierreComentarioSse2(datos, n, desde);
+}
+
+__attribute__((target("avx2")))
+inline size_t contarSaltosAvx2(const char* datos, size_t desde, size_t hasta, size_t& ultimo) {
+    const __m256i salto = _mm256_set1_epi8('\n');
+    size_t total = 0;
+    for (; desde + 32 <= hasta; desde += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + desde));
+        uint32_t mascara = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, salto)));
+        if (mascara) {
+            total += __builtin_popcount(mascara);
+            ultimo = desde + 31 - __builtin_clz(mascara);
+        }
+    }
+    return total + contarSaltosSse2(datos, desde, hasta, ultimo);
+}
+#endif // STC_ESCANEO_X86
+
+inline Operaciones operacionesPara(Nivel nivel) {
+#ifdef STC_ESCANEO_X86
+    if (nivel == Nivel::AVX2) {
+        return {finEspaciosAvx2, buscarSaltoAvx2, buscarCierreComentarioAvx2, contarSaltosAvx2};
+    }
+    if (nivel == Nivel::SSE2) {
+        return {finEspaciosSse2, buscarSaltoSse2, buscarCierreComentarioSse2, contarSaltosSse2};
+    }
+#endif
+    (void)nivel;
+    return {finEspaciosEscalar, buscarSaltoEscalar, buscarCierreComentarioEscalar, contarSaltosEscalar};
+}
+
+// Mejor nivel soportado por el procesador actual
+inline Nivel detectarNivel() {
+#ifdef STC_ESCANEO_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Nivel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Nivel::SSE2;
+#endif
+    return Nivel::ESCALAR;
+}
+
+inline Operaciones& operacionesActivas() {
+    static Operaciones activas = operacionesPara(detectarNivel());
+    return activas;
+}
+
+// Permite fijar la implementación (pruebas y benchmarks)
+inline void forzarNivel(Nivel nivel) {
+    operacionesActivas() = operacionesPara(nivel);
+}
+
+} // namespace escaneo
+
+#endif // ESCANEO_H
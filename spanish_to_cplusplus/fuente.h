@@ -0,0 +1,120 @@
+#ifndef FUENTE_H
+#define FUENTE_H
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define STC_FUENTE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Buffer contiguo y de solo lectura con el código fuente a compilar.
+// En sistemas POSIX el archivo se mapea en memoria (mmap); en el resto
+// se lee completo a memoria con un std::ifstream en modo texto, igual
+// que lo hacía el lexer original.
+class CodigoFuente {
+private:
+    std::string contenido;          // Usado cuando el texto vive en memoria
+    const char* mapa = nullptr;     // Usado cuando el archivo está mapeado
+    size_t tamanoMapa = 0;
+    bool abierto = false;
+
+    void liberar() {
+#ifdef STC_FUENTE_MMAP
+        if (mapa) munmap(const_cast<char*>(mapa), tamanoMapa);
+#endif
+        mapa = nullptr;
+        tamanoMapa = 0;
+    }
+
+public:
+    CodigoFuente() = default;
+    CodigoFuente(const CodigoFuente&) = delete;
+    CodigoFuente& operator=(const CodigoFuente&) = delete;
+
+    CodigoFuente(CodigoFuente&& otro) noexcept
+        : contenido(std::move(otro.contenido)), mapa(otro.mapa),
+          tamanoMapa(otro.tamanoMapa), abierto(otro.abierto) {
+        otro.mapa = nullptr;
+        otro.tamanoMapa = 0;
+        otro.abierto = false;
+    }
+
+    CodigoFuente& operator=(CodigoFuente&& otro) noexcept {
+        if (this != &otro) {
+            liberar();
+            contenido = std::move(otro.contenido);
+            mapa = otro.mapa;
+            tamanoMapa = otro.tamanoMapa;
+            abierto = otro.abierto;
+            otro.mapa = nullptr;
+            otro.tamanoMapa = 0;
+            otro.abierto = false;
+        }
+        return *this;
+    }
+
+    ~CodigoFuente() { liberar(); }
+
+    // Abre un archivo del disco, mapeándolo en memoria cuando es posible;
+    // modo solo se usa en la lectura tradicional
+    static CodigoFuente desdeArchivo(const std::string& ruta, std::ios::openmode modo = std::ios::in) {
+        CodigoFuente fuente;
+#ifdef STC_FUENTE_MMAP
+        int fd = open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) return fuente;
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+            fuente.abierto = true;
+            if (info.st_size > 0) {
+                void* p = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                    fuente.mapa = static_cast<const char*>(p);
+                    fuente.tamanoMapa = static_cast<size_t>(info.st_size);
+                } else {
+                    fuente.abierto = false;
+                }
+            }
+        }
+        close(fd);
+        if (fuente.abierto) return fuente;
+#endif
+        // Sin mmap (o no es un archivo regular): lectura tradicional
+        std::ifstream archivo(ruta, modo);
+        if (!archivo.is_open()) return fuente;
+        return desdeFlujo(archivo);
+    }
+
+    // Lee el resto de un flujo ya abierto
+    static CodigoFuente desdeFlujo(std::istream& flujo) {
+        CodigoFuente fuente;
+        fuente.contenido.assign(std::istreambuf_iterator<char>(flujo), std::istreambuf_iterator<char>());
+        fuente.abierto = true;
+        return fuente;
+    }
+
+    // Usa un texto que ya está en memoria
+    static CodigoFuente desdeTexto(std::string texto) {
+        CodigoFuente fuente;
+        fuente.contenido = std::move(texto);
+        fuente.abierto = true;
+        return fuente;
+    }
+
+    bool estaAbierto() const { return abierto; }
+
+    std::string_view texto() const {
+        return mapa ? std::string_view(mapa, tamanoMapa) : std::string_view(contenido);
+    }
+};
+
+#endif // FUENTE_H
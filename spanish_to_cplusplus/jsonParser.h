@@ -3,6 +3,7 @@
 
 #include "simbolos.h"
 #include "errores.h"
+#include "lexer.h"
 
 #include <nlohmann/json.hpp>
 #include <fstream>
@@ -32,6 +33,12 @@ public:
                 {"linea", error.linea},
                 {"columna", error.columna},
                 {"tipo", error.tipo}};
+            if (error.repeticiones > 1)
+            {
+                entrada["repeticiones"] = error.repeticiones;
+                entrada["lineaFin"] = error.lineaFin;
+                entrada["columnaFin"] = error.columnaFin;
+            }
             resultado["tablaErrores"].push_back(entrada);
         }
 
@@ -39,7 +46,8 @@ public:
         std::ofstream archivo(archivoSalida);
         if (archivo.is_open())
         {
-            archivo << resultado.dump(4);
+            // Los mensajes pueden traer bytes que no son UTF-8 (entrada binaria)
+            archivo << resultado.dump(4, ' ', false, json::error_handler_t::replace);
             std::cout << "\nJSON generado: " << archivoSalida << std::endl;
         }
         else
@@ -52,9 +60,9 @@ public:
         json resultado;
 
         // Serializar tabla de símbolos
-        for (const auto& [nombre, simbolo] : symbols.simbolos) {
+        for (const auto& simbolo : symbols.todos()) {
             json entrada = {
-                {"nombre", nombre},
+                {"nombre", std::string(simbolo.nombre())},
                 {"tipo", tipoDatoToString(simbolo.tipo)},
                 {"linea", simbolo.lineaDeclaracion},
                 {"valor", simbolo.valor}};
@@ -91,7 +99,8 @@ public:
         std::ofstream archivo(archivoSalida);
         if (archivo.is_open())
         {
-            archivo << resultado.dump(4);
+            // Los tokens de cadena pueden traer bytes que no son UTF-8 (entrada binaria)
+            archivo << resultado.dump(4, ' ', false, json::error_handler_t::replace);
             std::cout << "\nJSON generado: " << archivoSalida << std::endl;
         }
         else
@@ -100,4 +109,69 @@ public:
         }
     };
 };
+
+// Escribe tokens.json a medida que llegan los tokens, con el mismo formato
+// que generarJsonTokens (dump con indentación de 4), sin construir el
+// documento completo en memoria.
+class EscritorJsonTokens
+{
+public:
+    explicit EscritorJsonTokens(const std::string &archivoSalida = "tokens.json")
+        : ruta(archivoSalida), archivo(archivoSalida) {}
+
+    void agregar(const Token &token)
+    {
+        if (!archivo.is_open())
+            return;
+
+        archivo << (primero ? "{\n    \"tablaTokens\": [\n" : ",\n");
+        primero = false;
+        archivo << "        {\n"
+                << "            \"columna\": " << token.column << ",\n"
+                << "            \"linea\": " << token.line << ",\n"
+                << "            \"tipo\": \"" << tokenTypeToString(token.type) << "\",\n"
+                << "            \"token\": ";
+        escribirCadena(token.value);
+        archivo << "\n        }";
+    }
+
+    void cerrar()
+    {
+        if (!archivo.is_open())
+        {
+            std::cerr << "Error generando archivo JSON: " + ruta << std::endl;
+            return;
+        }
+        archivo << (primero ? "null" : "\n    ]\n}");
+        archivo.close();
+        std::cout << "\nJSON generado: " << ruta << std::endl;
+    }
+
+private:
+    std::string ruta;
+    std::ofstream archivo;
+    bool primero = true;
+
+    void escribirCadena(std::string_view valor)
+    {
+        bool simple = true;
+        for (unsigned char c : valor)
+        {
+            if (c < 0x20 || c >= 0x7F || c == '"' || c == '\\')
+            {
+                simple = false;
+                break;
+            }
+        }
+        if (simple)
+        {
+            archivo << '"' << valor << '"';
+            return;
+        }
+        // Escapes o UTF-8: se delega en nlohmann para escribir exactamente lo
+        // mismo. Los bytes que no son UTF-8 (entrada binaria) se reemplazan
+        // por U+FFFD, como en errores.json, en vez de abortar la compilación
+        archivo << json(std::string(valor)).dump(-1, ' ', false, json::error_handler_t::replace);
+    }
+};
 #endif // JSON_H
\ No newline at end of file
@@ -1,373 +1,635 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include "cadenas.h"
 #include "errores.h"
+#include "escaneo.h"
+#include "fuente.h"
+#include <array>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cctype>
-#include <map>
+#include <iterator>
+
+// Tabla única de tokens: X(enumerador, palabra reservada).
+// La palabra es "" para los tokens que no son palabras reservadas.
+// De aquí se generan el enum TokenType, los nombres de tokenTypeToString
+// y el clasificador de palabras reservadas, así que agregar una palabra
+// reservada es agregar una sola línea.
+#define STC_TOKENS(X) \
+    /* Palabras reservadas */ \
+    X(TOKEN_INCLUIR, "incluir") /* Incluir librerias */ \
+    X(TOKEN_PROGRAMA, "programa") /* Gestión de bloques */ \
+    X(TOKEN_FIN_PROGRAMA, "fin_programa") \
+    X(TOKEN_CONFIGURAR, "configurar") \
+    X(TOKEN_FIN_CONFIGURAR, "fin_configurar") \
+    X(TOKEN_BUCLE_PRINCIPAL, "bucle_principal") \
+    X(TOKEN_FIN_BUCLE, "fin_bucle") \
+    X(TOKEN_SI, "si") /* Estructura de desición */ \
+    X(TOKEN_ENTONCES, "entonces") \
+    X(TOKEN_SINO, "sino") \
+    X(TOKEN_FIN_SI, "fin_si") \
+    X(TOKEN_PARA, "para") /* Bucle for */ \
+    X(TOKEN_DESDE, "desde") \
+    X(TOKEN_HASTA, "hasta") \
+    X(TOKEN_HACER, "hacer") \
+    X(TOKEN_FIN_PARA, "fin_para") \
+    X(TOKEN_MIENTRAS, "mientras") /* Bucle while */ \
+    X(TOKEN_FIN_MIENTRAS, "fin_mientras") \
+    X(TOKEN_REPETIR, "repetir") /* Bucle do while */ \
+    X(TOKEN_VECES, "veces") \
+    X(TOKEN_FUNCION, "funcion") /* Funciones */ \
+    X(TOKEN_FIN_FUNCION, "fin_funcion") \
+    X(TOKEN_RETORNAR, "retornar") \
+    /* Tipos de datos */ \
+    X(TOKEN_ENTERO, "entero") \
+    X(TOKEN_FLOTANTE, "decimal") \
+    X(TOKEN_CADENA, "cadena") \
+    X(TOKEN_BOOLEANO, "booleano") \
+    X(TOKEN_VERDADERO, "verdadero") /* valor booleano 1 */ \
+    X(TOKEN_FALSO, "falso") /* valor booleano 0 */ \
+    /* Literales e identificadores */ \
+    X(TOKEN_IDENTIFICADOR, "") \
+    X(TOKEN_NUMERO_LIT, "") /* tipo entero */ \
+    X(TOKEN_DECIMAL_LIT, "") /* tipo flotante */ \
+    X(TOKEN_CADENA_LIT, "") \
+    X(TOKEN_CONFIGURAR_PIN, "configurar_pin") /* Para controlar la tarjeta Arduino */ \
+    X(TOKEN_ESCRIBIR, "escribir") \
+    X(TOKEN_ESPERAR, "esperar") \
+    /* Símbolos y operadores */ \
+    X(TOKEN_PARENTESIS_IZQ, "") \
+    X(TOKEN_PARENTESIS_DER, "") \
+    X(TOKEN_LLAVE_IZQ, "") \
+    X(TOKEN_LLAVE_DER, "") \
+    X(TOKEN_COMA, "") \
+    X(TOKEN_ASIGNACION, "") \
+    X(TOKEN_IGUALDAD, "") \
+    X(TOKEN_DESIGUALDAD, "") \
+    X(TOKEN_MAYOR_QUE, "") \
+    X(TOKEN_MAYOR_IGUAL, "") \
+    X(TOKEN_MENOR_QUE, "") \
+    X(TOKEN_MENOR_IGUAL, "") \
+    X(TOKEN_MAS, "") \
+    X(TOKEN_MENOS, "") \
+    X(TOKEN_DIV, "") \
+    X(TOKEN_MULT, "") \
+    X(TOKEN_PUNTO_COMA, "") \
+    X(TOKEN_EOF, "") /* END OF FILE (fin de archivo) */ \
+    X(TOKEN_DESCONOCIDO, "") /* Para errores */
 
 // Enumeración de tipos de tokens
 enum TokenType {
-    // Palabras reservadas
-    TOKEN_INCLUIR, // Incluir librerias
-    TOKEN_PROGRAMA, // Gestión de bloques
-    TOKEN_FIN_PROGRAMA,
-    TOKEN_CONFIGURAR,
-    TOKEN_FIN_CONFIGURAR,
-    TOKEN_BUCLE_PRINCIPAL,
-    TOKEN_FIN_BUCLE,
-    TOKEN_SI, // Estructura de desición
-    TOKEN_ENTONCES,
-    TOKEN_SINO,
-    TOKEN_FIN_SI,
-    TOKEN_PARA, // Bucle for
-    TOKEN_DESDE,
-    TOKEN_HASTA,
-    TOKEN_HACER,
-    TOKEN_FIN_PARA,
-    TOKEN_MIENTRAS, // Bucle while
-    TOKEN_FIN_MIENTRAS,
-    TOKEN_REPETIR, // Bucle do while
-    TOKEN_VECES,
-    TOKEN_FUNCION, // Funciones
-    TOKEN_FIN_FUNCION,
-    TOKEN_RETORNAR,
-    // Tipos de datos
-    TOKEN_ENTERO,
-    TOKEN_FLOTANTE,
-    TOKEN_CADENA,
-    TOKEN_BOOLEANO,
-    TOKEN_VERDADERO, // valor booleano 1
-    TOKEN_FALSO, // valor booleano 0
-    // Literales e identificadores
-    TOKEN_IDENTIFICADOR,
-    TOKEN_NUMERO_LIT, // tipo entero
-    TOKEN_DECIMAL_LIT, // tipo flotante
-    TOKEN_CADENA_LIT,
-    TOKEN_CONFIGURAR_PIN, // Para controlar la tarjeta Arduino
-    TOKEN_ESCRIBIR,
-    TOKEN_ESPERAR,
-    // Símbolos y operadores
-    TOKEN_PARENTESIS_IZQ,
-    TOKEN_PARENTESIS_DER,
-    TOKEN_LLAVE_IZQ,
-    TOKEN_LLAVE_DER,
-    TOKEN_COMA,
-    TOKEN_ASIGNACION,
-    TOKEN_IGUALDAD,
-    TOKEN_DESIGUALDAD,
-    TOKEN_MAYOR_QUE,
-    TOKEN_MAYOR_IGUAL,
-    TOKEN_MENOR_QUE,
-    TOKEN_MENOR_IGUAL,
-    TOKEN_MAS,
-    TOKEN_MENOS,
-    TOKEN_DIV,
-    TOKEN_MULT,
-    TOKEN_PUNTO_COMA,
-    TOKEN_EOF, // END OF FILE (fin de archivo)
-    TOKEN_DESCONOCIDO // Para errores
+#define X(tipo, palabra) tipo,
+    STC_TOKENS(X)
+#undef X
+};
+
+// Nombres de los tokens, indexados por TokenType
+inline constexpr std::string_view NOMBRES_TOKENS[] = {
+#define X(tipo, palabra) #tipo,
+    STC_TOKENS(X)
+#undef X
 };
+static_assert(std::size(NOMBRES_TOKENS) == TOKEN_DESCONOCIDO + 1, "Falta el nombre de algun token");
 
-// Mapa para convertir TokenType a string
-inline std::string tokenTypeToString(TokenType type) {
-    static const std::map<TokenType, std::string> typeNames = {
-        // Palabras reservadas
-        {TOKEN_INCLUIR, "TOKEN_INCLUIR"},
-        {TOKEN_PROGRAMA, "TOKEN_PROGRAMA"},
-        {TOKEN_FIN_PROGRAMA, "TOKEN_FIN_PROGRAMA"},
-        {TOKEN_CONFIGURAR, "TOKEN_CONFIGURAR"},
-        {TOKEN_FIN_CONFIGURAR, "TOKEN_FIN_CONFIGURAR"},
-        {TOKEN_BUCLE_PRINCIPAL, "TOKEN_BUCLE_PRINCIPAL"},
-        {TOKEN_FIN_BUCLE, "TOKEN_FIN_BUCLE"},
-        {TOKEN_SI, "TOKEN_SI"},
-        {TOKEN_ENTONCES, "TOKEN_ENTONCES"},
-        {TOKEN_SINO, "TOKEN_SINO"},
-        {TOKEN_FIN_SI, "TOKEN_FIN_SI"},
-        {TOKEN_PARA, "TOKEN_PARA"},
-        {TOKEN_DESDE, "TOKEN_DESDE"},
-        {TOKEN_HASTA, "TOKEN_HASTA"},
-        {TOKEN_HACER, "TOKEN_HACER"},
-        {TOKEN_FIN_PARA, "TOKEN_FIN_PARA"},
-        {TOKEN_MIENTRAS, "TOKEN_MIENTRAS"},
-        {TOKEN_FIN_MIENTRAS, "TOKEN_FIN_MIENTRAS"},
-        {TOKEN_REPETIR, "TOKEN_REPETIR"},
-        {TOKEN_VECES, "TOKEN_VECES"},
-        {TOKEN_FUNCION, "TOKEN_FUNCION"},
-        {TOKEN_FIN_FUNCION, "TOKEN_FIN_FUNCION"},
-        {TOKEN_RETORNAR, "TOKEN_RETORNAR"},
-        // Tipos de datos y literales
-        {TOKEN_ENTERO, "TOKEN_ENTERO"},
-        {TOKEN_FLOTANTE, "TOKEN_FLOTANTE"},
-        {TOKEN_CADENA, "TOKEN_CADENA"},
-        {TOKEN_BOOLEANO, "TOKEN_BOOLEANO"},
-        {TOKEN_VERDADERO, "TOKEN_VERDADERO"},
-        {TOKEN_FALSO, "TOKEN_FALSO"},
-        // Literales
-        {TOKEN_IDENTIFICADOR, "TOKEN_IDENTIFICADOR"},
-        {TOKEN_NUMERO_LIT, "TOKEN_NUMERO_LIT"},
-        {TOKEN_DECIMAL_LIT, "TOKEN_DECIMAL_LIT"},
-        {TOKEN_CADENA_LIT, "TOKEN_CADENA_LIT"},
-        {TOKEN_CONFIGURAR_PIN, "TOKEN_CONFIGURAR_PIN"},
-        {TOKEN_ESCRIBIR, "TOKEN_ESCRIBIR"},
-        {TOKEN_ESPERAR, "TOKEN_ESPERAR"},
-        // Operadores y símbolos
-        {TOKEN_PARENTESIS_IZQ, "TOKEN_PARENTESIS_IZQ"},
-        {TOKEN_PARENTESIS_DER, "TOKEN_PARENTESIS_DER"},
-        {TOKEN_LLAVE_IZQ, "TOKEN_LLAVE_IZQ"},
-        {TOKEN_LLAVE_DER, "TOKEN_LLAVE_DER"},
-        {TOKEN_COMA, "TOKEN_COMA"},
-        {TOKEN_ASIGNACION, "TOKEN_ASIGNACION"},
-        {TOKEN_IGUALDAD, "TOKEN_IGUALDAD"},
-        {TOKEN_DESIGUALDAD, "TOKEN_DESIGUALDAD"},
-        {TOKEN_MAYOR_QUE, "TOKEN_MAYOR_QUE"},
-        {TOKEN_MAYOR_IGUAL, "TOKEN_MAYOR_IGUAL"},
-        {TOKEN_MENOR_QUE, "TOKEN_MENOR_QUE"},
-        {TOKEN_MENOR_IGUAL, "TOKEN_MENOR_IGUAL"},
-        {TOKEN_MAS, "TOKEN_MAS"},
-        {TOKEN_MENOS, "TOKEN_MENOS"},
-        {TOKEN_DIV, "TOKEN_DIV"},
-        {TOKEN_MULT, "TOKEN_MULT"},
-        {TOKEN_PUNTO_COMA, "TOKEN_PUNTO_COMA"},
-        {TOKEN_EOF, "TOKEN_EOF"},
-        {TOKEN_DESCONOCIDO, "TOKEN_DESCONOCIDO"}
-    };
-
-    auto it = typeNames.find(type);
-    return it != typeNames.end() ? it->second : "TOKEN_DESCONOCIDO";
+// Convierte TokenType a su nombre sin reservar memoria
+constexpr std::string_view tokenTypeToString(TokenType type) {
+    return static_cast<size_t>(type) < std::size(NOMBRES_TOKENS)
+        ? NOMBRES_TOKENS[type]
+        : NOMBRES_TOKENS[TOKEN_DESCONOCIDO];
 }
 
-// Estructura para representar un token
+// Estructura para representar un token.
+// value es una vista sobre el buffer fuente (CodigoFuente), que debe seguir
+// vivo mientras se usen los tokens; así el lexer no copia ni reserva memoria
+// por cada token. Los identificadores llevan además su id internado
+// (SIN_SIMBOLO en el resto), que ocupa el hueco de alineación tras type.
 struct Token {
     TokenType type;
-    std::string value;
+    SimboloId simbolo;
+    std::string_view value;
     int line;
     int column;
 };
 
 // Declaraciones y definiciones de funciones
-// Función para identificar palabras reservadas
-inline TokenType identificarPalabraReservada(const std::string& valor) {
-    if (valor == "incluir") return TOKEN_INCLUIR;
-    if (valor == "programa") return TOKEN_PROGRAMA;
-    if (valor == "fin_programa") return TOKEN_FIN_PROGRAMA;
-    if (valor == "configurar") return TOKEN_CONFIGURAR;
-    if (valor == "fin_configurar") return TOKEN_FIN_CONFIGURAR;
-    if (valor == "bucle_principal") return TOKEN_BUCLE_PRINCIPAL;
-    if (valor == "fin_bucle") return TOKEN_FIN_BUCLE;
-    if (valor == "si") return TOKEN_SI;
-    if (valor == "entonces") return TOKEN_ENTONCES;
-    if (valor == "sino") return TOKEN_SINO;
-    if (valor == "fin_si") return TOKEN_FIN_SI;
-    if (valor == "para") return TOKEN_PARA;
-    if (valor == "desde") return TOKEN_DESDE;
-    if (valor == "hasta") return TOKEN_HASTA;
-    if (valor == "hacer") return TOKEN_HACER;
-    if (valor == "fin_para") return TOKEN_FIN_PARA;
-    if (valor == "mientras") return TOKEN_MIENTRAS;
-    if (valor == "fin_mientras") return TOKEN_FIN_MIENTRAS;
-    if (valor == "repetir") return TOKEN_REPETIR;
-    if (valor == "veces") return TOKEN_VECES;
-    if (valor == "funcion") return TOKEN_FUNCION;
-    if (valor == "fin_funcion") return TOKEN_FIN_FUNCION;
-    if (valor == "retornar") return TOKEN_RETORNAR;
-    if (valor == "entero") return TOKEN_ENTERO;
-    if (valor == "decimal") return TOKEN_FLOTANTE;
-    if (valor == "cadena") return TOKEN_CADENA;
-    if (valor == "booleano") return TOKEN_BOOLEANO;
-    if (valor == "verdadero") return TOKEN_VERDADERO;
-    if (valor == "falso") return TOKEN_FALSO;
-    if (valor == "configurar_pin") return TOKEN_CONFIGURAR_PIN;
-    if (valor == "escribir") return TOKEN_ESCRIBIR;
-    if (valor == "esperar") return TOKEN_ESPERAR;
+
+//--------------------------------------------------
+// Clasificador de palabras reservadas (hash perfecto)
+//--------------------------------------------------
+struct PalabraReservada {
+    std::string_view palabra;
+    TokenType tipo;
+};
+
+namespace detalle_palabras {
+
+constexpr size_t contarPalabras() {
+    size_t total = 0;
+#define X(tipo, palabra) if (sizeof(palabra) > 1) total++;
+    STC_TOKENS(X)
+#undef X
+    return total;
+}
+
+constexpr size_t NUM_PALABRAS = contarPalabras();
+
+constexpr std::array<PalabraReservada, NUM_PALABRAS> construirPalabras() {
+    std::array<PalabraReservada, NUM_PALABRAS> tabla{};
+    size_t i = 0;
+#define X(tipo, palabra) if (sizeof(palabra) > 1) tabla[i++] = PalabraReservada{palabra, tipo};
+    STC_TOKENS(X)
+#undef X
+    return tabla;
+}
+
+// Tamaño de la tabla hash (potencia de dos, al menos el doble de palabras)
+constexpr unsigned BITS_TABLA = 7;
+constexpr size_t TAM_TABLA = size_t(1) << BITS_TABLA;
+constexpr uint8_t VACIO = 0xFF;
+static_assert(NUM_PALABRAS * 2 <= TAM_TABLA && NUM_PALABRAS < VACIO,
+              "Demasiadas palabras reservadas para la tabla hash");
+
+// Hash sobre la longitud y tres caracteres; la semilla se elige en tiempo
+// de compilación para que no haya colisiones entre palabras reservadas
+constexpr uint32_t hashPalabra(std::string_view s, uint32_t semilla) {
+    uint32_t h = static_cast<uint32_t>(s.size()) * 0x9E3779B1u;
+    h ^= static_cast<unsigned char>(s[0]);
+    h = h * 31u + static_cast<unsigned char>(s[s.size() > 1 ? 1 : 0]);
+    h = h * 31u + static_cast<unsigned char>(s[s.size() - 1]);
+    return static_cast<uint32_t>((h * semilla) >> (32 - BITS_TABLA));
+}
+
+constexpr bool semillaSinColisiones(const std::array<PalabraReservada, NUM_PALABRAS>& palabras, uint32_t semilla) {
+    bool ocupado[TAM_TABLA] = {};
+    for (const auto& p : palabras) {
+        uint32_t h = hashPalabra(p.palabra, semilla);
+        if (ocupado[h]) return false;
+        ocupado[h] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t buscarSemilla(const std::array<PalabraReservada, NUM_PALABRAS>& palabras) {
+    for (uint32_t semilla = 0x01000193u; semilla < 0x01000193u + 20000u; semilla += 2) {
+        if (semillaSinColisiones(palabras, semilla)) return semilla;
+    }
+    return 0;
+}
+
+constexpr std::array<PalabraReservada, NUM_PALABRAS> PALABRAS = construirPalabras();
+constexpr uint32_t SEMILLA = buscarSemilla(PALABRAS);
+static_assert(SEMILLA != 0, "No se encontro un hash perfecto para las palabras reservadas");
+
+constexpr std::array<uint8_t, TAM_TABLA> construirTabla() {
+    std::array<uint8_t, TAM_TABLA> tabla{};
+    for (auto& celda : tabla) celda = VACIO;
+    for (size_t i = 0; i < NUM_PALABRAS; ++i) {
+        tabla[hashPalabra(PALABRAS[i].palabra, SEMILLA)] = static_cast<uint8_t>(i);
+    }
+    return tabla;
+}
+
+constexpr std::array<uint8_t, TAM_TABLA> TABLA = construirTabla();
+
+constexpr size_t longitudMinima() {
+    size_t minimo = PALABRAS[0].palabra.size();
+    for (const auto& p : PALABRAS) minimo = p.palabra.size() < minimo ? p.palabra.size() : minimo;
+    return minimo;
+}
+
+constexpr size_t longitudMaxima() {
+    size_t maximo = 0;
+    for (const auto& p : PALABRAS) maximo = p.palabra.size() > maximo ? p.palabra.size() : maximo;
+    return maximo;
+}
+
+constexpr size_t LONGITUD_MIN = longitudMinima();
+constexpr size_t LONGITUD_MAX = longitudMaxima();
+
+} // namespace detalle_palabras
+
+// Función para identificar palabras reservadas: un hash y una sola comparación
+inline TokenType identificarPalabraReservada(std::string_view valor) {
+    using namespace detalle_palabras;
+    if (valor.size() < LONGITUD_MIN || valor.size() > LONGITUD_MAX) {
+        return TOKEN_IDENTIFICADOR;
+    }
+    uint8_t indice = TABLA[hashPalabra(valor, SEMILLA)];
+    if (indice != VACIO && PALABRAS[indice].palabra == valor) {
+        return PALABRAS[indice].tipo;
+    }
     return TOKEN_IDENTIFICADOR; // Si no es una palabra reservada, es un identificador
 }
 
-// Función para realizar el análisis léxico
-inline std::vector<Token> analizadorLexico(std::ifstream& archivo, std::vector<Error>& errores) {
-    std::vector<Token> tokens;
-    char c;
+//--------------------------------------------------
+// Tablas del autómata del lexer
+//--------------------------------------------------
+// Cada byte se clasifica con una sola lectura de tabla (sin locale; las
+// clases son las de <cctype> en el locale "C", que es el del compilador).
+// Los operadores de uno o dos caracteres (= == ! != > >= < <=) son un
+// autómata de dos pasos: el primer byte elige el estado y el siguiente
+// decide la transición de aceptación.
+namespace detalle_lexico {
+
+enum class Clase : uint8_t {
+    OTRO,       // Caracter no reconocido (incluye '.' suelto y bytes >= 0x80)
+    ESPACIO,    // ' ' \t \n \v \f \r
+    LETRA,      // A-Z a-z _
+    DIGITO,     // 0-9
+    COMILLA,    // "
+    BARRA,      // / (comentario o división)
+    SIMBOLO,    // ( ) { } ; , + - *
+    OPERADOR    // = ! > <
+};
+
+// Banderas para continuar un lexema
+constexpr uint8_t CONTINUA_IDENTIFICADOR = 1; // Letra, dígito o '_'
+constexpr uint8_t CONTINUA_NUMERO = 2;        // Dígito o '.'
+
+constexpr std::array<Clase, 256> construirClases() {
+    std::array<Clase, 256> tabla{};
+    for (auto& clase : tabla) clase = Clase::OTRO;
+    for (unsigned char c : {' ', '\t', '\n', '\v', '\f', '\r'}) tabla[c] = Clase::ESPACIO;
+    for (int c = 'a'; c <= 'z'; ++c) tabla[c] = Clase::LETRA;
+    for (int c = 'A'; c <= 'Z'; ++c) tabla[c] = Clase::LETRA;
+    tabla['_'] = Clase::LETRA;
+    for (int c = '0'; c <= '9'; ++c) tabla[c] = Clase::DIGITO;
+    tabla['"'] = Clase::COMILLA;
+    tabla['/'] = Clase::BARRA;
+    for (unsigned char c : {'(', ')', '{', '}', ';', ',', '+', '-', '*'}) tabla[c] = Clase::SIMBOLO;
+    for (unsigned char c : {'=', '!', '>', '<'}) tabla[c] = Clase::OPERADOR;
+    return tabla;
+}
+
+constexpr std::array<uint8_t, 256> construirBanderas() {
+    std::array<uint8_t, 256> tabla{};
+    for (int c = 'a'; c <= 'z'; ++c) tabla[c] = CONTINUA_IDENTIFICADOR;
+    for (int c = 'A'; c <= 'Z'; ++c) tabla[c] = CONTINUA_IDENTIFICADOR;
+    tabla['_'] = CONTINUA_IDENTIFICADOR;
+    for (int c = '0'; c <= '9'; ++c) tabla[c] = CONTINUA_IDENTIFICADOR | CONTINUA_NUMERO;
+    tabla['.'] = CONTINUA_NUMERO;
+    return tabla;
+}
+
+constexpr std::array<TokenType, 256> construirSimbolos() {
+    std::array<TokenType, 256> tabla{};
+    for (auto& tipo : tabla) tipo = TOKEN_DESCONOCIDO;
+    tabla['('] = TOKEN_PARENTESIS_IZQ;
+    tabla[')'] = TOKEN_PARENTESIS_DER;
+    tabla['{'] = TOKEN_LLAVE_IZQ;
+    tabla['}'] = TOKEN_LLAVE_DER;
+    tabla[';'] = TOKEN_PUNTO_COMA;
+    tabla[','] = TOKEN_COMA;
+    tabla['+'] = TOKEN_MAS;   // Operador de suma
+    tabla['-'] = TOKEN_MENOS; // Operador de resta
+    tabla['*'] = TOKEN_MULT;  // Operador de multiplicación
+    return tabla;
+}
+
+// Estados del autómata de operadores, uno por primer caracter
+enum EstadoOperador : uint8_t { VISTO_IGUAL, VISTO_EXCLAMACION, VISTO_MAYOR, VISTO_MENOR, NUM_ESTADOS_OPERADOR };
+
+constexpr std::array<uint8_t, 256> construirEstadosOperador() {
+    std::array<uint8_t, 256> tabla{};
+    tabla['='] = VISTO_IGUAL;
+    tabla['!'] = VISTO_EXCLAMACION;
+    tabla['>'] = VISTO_MAYOR;
+    tabla['<'] = VISTO_MENOR;
+    return tabla;
+}
+
+// Aceptación: tipo y longitud del lexema (0 = error, '!' solo)
+struct Transicion {
+    TokenType tipo;
+    uint8_t longitud;
+};
+
+// [estado][el siguiente byte es '=']
+constexpr Transicion TRANSICIONES[NUM_ESTADOS_OPERADOR][2] = {
+    /* =  */ {{TOKEN_ASIGNACION, 1}, {TOKEN_IGUALDAD, 2}},
+    /* !  */ {{TOKEN_DESCONOCIDO, 0}, {TOKEN_DESIGUALDAD, 2}},
+    /* >  */ {{TOKEN_MAYOR_QUE, 1}, {TOKEN_MAYOR_IGUAL, 2}},
+    /* <  */ {{TOKEN_MENOR_QUE, 1}, {TOKEN_MENOR_IGUAL, 2}},
+};
+
+constexpr std::array<Clase, 256> CLASES = construirClases();
+constexpr std::array<uint8_t, 256> BANDERAS = construirBanderas();
+constexpr std::array<TokenType, 256> SIMBOLOS = construirSimbolos();
+constexpr std::array<uint8_t, 256> ESTADOS_OPERADOR = construirEstadosOperador();
+
+} // namespace detalle_lexico
+
+//--------------------------------------------------
+// Analizador léxico
+//--------------------------------------------------
+// Se reporta en la columna del punto sobrante, que coincide con el final
+// del número que se emite a continuación
+inline constexpr const char* MENSAJE_PUNTOS_MULTIPLES = "Numero con multiples puntos decimales";
+
+// Estado del lexer entre dos tokens. Permite reanudar el análisis desde
+// cualquier punto del buffer (lexer paralelo y relexado incremental).
+struct EstadoLexico {
+    size_t pos = 0;
     int linea = 1;
     int columna = 1;
-    std::string buffer;
-
-    while (archivo.get(c)) {
-        // Ignorar espacios en blanco
-        if (std::isspace(c)) {
-            if (c == '\n') {
-                linea++;
-                columna = 1;
-            } else {
-                columna++;
-            }
-            continue;
+    bool enComentario = false;  // Dentro de un comentario /* */ que sigue abierto
+    bool bufferVacio = true;    // El último lexema (cadena, número o identificador) quedó vacío
+    bool hayTokens = false;
+    TokenType ultimoTipo = TOKEN_DESCONOCIDO; // Tipo del último token emitido
+    bool errorAbierto = false;  // Lo último fue un error, sin tokens después (racha agrupable)
+};
+
+// Analiza un buffer contiguo (archivo mapeado en memoria o texto ya
+// cargado) y entrega los tokens uno a uno con siguiente(), de modo que el
+// parser puede pedirlos a medida que los necesita. Al terminar el buffer
+// devuelve TOKEN_EOF en cada llamada.
+class AnalizadorLexico {
+private:
+    std::string_view fuente;
+    const char* datos;
+    size_t n;               // Límite del análisis (fin del buffer o del fragmento)
+    size_t pos = 0;
+    char c = 0;
+    int linea = 1;
+    int columna = 1;
+    bool comentarioAbierto = false;
+    bool bufferVacio = true;
+    TokenType ultimoTipo = TOKEN_DESCONOCIDO;
+    bool hayTokens = false;
+    // En modo especulativo (fragmentos del lexer paralelo) no se conoce el
+    // último lexema ni el último token anteriores al fragmento
+    bool bufferConocido = true;
+    bool tipoConocido = true;
+    bool dependeDeEntrada = false;
+    std::vector<Error>& errores;
+    const escaneo::Operaciones& busqueda;
+    TablaCadenas* cadenas = &cadenasGlobales();
+    LimiteErrores* limite = nullptr;
+    bool errorAbierto = false;
+
+    // Equivalente de peek() sobre el buffer; devuelve EOF al final
+    int siguienteCaracter() const {
+        return pos < n ? static_cast<unsigned char>(datos[pos]) : std::char_traits<char>::eof();
+    }
+
+    // Avanza linea/columna como si se hubieran leído uno a uno los bytes
+    // de [desde, hasta), contando los saltos de línea por bloques
+    void avanzarPosicion(size_t desde, size_t hasta) {
+        size_t ultimoSalto = 0;
+        size_t saltos = busqueda.contarSaltos(datos, desde, hasta, ultimoSalto);
+        if (saltos > 0) {
+            linea += static_cast<int>(saltos);
+            columna = 1 + static_cast<int>(hasta - ultimoSalto - 1);
+        } else {
+            columna += static_cast<int>(hasta - desde);
         }
+    }
 
-        // Detectar comentarios
-        if (c == '/') {
-            char nextChar = archivo.peek();
-            if (nextChar == '/') { // Comentario de una línea
-                archivo.get(); // Consume el segundo '/'
-                while (archivo.get(c) && c != '\n') {
-                    // Ignorar todos los caracteres hasta el final de la línea
+    // Recorre el interior de un comentario /* */ a partir de pos.
+    // El '*' del cierre cuenta en la columna; la '/' final no
+    void saltarComentarioBloque() {
+        size_t cierre = busqueda.buscarCierreComentario(datos, n, pos);
+        comentarioAbierto = cierre >= n;
+        if (!comentarioAbierto) {
+            avanzarPosicion(pos, cierre + 1);
+            pos = cierre + 2;
+            return;
+        }
+        avanzarPosicion(pos, n);
+        pos = n;
+        // Un fragmento puede terminar dentro del comentario sin que sea un error
+        if (n == fuente.size()) {
+            comentarioAbierto = false;
+            reportar({
+                "Comentario sin terminar en linea",
+                linea,
+                columna,
+                "Lexico"
+            });
+        }
+    }
+
+    // Con un límite, las rachas de errores idénticos se agrupan en el último
+    // y se deja de escanear al agotarlo
+    void reportar(Error error) {
+        if (limite && limite->agrupar() && errorAbierto && !errores.empty() && mismoError(errores.back(), error)) {
+            extenderError(errores.back(), error);
+            return;
+        }
+        errorAbierto = true;
+        if (limite && !limite->registrar()) return;
+        errores.push_back(std::move(error));
+    }
+
+    bool detenido() const { return limite && limite->agotado(); }
+
+    void definirBuffer(std::string_view lexema) {
+        bufferVacio = lexema.empty();
+        bufferConocido = true;
+    }
+
+    Token emitir(TokenType tipo, std::string_view valor, int lin, int col, SimboloId simbolo = SIN_SIMBOLO) {
+        ultimoTipo = tipo;
+        hayTokens = true;
+        tipoConocido = true;
+        errorAbierto = false;
+        return Token{tipo, simbolo, valor, lin, col};
+    }
+
+    // Símbolos y operadores: el lexema ya se consumió y termina en pos
+    Token emitirOperador(TokenType tipo, size_t longitud) {
+        Token token = emitir(tipo, fuente.substr(pos - longitud, longitud), linea, columna);
+        columna += static_cast<int>(longitud);
+        return token;
+    }
+
+public:
+    AnalizadorLexico(std::string_view fuente, std::vector<Error>& errores)
+        : fuente(fuente), datos(fuente.data()), n(fuente.size()), errores(errores),
+          busqueda(escaneo::operacionesActivas()) {}
+
+    // Reanuda el análisis desde un estado conocido, hasta la posición limite.
+    // Con especulativo, el lexema y el token previos se tratan como
+    // desconocidos y dependeDelEstadoPrevio() indica si llegaron a influir.
+    AnalizadorLexico(std::string_view fuente, std::vector<Error>& errores,
+                     const EstadoLexico& inicio, size_t limite, bool especulativo = false)
+        : fuente(fuente), datos(fuente.data()), n(limite < fuente.size() ? limite : fuente.size()),
+          pos(inicio.pos), linea(inicio.linea), columna(inicio.columna),
+          comentarioAbierto(inicio.enComentario), bufferVacio(inicio.bufferVacio),
+          ultimoTipo(inicio.ultimoTipo), hayTokens(inicio.hayTokens),
+          bufferConocido(!especulativo), tipoConocido(!especulativo),
+          errores(errores), busqueda(escaneo::operacionesActivas()), errorAbierto(inicio.errorAbierto) {}
+
+    // Tabla donde se internan los identificadores (por defecto la global)
+    void usarCadenas(TablaCadenas& tabla) { cadenas = &tabla; }
+
+    // Límite de errores (--max-errors), compartido con el parser
+    void usarLimite(LimiteErrores& limiteErrores) { limite = &limiteErrores; }
+
+    // Indica si ya se consumió todo el buffer
+    bool terminado() const { return pos >= n || detenido(); }
+
+    EstadoLexico estado() const {
+        return EstadoLexico{pos, linea, columna, comentarioAbierto, bufferVacio, hayTokens, ultimoTipo, errorAbierto};
+    }
+
+    bool conocioBuffer() const { return bufferConocido; }
+    bool conocioUltimoTipo() const { return tipoConocido; }
+    bool dependeDelEstadoPrevio() const { return dependeDeEntrada; }
+
+    Token siguiente() {
+        using namespace detalle_lexico;
+        if (comentarioAbierto && !detenido()) saltarComentarioBloque();
+
+        while (pos < n && !detenido()) {
+            c = datos[pos++];
+            const unsigned char byte = static_cast<unsigned char>(c);
+
+            switch (CLASES[byte]) {
+            case Clase::ESPACIO:
+                if (pos < n && CLASES[static_cast<unsigned char>(datos[pos])] == Clase::ESPACIO) {
+                    // Racha de espacios: salto vectorizado
+                    size_t fin = busqueda.finEspacios(datos, n, pos);
+                    avanzarPosicion(pos - 1, fin);
+                    pos = fin;
+                    continue;
                 }
                 if (c == '\n') {
                     linea++;
                     columna = 1;
+                } else {
+                    columna++;
                 }
                 continue;
-            } else if (nextChar == '*') { // Comentario de múltiples líneas
-                archivo.get(); // Consume el '*'
-                bool comentarioTerminado = false;
-                while (archivo.get(c)) {
-                    if (c == '\n') {
+
+            case Clase::BARRA: {
+                char nextChar = static_cast<char>(siguienteCaracter());
+                if (nextChar == '/') { // Comentario de una línea
+                    pos++; // Consume el segundo '/'
+                    // Ignorar todos los caracteres hasta el final de la línea
+                    size_t salto = busqueda.buscarSalto(datos, n, pos);
+                    if (salto < n) {
+                        pos = salto + 1;
                         linea++;
                         columna = 1;
                     } else {
-                        columna++;
-                    }
-                    if (c == '*' && archivo.peek() == '/') {
-                        archivo.get(); // Consume el '/'
-                        comentarioTerminado = true;
-                        break;
+                        pos = n;
                     }
+                    continue;
                 }
-                if (!comentarioTerminado) {
-                    errores.push_back({
-                        "Comentario sin terminar en linea",
-                        linea,
-                        columna,
-                        "Lexico"
-                    });
+                if (nextChar == '*') { // Comentario de múltiples líneas
+                    pos++; // Consume el '*'
+                    saltarComentarioBloque();
+                    continue;
                 }
-                continue;
+                // Operador de división solitario
+                if (!bufferConocido || (bufferVacio && !tipoConocido)) dependeDeEntrada = true;
+                if (bufferVacio && hayTokens && ultimoTipo == TOKEN_ASIGNACION) {
+                    reportar({"Operador '/' invalido en asignacion", linea, columna, "Lexico"});
+                    columna++;
+                    continue;
+                }
+                return emitirOperador(TOKEN_DIV, 1);
             }
-        }
 
-        // Detectar cadenas de texto
-        if (c == '"') {
-            // Variables auxiliares para posición inicial
-            int inicio_linea = linea;
-            int inicio_columna = columna;
-            bool salto = false;
-            buffer.clear();
-            columna++;
+            case Clase::COMILLA: {
+                // Variables auxiliares para posición inicial
+                int inicio_linea = linea;
+                int inicio_columna = columna;
+                bool salto = false;
+                size_t inicio = pos;
+                size_t fin = pos;
+                columna++;
 
-            while (archivo.get(c) && c != '"') {
-                if (c == '\n') {
-                    salto = true;
-                    break;
+                while (pos < n) {
+                    c = datos[pos++];
+                    if (c == '"') break;
+                    if (c == '\n') {
+                        salto = true;
+                        break;
+                    }
+                    fin = pos;
+                    columna++;
                 }
-                buffer += c;
-                columna++;
+                std::string_view buffer = fuente.substr(inicio, fin - inicio);
+                definirBuffer(buffer);
+                if (c != '"') {
+                    reportar({"Cadena sin comillas de cierre", inicio_linea, inicio_columna, "Lexico"});
+                    linea++;
+                } else if (salto) {
+                    reportar({"Salto de linea no valido", inicio_linea, inicio_columna, "Lexico"});
+                } else {
+                    Token token = emitir(TOKEN_CADENA_LIT, buffer, linea, inicio_columna);
+                    columna++;
+                    return token;
+                }
+                continue;
             }
-            if (c != '"') {
-                errores.push_back({"Cadena sin comillas de cierre", inicio_linea, inicio_columna, "Lexico"});
-                linea++;
-            } else if (salto) {
-                errores.push_back({"Salto de linea no valido", inicio_linea, inicio_columna, "Lexico"});
-            } else {
-                tokens.push_back(Token{TOKEN_CADENA_LIT, buffer, linea, inicio_columna});
+
+            case Clase::DIGITO: { // Números enteros o decimales
+                size_t inicio = pos - 1;
+                bool punto = false;
                 columna++;
-            }
-            continue;
-        }
 
-        // Detectar números enteros o decimales
-        if (std::isdigit(c)) {
-            buffer.clear();
-            buffer += c;
-            columna++;
-
-            while (archivo.get(c) && (std::isdigit(c) || c == '.')) {
-                if (c == '.' && buffer.find('.') != std::string::npos) {
-                    errores.push_back({
-                        "Numero con multiples puntos decimales", 
-                        linea, 
-                        columna, 
-                        "Lexico",
-                    });
-                    break;
+                while (pos < n && (BANDERAS[static_cast<unsigned char>(datos[pos])] & CONTINUA_NUMERO)) {
+                    if (datos[pos] == '.') {
+                        if (punto) {
+                            reportar({
+                                MENSAJE_PUNTOS_MULTIPLES,
+                                linea, 
+                                columna, 
+                                "Lexico",
+                            });
+                            break; // El punto sobrante se vuelve a analizar
+                        }
+                        punto = true;
+                    }
+                    pos++;
+                    columna++;
                 }
-                buffer += c;
-                columna++;
-            }
-            archivo.unget(); // Devolver el último carácter leído
+                std::string_view buffer = fuente.substr(inicio, pos - inicio);
+                definirBuffer(buffer);
 
-            if (buffer.find('.') != std::string::npos) {
-                tokens.push_back(Token{TOKEN_DECIMAL_LIT, buffer, linea, columna - static_cast<int>(buffer.length())});
-            } else {
-                tokens.push_back(Token{TOKEN_NUMERO_LIT, buffer, linea, columna - static_cast<int>(buffer.length())});
+                return emitir(punto ? TOKEN_DECIMAL_LIT : TOKEN_NUMERO_LIT, buffer,
+                              linea, columna - static_cast<int>(buffer.length()));
             }
-            continue;
-        }
 
-        // Detectar identificadores o palabras reservadas
-        if (std::isalpha(c) || c == '_') {
-            buffer.clear();
-            buffer += c;
-            columna++;
+            case Clase::LETRA: { // Identificadores o palabras reservadas
+                size_t inicio = pos - 1;
+                size_t fin = pos;
+                while (fin < n && (BANDERAS[static_cast<unsigned char>(datos[fin])] & CONTINUA_IDENTIFICADOR)) fin++;
+                columna += static_cast<int>(fin - inicio);
+                pos = fin;
+                std::string_view buffer = fuente.substr(inicio, fin - inicio);
+                definirBuffer(buffer);
 
-            while (archivo.get(c) && (std::isalnum(c) || c == '_')) {
-                buffer += c;
-                columna++;
-            }
-            archivo.unget(); // Devolver el último carácter leído
-
-            if (buffer.length() > 32) {
-                errores.push_back({
-                    "Identificador excede longitud maxima (32 caracteres)",
-                    linea,
-                    columna - static_cast<int>(buffer.length()),
-                    "Lexico"
-                });
-            } else {
+                if (buffer.length() > 32) {
+                    reportar({
+                        "Identificador excede longitud maxima (32 caracteres)",
+                        linea,
+                        columna - static_cast<int>(buffer.length()),
+                        "Lexico"
+                    });
+                    continue;
+                }
                 // Verificar si el identificador es una palabra reservada
                 TokenType tipo = identificarPalabraReservada(buffer);
-                tokens.push_back(Token{tipo, buffer, linea, columna - static_cast<int>(buffer.length())});
-                /*
-                if (tipo == TOKEN_IDENTIFICADOR) {
-                    tokens.push_back(Token{tipo, buffer, linea, columna - static_cast<int>(buffer.length())});
-                } else {
-                    tokens.push_back(Token{tipo, buffer, linea, columna - static_cast<int>(buffer.length())});
-                }
-                */
+                SimboloId simbolo = tipo == TOKEN_IDENTIFICADOR ? cadenas->internar(buffer) : SIN_SIMBOLO;
+                return emitir(tipo, buffer, linea, columna - static_cast<int>(buffer.length()), simbolo);
             }
-            continue;
-        }
 
-        // Detectar símbolos especiales y operadores compuestos
-        TokenType tipo;
-        switch (c) {
-            case '(': tipo = TOKEN_PARENTESIS_IZQ; break;
-            case ')': tipo = TOKEN_PARENTESIS_DER; break;
-            case '{': tipo = TOKEN_LLAVE_IZQ; break;
-            case '}': tipo = TOKEN_LLAVE_DER; break;
-            case ';': tipo = TOKEN_PUNTO_COMA; break;
-            case ',': tipo = TOKEN_COMA; break;
-            case '=':
-                if (archivo.peek() == '=') { // Operador de igualdad (==)
-                    archivo.get(); // Consume el segundo '='
-                    tipo = TOKEN_IGUALDAD;
-                    tokens.push_back(Token{tipo, "==", linea, columna});
-                    columna += 2;
-                    continue;
-                } else { // Operador de asignación (=)
-                    tipo = TOKEN_ASIGNACION;
-                }
-                break;
-            case '!':
-                if (archivo.peek() == '=') { // Operador de desigualdad (!=)
-                    archivo.get(); // Consume el '='
-                    tipo = TOKEN_DESIGUALDAD;
-                    tokens.push_back(Token{tipo, "!=", linea, columna});
-                    columna += 2;
-                    continue;
-                } else {
-                    errores.push_back({
+            case Clase::SIMBOLO: // ( ) { } ; , + - *
+                return emitirOperador(SIMBOLOS[byte], 1);
+
+            case Clase::OPERADOR: { // = ! > <: un paso del autómata según el siguiente byte
+                const Transicion& t = TRANSICIONES[ESTADOS_OPERADOR[byte]][pos < n && datos[pos] == '='];
+                if (t.longitud == 0) {
+                    reportar({
                         "Operador '!' no valido (quizas quiso usar '!='?)",
                         linea,
                         columna,
@@ -376,54 +638,12 @@ inline std::vector<Token> analizadorLexico(std::ifstream& archivo, std::vector<E
                     columna++;
                     continue;
                 }
-                break;
-            case '>':
-                if (archivo.peek() == '=') { // Operador de mayor igual (>=)
-                    archivo.get();
-                    tokens.push_back(Token{TOKEN_MAYOR_IGUAL, ">=", linea, columna});
-                    columna += 2;
-                } else { // Operador de mayor que (>)
-                    tokens.push_back(Token{TOKEN_MAYOR_QUE, ">", linea, columna});
-                    columna++;
-                }
-                continue;
-            case '<':
-                if (archivo.peek() == '=') { // Operador de menor igual (<=)
-                    archivo.get();
-                    tokens.push_back(Token{TOKEN_MENOR_IGUAL, "<=", linea, columna});
-                    columna += 2;
-                } else { //  Operador de menor que (<)
-                    tokens.push_back(Token{TOKEN_MENOR_QUE, "<", linea, columna});
-                    columna++;
-                }
-                continue;
-            case '+': // Operador de suma
-                tokens.push_back(Token{TOKEN_MAS, "+", linea, columna});
-                columna++;
-                continue;
-            case '-': // Operador de resta
-                tokens.push_back(Token{TOKEN_MENOS, "-", linea, columna});
-                columna++;
-                continue;
-            case '*': // Operador de multiplicación
-                tokens.push_back(Token{TOKEN_MULT, "*", linea, columna});
-                columna++;
-                continue;
-            case '/':
-                // Validar si no es comentario
-                if (archivo.peek() != '/' && archivo.peek() != '*') {
-                    // Validar si es operador solitario
-                    if (buffer.empty() && tokens.back().type == TOKEN_ASIGNACION) {
-                        errores.push_back({"Operador '/' invalido en asignacion", linea, columna, "Lexico"});
-                    } else {
-                        tokens.push_back(Token{TOKEN_DIV, "/", linea, columna});
-                    }
-                    //tokens.push_back(Token{TOKEN_DIV, "/", linea, columna});
-                    columna++;
-                    continue;
-                }
-            default:
-                errores.push_back({
+                pos += t.longitud - 1;
+                return emitirOperador(t.tipo, t.longitud);
+            }
+
+            case Clase::OTRO:
+                reportar({
                     "Caracter no reconocido: '" + std::string(1, c) + "'",
                     linea,
                     columna,
@@ -431,14 +651,32 @@ inline std::vector<Token> analizadorLexico(std::ifstream& archivo, std::vector<E
                 });
                 columna++;
                 continue;
+            }
         }
-        tokens.push_back(Token{tipo, std::string(1, c), linea, columna});
-        columna++;
-    }
 
-    // Añadir token de fin de archivo
-    tokens.push_back(Token{TOKEN_EOF, "", linea, columna});
+        // Token de fin de archivo (o de fragmento); no cuenta como último token
+        return Token{TOKEN_EOF, SIN_SIMBOLO, fuente.substr(n, 0), linea, columna};
+    }
+};
 
+// Analiza todo el buffer de una vez (o hasta agotar el límite de errores)
+// y devuelve la lista completa de tokens. Con llamadas, agrega por cada
+// error nuevo el índice del token que entregó la llamada a siguiente()
+// donde se reportó (ver TokenStream::diferirErroresLexicos).
+inline std::vector<Token> analizadorLexico(std::string_view fuente, std::vector<Error>& errores,
+                                           LimiteErrores* limite = nullptr,
+                                           std::vector<size_t>* llamadas = nullptr) {
+    std::vector<Token> tokens;
+    AnalizadorLexico lexer(fuente, errores);
+    if (limite) lexer.usarLimite(*limite);
+    size_t erroresPrevios = errores.size();
+    do {
+        tokens.push_back(lexer.siguiente());
+        if (llamadas && errores.size() > erroresPrevios) {
+            llamadas->insert(llamadas->end(), errores.size() - erroresPrevios, tokens.size() - 1);
+            erroresPrevios = errores.size();
+        }
+    } while (tokens.back().type != TOKEN_EOF);
     return tokens;
 }
 
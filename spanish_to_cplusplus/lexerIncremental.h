@@ -0,0 +1,198 @@
+#ifndef LEXER_INCREMENTAL_H
+#define LEXER_INCREMENTAL_H
+
+#include "lexer.h"
+#include "tokensEditables.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// Relexado incremental: actualiza los tokens y errores léxicos de un texto
+// después de reemplazar un rango de bytes, sin volver a analizar todo.
+//
+// El análisis se reanuda justo después del último identificador, palabra
+// reservada o literal que termina antes de la edición (su estado de salida
+// se deduce del propio token) y se detiene en cuanto produce, ya pasada la
+// edición, un token de esa misma clase que coincide con uno anterior en
+// posición, tipo, longitud y columna: desde ahí el lexer haría exactamente
+// lo mismo que antes, así que el resto solo se desplaza en bytes y líneas.
+// Ese desplazamiento no se aplica token por token: TokensEditables lo
+// anota en los bloques que siguen a la edición.
+
+// Reemplazo de [inicio, inicio + longitudAnterior) del texto anterior por
+// longitudNueva bytes
+struct EdicionTexto {
+    size_t inicio = 0;
+    size_t longitudAnterior = 0;
+    size_t longitudNueva = 0;
+};
+
+// Qué parte de la lista se volvió a analizar
+struct ResultadoRelexado {
+    size_t primerToken = 0;         // Índice del primer token reemplazado
+    size_t tokensEliminados = 0;
+    size_t tokensInsertados = 0;
+    size_t bytesAnalizados = 0;
+    bool resincronizado = false;    // false: se analizó hasta el final del texto
+};
+
+namespace detalle_incremental {
+
+// Tokens cuyo estado de salida se deduce solo del token: fijan el último
+// lexema (vacío o no) y el último tipo
+constexpr bool ES_LEXEMA[] = {
+#define X(tipo, palabra) (sizeof(palabra) > 1 || tipo == TOKEN_IDENTIFICADOR || tipo == TOKEN_NUMERO_LIT || \
+                          tipo == TOKEN_DECIMAL_LIT || tipo == TOKEN_CADENA_LIT),
+    STC_TOKENS(X)
+#undef X
+};
+
+inline bool esLexema(TokenType tipo) {
+    return ES_LEXEMA[tipo];
+}
+
+// Inicio del token en bytes; las cadenas empiezan en la comilla
+inline size_t inicioToken(const Token& token, const char* base) {
+    return static_cast<size_t>(token.value.data() - base) - (token.type == TOKEN_CADENA_LIT ? 1 : 0);
+}
+
+// Estado del lexer justo después de un token de lexema
+inline EstadoLexico estadoDespues(const TokensEditables& tokens, size_t indice) {
+    size_t cursor = 0;
+    const Token token = tokens.token(indice, cursor);
+    EstadoLexico estado;
+    estado.pos = tokens.fin(indice, cursor);
+    estado.linea = token.line;
+    estado.columna = token.column + static_cast<int>(estado.pos - tokens.inicio(indice, cursor));
+    estado.bufferVacio = token.value.empty();
+    estado.hayTokens = true;
+    estado.ultimoTipo = token.type;
+    return estado;
+}
+
+// Primer índice en [0, cantidad) donde condicion deja de cumplirse (se
+// cumple en un prefijo)
+template <typename Condicion>
+size_t primeroQueNo(size_t cantidad, Condicion condicion) {
+    size_t desde = 0;
+    while (cantidad > 0) {
+        size_t mitad = cantidad / 2;
+        if (condicion(desde + mitad)) {
+            desde += mitad + 1;
+            cantidad -= mitad + 1;
+        } else {
+            cantidad = mitad;
+        }
+    }
+    return desde;
+}
+
+// Los errores léxicos salen en orden de posición (línea, columna). El de
+// puntos múltiples cae justo al final del número al que pertenece, así que
+// se cuenta como parte de él
+inline bool antesDe(const Error& error, int linea, int columna) {
+    int columnaError = error.columna - (error.mensaje == MENSAJE_PUNTOS_MULTIPLES ? 1 : 0);
+    return error.linea < linea || (error.linea == linea && columnaError < columna);
+}
+
+} // namespace detalle_incremental
+
+// Actualiza tokens y errores (resultado de analizadorLexico sobre el
+// texto anterior, tokens.texto()) para que correspondan a nueva = anterior
+// con la edición aplicada. Del texto anterior solo se usan los offsets que
+// guarda la lista; sus bytes no se vuelven a leer, así que puede haberse
+// modificado en el mismo lugar. Al terminar, los tokens apuntan a nueva.
+inline ResultadoRelexado relexarEdicion(std::string_view nueva, const EdicionTexto& edicion,
+                                        TokensEditables& tokens, std::vector<Error>& errores) {
+    using namespace detalle_incremental;
+    const size_t largoAnterior = tokens.texto().size();
+    if (edicion.inicio + edicion.longitudAnterior > largoAnterior ||
+        nueva.size() != largoAnterior - edicion.longitudAnterior + edicion.longitudNueva) {
+        throw std::invalid_argument("relexarEdicion: la edicion no corresponde a los textos");
+    }
+
+    ResultadoRelexado resultado;
+    const char* baseNueva = nueva.data();
+    size_t cursor = 0;
+
+    // 1. Punto de reanudación: último lexema que termina antes de la edición
+    //    (el byte siguiente, que el lexer miró para cortarlo, no cambió)
+    size_t cortos = primeroQueNo(tokens.size(), [&](size_t i) {
+        return tokens.tipo(i, cursor) != TOKEN_EOF && tokens.fin(i, cursor) < edicion.inicio;
+    });
+    while (cortos > 0 && !esLexema(tokens.tipo(cortos - 1, cursor))) cortos--;
+
+    EstadoLexico inicio;
+    if (cortos > 0) inicio = estadoDespues(tokens, cortos - 1);
+    resultado.primerToken = cortos;
+
+    // 2. Volver a analizar hasta resincronizar con la lista anterior
+    const size_t finEdicionNueva = edicion.inicio + edicion.longitudNueva;
+    const size_t finEdicionAnterior = edicion.inicio + edicion.longitudAnterior;
+    std::vector<Token> nuevos;
+    std::vector<Error> erroresNuevos;
+    AnalizadorLexico lexer(nueva, erroresNuevos, inicio, nueva.size());
+    size_t coincidente = cortos; // Candidato en la lista anterior
+    while (true) {
+        Token token = lexer.siguiente();
+        nuevos.push_back(token);
+        if (token.type == TOKEN_EOF) break;
+
+        size_t posicion = inicioToken(token, baseNueva);
+        if (posicion < finEdicionNueva || !esLexema(token.type)) continue;
+        size_t posicionAnterior = posicion - finEdicionNueva + finEdicionAnterior;
+        while (coincidente < tokens.size() && tokens.tipo(coincidente, cursor) != TOKEN_EOF &&
+               tokens.inicio(coincidente, cursor) < posicionAnterior) {
+            coincidente++;
+        }
+        if (coincidente == tokens.size()) continue;
+        const Token previo = tokens.token(coincidente, cursor);
+        if (previo.type == token.type && previo.value.size() == token.value.size() &&
+            previo.column == token.column && tokens.inicio(coincidente, cursor) == posicionAnterior) {
+            resultado.resincronizado = true;
+            break;
+        }
+    }
+    resultado.bytesAnalizados = lexer.estado().pos - inicio.pos;
+
+    // 3. Armar la lista: prefijo intacto, tokens nuevos y el resto, que
+    //    solo se anota como desplazado
+    const size_t desplazamiento = finEdicionNueva - finEdicionAnterior; // Aritmética modular
+    int lineas = 0;
+    size_t restoDesde = tokens.size();
+    EstadoLexico salidaAnterior;
+    if (resultado.resincronizado) {
+        lineas = nuevos.back().line - tokens.token(coincidente, cursor).line;
+        salidaAnterior = estadoDespues(tokens, coincidente);
+        restoDesde = coincidente + 1;
+    }
+    resultado.tokensEliminados = restoDesde - cortos;
+    resultado.tokensInsertados = nuevos.size();
+    tokens.reemplazar(nueva, cortos, restoDesde, nuevos, desplazamiento, lineas);
+
+    // 4. Errores: los de antes del punto de reanudación, los del tramo
+    //    analizado y los posteriores a la resincronización, desplazados
+    size_t primerReemplazado = 0;
+    if (cortos > 0) {
+        primerReemplazado = static_cast<size_t>(
+            std::partition_point(errores.begin(), errores.end(), [&](const Error& error) {
+                return antesDe(error, inicio.linea, inicio.columna);
+            }) - errores.begin());
+    }
+    size_t primerConservado = errores.size();
+    if (resultado.resincronizado) {
+        primerConservado = static_cast<size_t>(
+            std::partition_point(errores.begin() + primerReemplazado, errores.end(), [&](const Error& error) {
+                return antesDe(error, salidaAnterior.linea, salidaAnterior.columna);
+            }) - errores.begin());
+        for (size_t i = primerConservado; i < errores.size(); ++i) {
+            errores[i].linea += lineas;
+            if (errores[i].lineaFin > 0) errores[i].lineaFin += lineas;
+        }
+    }
+    errores.erase(errores.begin() + primerReemplazado, errores.begin() + primerConservado);
+    errores.insert(errores.begin() + primerReemplazado, erroresNuevos.begin(), erroresNuevos.end());
+    return resultado;
+}
+
+#endif // LEXER_INCREMENTAL_H
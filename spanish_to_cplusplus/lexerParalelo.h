@@ -0,0 +1,291 @@
+#ifndef LEXER_PARALELO_H
+#define LEXER_PARALELO_H
+
+#include "lexer.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Análisis léxico en paralelo para archivos grandes.
+//
+// El único estado léxico que cruza una línea es el comentario /* */ (las
+// cadenas no pueden tener saltos de línea), así que el archivo se corta
+// justo después de un '\n' y cada fragmento se analiza en su propio hilo
+// suponiendo que empieza fuera de comentario y en la columna 1. Luego una
+// pasada secuencial calcula el estado real de entrada de cada fragmento a
+// partir de la salida del anterior y vuelve a analizar solo los
+// fragmentos cuya suposición resultó falsa. El resultado (tokens y
+// errores) es idéntico al de analizadorLexico.
+//
+// Cada fragmento interna sus identificadores en una TablaCadenas propia;
+// al unir, sus ids se traducen a los de cadenasGlobales().
+//
+// Con un LimiteErrores, cada fragmento se detiene al llegar al máximo por
+// su cuenta (nunca necesita más), las rachas de errores que cruzan un
+// corte se agrupan al unir y el fragmento donde se agota el límite se
+// vuelve a analizar con el estado real para cortar en el mismo punto que
+// el análisis en serie.
+
+namespace detalle_paralelo {
+
+// Tamaño mínimo de un fragmento; por debajo no compensa repartir
+constexpr size_t TAM_MINIMO_FRAGMENTO = size_t(1) << 20;
+
+struct Fragmento {
+    size_t inicio = 0;
+    size_t fin = 0;
+    int lineaInicial = 1;
+    std::vector<Token> tokens;
+    std::vector<Error> errores;
+    std::vector<size_t> llamadas;  // Por error: índice local del token de la llamada que lo reportó
+    TablaCadenas cadenas;
+    EstadoLexico salida;
+    bool conocioBuffer = true;
+    bool conocioTipo = true;
+    bool dependeDeEntrada = false;
+    bool empiezaConError = false;  // Su primer evento fue un error (puede unirse a una racha anterior)
+    bool huboEventos = false;      // Emitió algún token o error
+    LimiteErrores limite;          // Máximo propio, con la misma configuración que el global
+};
+
+// Ejecuta tarea(i) para i en [0, cantidad) repartiendo entre los hilos
+template <typename Tarea>
+void ejecutarEnParalelo(size_t cantidad, unsigned hilos, Tarea tarea) {
+    std::atomic<size_t> siguiente{0};
+    std::vector<std::exception_ptr> fallos(hilos);
+    auto trabajador = [&](unsigned id) {
+        try {
+            for (size_t i = siguiente++; i < cantidad; i = siguiente++) tarea(i);
+        } catch (...) {
+            fallos[id] = std::current_exception();
+            siguiente = cantidad; // Los demás dejan de tomar trabajo
+        }
+    };
+
+    std::vector<std::thread> grupo;
+    for (unsigned id = 1; id < hilos; ++id) grupo.emplace_back(trabajador, id);
+    trabajador(0);
+    for (auto& hilo : grupo) hilo.join();
+
+    for (auto& fallo : fallos) {
+        if (fallo) std::rethrow_exception(fallo);
+    }
+}
+
+// Con limite, analiza contra ese límite (el global, en el fragmento donde
+// se agota) y entrega el fin de archivo aunque el fragmento no sea el último
+inline void analizarFragmento(std::string_view fuente, Fragmento& fragmento, const EstadoLexico& entrada,
+                              bool especulativo, bool limitado, LimiteErrores* limite = nullptr) {
+    fragmento.tokens.clear();
+    fragmento.cadenas = TablaCadenas();
+    size_t erroresPrevios = fragmento.errores.size(); // Solo distinto de 0 con limite
+    fragmento.llamadas.resize(erroresPrevios);
+    AnalizadorLexico lexer(fuente, fragmento.errores, entrada, fragmento.fin, especulativo);
+    lexer.usarCadenas(fragmento.cadenas);
+    if (limite) {
+        lexer.usarLimite(*limite);
+    } else if (limitado) {
+        fragmento.limite.reiniciar();
+        lexer.usarLimite(fragmento.limite);
+    }
+    bool primero = true;
+    while (true) {
+        Token token = lexer.siguiente();
+        if (primero) fragmento.empiezaConError = fragmento.errores.size() > erroresPrevios;
+        primero = false;
+        // Un error antes del corte pertenece a la llamada que entrega el
+        // primer token del fragmento siguiente: el mismo índice global
+        fragmento.llamadas.resize(fragmento.errores.size(), fragmento.tokens.size());
+        // Solo el último fragmento aporta el TOKEN_EOF real
+        if (token.type == TOKEN_EOF && fragmento.fin < fuente.size() && !limite) break;
+        fragmento.tokens.push_back(token);
+        if (token.type == TOKEN_EOF) break;
+    }
+    fragmento.huboEventos = !fragmento.errores.empty() ||
+                            (!fragmento.tokens.empty() && fragmento.tokens.front().type != TOKEN_EOF);
+    fragmento.salida = lexer.estado();
+    fragmento.conocioBuffer = lexer.conocioBuffer();
+    fragmento.conocioTipo = lexer.conocioUltimoTipo();
+    fragmento.dependeDeEntrada = lexer.dependeDelEstadoPrevio();
+}
+
+} // namespace detalle_paralelo
+
+// Igual que analizadorLexico, pero repartiendo el trabajo entre varios
+// hilos (0 = tantos como núcleos). Los archivos de menos de dos
+// fragmentos se analizan en serie. llamadas, como en analizadorLexico.
+inline std::vector<Token> analizadorLexicoParalelo(std::string_view fuente, std::vector<Error>& errores,
+                                                   unsigned hilos = 0,
+                                                   size_t tamMinimoFragmento = detalle_paralelo::TAM_MINIMO_FRAGMENTO,
+                                                   LimiteErrores* limite = nullptr,
+                                                   std::vector<size_t>* llamadas = nullptr) {
+    using namespace detalle_paralelo;
+    if (hilos == 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+    if (tamMinimoFragmento == 0) tamMinimoFragmento = 1;
+    if (hilos == 1 || fuente.size() < 2 * tamMinimoFragmento) {
+        return analizadorLexico(fuente, errores, limite, llamadas);
+    }
+
+    const char* datos = fuente.data();
+    const size_t n = fuente.size();
+    const escaneo::Operaciones& busqueda = escaneo::operacionesActivas();
+
+    // 1. Cortes justo después de un '\n', unos cuatro fragmentos por hilo
+    size_t cantidadDeseada = std::min<size_t>(size_t(hilos) * 4, n / tamMinimoFragmento);
+    std::vector<Fragmento> fragmentos;
+    size_t inicio = 0;
+    for (size_t k = 1; k < cantidadDeseada && inicio < n; ++k) {
+        size_t salto = busqueda.buscarSalto(datos, n, std::max(inicio, k * (n / cantidadDeseada)));
+        if (salto + 1 >= n) break;
+        fragmentos.emplace_back();
+        fragmentos.back().inicio = inicio;
+        fragmentos.back().fin = salto + 1;
+        inicio = salto + 1;
+    }
+    fragmentos.emplace_back();
+    fragmentos.back().inicio = inicio;
+    fragmentos.back().fin = n;
+    const bool limitado = limite != nullptr;
+    if (limitado) {
+        for (auto& fragmento : fragmentos) fragmento.limite = LimiteErrores(limite->limite(), limite->agrupar());
+    }
+
+    // 2. Línea inicial de cada fragmento: saltos de línea anteriores
+    std::vector<size_t> saltos(fragmentos.size());
+    ejecutarEnParalelo(fragmentos.size(), hilos, [&](size_t i) {
+        size_t ultimo = 0;
+        saltos[i] = busqueda.contarSaltos(datos, fragmentos[i].inicio, fragmentos[i].fin, ultimo);
+    });
+    size_t acumulado = 0;
+    for (size_t i = 0; i < fragmentos.size(); ++i) {
+        fragmentos[i].lineaInicial = 1 + static_cast<int>(acumulado);
+        acumulado += saltos[i];
+    }
+
+    // 3. Análisis especulativo: fuera de comentario y en la columna 1
+    auto entradaSupuesta = [&](size_t i) {
+        EstadoLexico entrada; // El primer fragmento empieza en el estado inicial real
+        if (i == 0) return entrada;
+        entrada.pos = fragmentos[i].inicio;
+        entrada.linea = fragmentos[i].lineaInicial;
+        entrada.bufferVacio = false;
+        return entrada;
+    };
+    ejecutarEnParalelo(fragmentos.size(), hilos, [&](size_t i) {
+        fragmentos[i].errores.clear();
+        analizarFragmento(fuente, fragmentos[i], entradaSupuesta(i), i > 0, limitado);
+    });
+
+    // 4. Corrección secuencial con el estado real de entrada
+    std::vector<EstadoLexico> entradas(fragmentos.size());
+    EstadoLexico real; // Estado de entrada del primer fragmento
+    for (size_t i = 0; i < fragmentos.size(); ++i) {
+        Fragmento& fragmento = fragmentos[i];
+        real.pos = fragmento.inicio;
+        entradas[i] = real;
+        if (i > 0) {
+            bool suposicionValida = !real.enComentario && real.columna == 1 &&
+                                    real.linea == fragmento.lineaInicial &&
+                                    !(fragmento.dependeDeEntrada &&
+                                      (real.bufferVacio || (real.hayTokens && real.ultimoTipo == TOKEN_ASIGNACION)));
+            if (!suposicionValida) {
+                fragmento.errores.clear();
+                analizarFragmento(fuente, fragmento, real, false, limitado);
+            }
+        }
+
+        // Lo que el fragmento no llegó a definir se hereda de su entrada
+        EstadoLexico salida = fragmento.salida;
+        if (!fragmento.conocioBuffer) salida.bufferVacio = real.bufferVacio;
+        if (!fragmento.conocioTipo) {
+            salida.hayTokens = real.hayTokens;
+            salida.ultimoTipo = real.ultimoTipo;
+        }
+        if (!fragmento.huboEventos) salida.errorAbierto = real.errorAbierto;
+        real = salida;
+    }
+
+    // 5. Errores con límite: agrupar las rachas que cruzan un corte y
+    //    cortar en el fragmento donde se agota. origenes guarda, por cada
+    //    error agregado, su fragmento y su llamada local
+    std::vector<std::pair<size_t, size_t>> origenes;
+    size_t conservados = fragmentos.size();
+    if (limitado) {
+        size_t primerError = errores.size();
+        auto agregar = [&](size_t i, size_t desde) {
+            const Fragmento& fragmento = fragmentos[i];
+            errores.insert(errores.end(), fragmento.errores.begin() + desde, fragmento.errores.end());
+            for (size_t e = desde; e < fragmento.errores.size(); ++e) origenes.emplace_back(i, fragmento.llamadas[e]);
+        };
+        for (size_t i = 0; i < fragmentos.size(); ++i) {
+            Fragmento& fragmento = fragmentos[i];
+            bool unir = limite->agrupar() && entradas[i].errorAbierto && fragmento.empiezaConError &&
+                        errores.size() > primerError && mismoError(errores.back(), fragmento.errores.front());
+            size_t nuevos = fragmento.errores.size() - (unir ? 1 : 0);
+            if (limite->limite() != 0 && limite->registrados() + nuevos >= limite->limite()) {
+                // Se agota aquí: se repite en serie contra el límite global,
+                // continuando la racha abierta si la hay (conserva su origen)
+                fragmento.errores.clear();
+                bool continua = entradas[i].errorAbierto && errores.size() > primerError;
+                if (continua) {
+                    fragmento.errores.push_back(errores.back());
+                    errores.pop_back();
+                }
+                analizarFragmento(fuente, fragmento, entradas[i], false, true, limite);
+                if (continua) {
+                    errores.push_back(fragmento.errores.front());
+                    agregar(i, 1);
+                } else {
+                    agregar(i, 0);
+                }
+                conservados = i + 1;
+                break;
+            }
+            if (unir) extenderError(errores.back(), fragmento.errores.front());
+            agregar(i, unir ? 1 : 0);
+            limite->reiniciar(limite->registrados() + nuevos);
+        }
+        fragmentos.resize(conservados);
+    }
+
+    // 6. Unir los resultados en orden, traduciendo los ids de cada
+    //    fragmento (solo se internan en la global los textos distintos)
+    std::vector<std::vector<SimboloId>> traducciones(fragmentos.size());
+    TablaCadenas& globales = cadenasGlobales();
+    for (size_t i = 0; i < fragmentos.size(); ++i) {
+        const TablaCadenas& locales = fragmentos[i].cadenas;
+        traducciones[i].resize(locales.size());
+        for (SimboloId id = 0; id < locales.size(); ++id) {
+            traducciones[i][id] = globales.internar(locales.texto(id));
+        }
+    }
+    std::vector<size_t> desplazamientos(fragmentos.size() + 1, 0);
+    for (size_t i = 0; i < fragmentos.size(); ++i) {
+        desplazamientos[i + 1] = desplazamientos[i] + fragmentos[i].tokens.size();
+    }
+    std::vector<Token> tokens(desplazamientos.back());
+    ejecutarEnParalelo(fragmentos.size(), hilos, [&](size_t i) {
+        auto destino = tokens.begin() + desplazamientos[i];
+        for (const Token& token : fragmentos[i].tokens) {
+            *destino = token;
+            if (token.simbolo != SIN_SIMBOLO) destino->simbolo = traducciones[i][token.simbolo];
+            ++destino;
+        }
+        std::vector<Token>().swap(fragmentos[i].tokens);
+    });
+    if (!limitado) {
+        for (size_t i = 0; i < fragmentos.size(); ++i) {
+            errores.insert(errores.end(), fragmentos[i].errores.begin(), fragmentos[i].errores.end());
+            for (size_t llamada : fragmentos[i].llamadas) origenes.emplace_back(i, llamada);
+        }
+    }
+    if (llamadas) {
+        for (const auto& [fragmento, llamada] : origenes) llamadas->push_back(desplazamientos[fragmento] + llamada);
+    }
+    return tokens;
+}
+
+#endif // LEXER_PARALELO_H
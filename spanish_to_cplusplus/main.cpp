@@ -1,6 +1,12 @@
 #include "lexer.h"
 #include "parser.h"
 #include "semantic.h"
+#include "optimizador.h"
+#include "tokenStream.h"
+#include "lexerParalelo.h"
+#include "parserParalelo.h"
+#include "arbolBinario.h"
+#include "cacheCompilacion.h"
 #include "jsonParser.h"
 
 #include <iostream>
@@ -8,24 +14,25 @@
 #include <vector>
 #include <string>
 #include <iomanip>
+#include <memory>
+#include <cstdlib>
+
+// Anchos de columna de la tabla de tokens
+const int ANCHO_TOKEN = 18;
+const int ANCHO_TIPO = 21;
+const int ANCHO_LINEA = 6;
+const int ANCHO_COLUMNA = 8;
+
+// La tabla de tokens se imprime a medida que el parser pide los tokens:
+// primero el encabezado, una fila por token y el borde inferior al final
+void imprimirBordeTokens() {
+    std::cout << "\033[1;34m+" << std::string(ANCHO_TOKEN + 1, '-') 
+              << "+" << std::string(ANCHO_TIPO + 1, '-')
+              << "+" << std::string(ANCHO_LINEA + 1, '-')
+              << "+" << std::string(ANCHO_COLUMNA + 1, '-') << "+\033[0m\n";
+}
 
-void imprimirTokens(const std::vector<Token>& tokens) {
-    // Verificar si la lista de tokens está vacía
-    if (tokens.empty()) return;
-
-    /*for (const auto& token : tokens) {
-            std::cout << "Token: " << token.value 
-                    << " (Tipo: " << tokenTypeToString(token.type)
-                    << ", Linea: " << token.line 
-                    << ", Columna: " << token.column << ")" << std::endl;
-        }*/
-
-    // Definir anchos de columna
-    const int ANCHO_TOKEN = 18;
-    const int ANCHO_TIPO = 21;
-    const int ANCHO_LINEA = 6;
-    const int ANCHO_COLUMNA = 8;
-
+void imprimirEncabezadoTokens() {
     // Bordes de la tabla en azul
     std::cout << "\033[1;34m" << std::left
               << "\n+" << std::string(ANCHO_TOKEN + 1, '-') 
@@ -40,56 +47,143 @@ void imprimirTokens(const std::vector<Token>& tokens) {
               << "| " << std::setw(ANCHO_COLUMNA) << "Columna" << "|\033[0m\n";
 
     // Separador en azul
-    std::cout << "\033[1;34m+" << std::string(ANCHO_TOKEN + 1, '-') 
-              << "+" << std::string(ANCHO_TIPO + 1, '-')
-              << "+" << std::string(ANCHO_LINEA + 1, '-')
-              << "+" << std::string(ANCHO_COLUMNA + 1, '-') << "+\033[0m\n";
-
-    // Filas de datos
-    for (const auto& token : tokens) {
-        std::cout << "| " << std::setw(ANCHO_TOKEN) << token.value.substr(0, ANCHO_TOKEN)
-                  << "| " << std::setw(ANCHO_TIPO) << tokenTypeToString(token.type)
-                  << "| " << std::setw(ANCHO_LINEA) << token.line
-                  << "| " << std::setw(ANCHO_COLUMNA) << token.column << "|\n";
-    }
-
-    // Bordes inferiores en azul
-    std::cout << "\033[1;34m+" << std::string(ANCHO_TOKEN + 1, '-') 
-              << "+" << std::string(ANCHO_TIPO + 1, '-')
-              << "+" << std::string(ANCHO_LINEA + 1, '-')
-              << "+" << std::string(ANCHO_COLUMNA + 1, '-') << "+\033[0m\n";
-
+    imprimirBordeTokens();
+}
 
-    // Generar JSON de tokens
-    GeneradorJSON::generarJsonTokens(tokens, "./out/tokens.json");
+void imprimirFilaToken(const Token& token) {
+    std::cout << "| " << std::setw(ANCHO_TOKEN) << token.value.substr(0, ANCHO_TOKEN)
+              << "| " << std::setw(ANCHO_TIPO) << tokenTypeToString(token.type)
+              << "| " << std::setw(ANCHO_LINEA) << token.line
+              << "| " << std::setw(ANCHO_COLUMNA) << token.column << "|\n";
 }
 
 
 int main(int argc, char* argv[]) {
     std::vector<Error> erroresGlobales;
     std::string ruta;
-
-    if (argc > 1) {
-        ruta = argv[1];
-    } else {
+    unsigned hilos = 1; // --hilos N: análisis léxico y de bloques en paralelo (0 = todos los núcleos)
+    size_t maxErrores = 1000; // --max-errors N: detener el análisis tras N errores (0 = sin límite)
+    std::string rutaCache; // --cache DIR: reutilizar compilaciones del mismo fuente con las mismas opciones
+    uint64_t maxCacheMb = 512; // --cache-max-mb N: tamaño máximo de la caché
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argumento = argv[i];
+        if (argumento == "--hilos" && i + 1 < argc) {
+            hilos = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argumento == "--max-errors" && i + 1 < argc) {
+            maxErrores = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (argumento == "--cache" && i + 1 < argc) {
+            rutaCache = argv[++i];
+        } else if (argumento == "--cache-max-mb" && i + 1 < argc) {
+            maxCacheMb = std::strtoull(argv[++i], nullptr, 10);
+        } else if (ruta.empty()) {
+            ruta = argumento;
+        }
+    }
+    if (ruta.empty()) {
         std::cout << "Ingrese la ruta del archivo: ";
         std::getline(std::cin, ruta);
     }
 
-    std::ifstream archivo(ruta);
-    if (!archivo.is_open()) {
+    CodigoFuente fuente = CodigoFuente::desdeArchivo(ruta);
+    if (!fuente.estaAbierto()) {
         std::cerr << "Error: No se pudo abrir el archivo '" << ruta << "'." << std::endl;
         return 1;
     }
-    
+
+    // Con caché, un fuente ya compilado con las mismas opciones no se
+    // vuelve a analizar: se restauran sus archivos de out/ y su consola.
+    // Si no está, se compila capturando la consola para guardarla después.
+    std::unique_ptr<CacheCompilacion> cache;
+    ClaveCache clave;
+    std::unique_ptr<CapturaSalida> capturaConsola, capturaErrores;
+    if (!rutaCache.empty()) {
+        cache = std::make_unique<CacheCompilacion>(rutaCache, maxCacheMb << 20);
+        // --hilos entra en la clave aunque la salida deba ser la misma con
+        // cualquier cantidad: si los dos caminos llegaran a diferir, la
+        // entrada de uno no debe servirse al otro
+        clave = CacheCompilacion::calcularClave(
+            fuente.texto(), "hilos=" + std::to_string(hilos) + ";max-errors=" + std::to_string(maxErrores));
+        std::string consola, errores;
+        if (cache->restaurar(clave, "./out", consola, errores)) {
+            std::cout << consola;
+            std::cerr << errores;
+            return 0;
+        }
+        capturaConsola = std::make_unique<CapturaSalida>(std::cout);
+        capturaErrores = std::make_unique<CapturaSalida>(std::cerr);
+    }
+    // Con o sin caché, las salidas anteriores se borran antes de escribir:
+    // una corrida con --cache pudo dejarlas enlazadas a una entrada, y
+    // escribir encima de un enlace cambiaría la entrada
+    CacheCompilacion::prepararSalidas("./out");
+    bool completa = false;
+
     try {
-        auto tokens = analizadorLexico(archivo, erroresGlobales);
-        std::cout << "\n\033[1;34mTabla de Simbolos\033[0m\n";
-        imprimirTokens(tokens);
-        std::cout << "Analisis lexico completado! \nIniciando analisis sintactico" << std::endl;
+        // El parser pide los tokens al lexer bajo demanda; la tabla y
+        // tokens.json se escriben a medida que pasan por el flujo. Con
+        // varios hilos el lexer corre completo antes, los cuerpos largos de
+        // configurar y bucle_principal se analizan por tramos en paralelo y
+        // el flujo recorre la lista resultante, guardada en columnas.
+        // Con un solo hilo no se arma el BufferTokens a propósito: el flujo
+        // ya retiene solo una ventana de 16 tokens, y el parser mira los
+        // tipos en esa ventana, no recorre una lista. Lexar todo a columnas
+        // antes de analizar sube el lexer+parser de 0.45 s a 0.78 s en un
+        // programa generado de 16 MB y la memoria pasa a crecer con el archivo.
+        // El límite de errores es común al lexer y al parser; las rachas de
+        // errores léxicos idénticos cuentan (y se muestran) como uno solo.
+        std::vector<Error> erroresLexicos;
+        LimiteErrores limite(maxErrores);
+        AnalizadorLexico lexer(fuente.texto(), erroresLexicos);
+        lexer.usarLimite(limite);
+        std::unique_ptr<TokenStream> flujoPtr;
+        std::vector<TramoInstrucciones> tramos;
+        if (hilos == 1) {
+            flujoPtr = std::make_unique<TokenStream>(lexer);
+        } else {
+            // El lexer adelantado se detiene en su propio tope; sus errores
+            // se cobran al límite común cuando el flujo llega a su token,
+            // así que se corta en el mismo token que con un solo hilo
+            LimiteErrores topeLexico(maxErrores);
+            std::vector<Error> erroresAdelantados;
+            std::vector<size_t> llamadas;
+            std::vector<Token> tokens = analizadorLexicoParalelo(fuente.texto(), erroresAdelantados, hilos,
+                                                                 detalle_paralelo::TAM_MINIMO_FRAGMENTO, &topeLexico,
+                                                                 &llamadas);
+            tramos = analizarTramosEnParalelo(tokens, hilos);
+            flujoPtr = std::make_unique<TokenStream>(BufferTokens::desdeTokens(fuente.texto(), tokens));
+            flujoPtr->diferirErroresLexicos(fuente.texto(), std::move(erroresAdelantados), std::move(llamadas),
+                                            erroresLexicos, limite);
+        }
+        TokenStream& flujo = *flujoPtr;
+        EscritorJsonTokens jsonTokens("./out/tokens.json");
 
-        Parser parser(tokens, erroresGlobales);
+        std::cout << "\n\033[1;34mTabla de Simbolos\033[0m\n";
+        imprimirEncabezadoTokens();
+        flujo.alConsumir([&](const Token& token) {
+            imprimirFilaToken(token);
+            jsonTokens.agregar(token);
+        });
+        flujo.alTerminar([&]() {
+            imprimirBordeTokens();
+            jsonTokens.cerrar();
+            std::cout << "Analisis lexico completado! \nIniciando analisis sintactico" << std::endl;
+        });
+
+        Parser parser(flujo, erroresGlobales);
+        parser.usarLimite(limite);
+        parser.usarTramos(tramos);
         auto ast = parser.analizar();
+        flujo.drenar();
+
+        // Los errores léxicos van primero, como cuando el lexer terminaba antes del parser
+        erroresGlobales.insert(erroresGlobales.begin(), erroresLexicos.begin(), erroresLexicos.end());
+        if (limite.agotado()) {
+            erroresGlobales.push_back({
+                "Se alcanzo el maximo de " + std::to_string(limite.limite()) + " errores; analisis detenido",
+                0, 0, "General"
+            });
+        }
 
         if (erroresGlobales.empty()) {
             std::cout << "Analisis sintactico completado! \nIniciando analisis semantico" << std::endl;
@@ -101,6 +195,14 @@ int main(int argc, char* argv[]) {
             jsonAst << parser.generarJsonAST(ast) << std::endl;
             jsonAst.close();
 
+            // Y en binario, para las herramientas que lo abren con mmap
+            if (!guardarArbolBinario(ArbolPlano::desdeArbol(ast.get()), "./out/ast.bin")) {
+                std::cerr << "Error: No se pudo escribir './out/ast.bin'." << std::endl;
+            }
+
+            // Calcular al compilar las operaciones con operandos constantes
+            plegarConstantes(ast);
+
             // Realizar el análisis semántico
             AnalizadorSemantico semantico(erroresGlobales, parser.obtenerTablaSimbolos());
             semantico.analizar(ast.get());
@@ -125,7 +227,7 @@ int main(int argc, char* argv[]) {
             }
         }   
 
-         
+        completa = true;
     } catch (const std::bad_alloc&) {
         std::cerr << "\nERROR CRÍTICO: Memoria insuficiente. Verifique errores de bucle infinito\n";
         return EXIT_FAILURE;
@@ -133,6 +235,9 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: " << e.what() << std::endl;
     }
 
-    archivo.close();    
+    if (cache && completa) {
+        std::cout.flush();
+        cache->guardar(clave, "./out", capturaConsola->texto(), capturaErrores->texto());
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#ifndef OPTIMIZADOR_H
+#define OPTIMIZADOR_H
+
+#include "parser.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+
+// Plegado de constantes: las operaciones binarias cuyos operandos se
+// conocen al compilar se reemplazan por un literal con el resultado, así
+// salida.cpp lleva la constante ya calculada en lugar de hacer la cuenta
+// en el microcontrolador.
+//
+// Son constantes los literales enteros y decimales y las variables
+// enteras o decimales declaradas con un valor constante. El lenguaje
+// todavía no tiene asignaciones, así que ninguna declaración se reasigna;
+// cuando las tenga, las variables asignadas deberán quedar fuera.
+// Una variable sola no se reemplaza por su valor: solo se pliegan
+// operaciones.
+//
+// La aritmética sigue a la de C++ en la placa: entre enteros es entera
+// (la división trunca) y solo se pliega si el resultado entra en el int
+// de 16 bits de las placas AVR; si hay un decimal se calcula en float.
+// Las divisiones por cero y los resultados no finitos quedan sin plegar.
+class PlegadorConstantes : public VisitanteAST<PlegadorConstantes> {
+    friend class VisitanteAST<PlegadorConstantes>;
+
+public:
+    explicit PlegadorConstantes(Arena& arena) : arena(arena) {}
+
+private:
+    struct Constante {
+        bool decimal = false;
+        int64_t entero = 0;
+        float real = 0;
+
+        float comoReal() const { return decimal ? real : static_cast<float>(entero); }
+    };
+
+    static constexpr int64_t ENTERO_MINIMO = -32768;
+    static constexpr int64_t ENTERO_MAXIMO = 32767;
+
+    Arena& arena;
+    std::unordered_map<SimboloId, Constante> constantes; // Variables con valor conocido
+
+    void visitarPrograma(NodoPrograma* programa) {
+        for (Nodo* decl : programa->declaraciones) {
+            if (decl) visitar(decl);
+        }
+    }
+
+    void visitarDeclaracion(NodoDeclaracion* decl) {
+        if (!decl->expresion) return;
+        decl->expresion = plegar(decl->expresion);
+
+        // El valor se convierte al tipo declarado, como en la inicialización de C++
+        Constante valor;
+        if (!constante(decl->expresion, valor)) return;
+        if (decl->tipoDeclarado == ENTERO) {
+            if (valor.decimal) {
+                if (!(valor.real >= ENTERO_MINIMO && valor.real <= ENTERO_MAXIMO)) return;
+                valor = Constante{false, static_cast<int64_t>(valor.real), 0};
+            }
+            constantes[decl->simbolo] = valor;
+        } else if (decl->tipoDeclarado == DECIMAL) {
+            constantes[decl->simbolo] = Constante{true, 0, valor.comoReal()};
+        }
+    }
+
+    void visitarConfigurar(NodoConfigurar* config) {
+        for (Nodo* instruccion : config->instrucciones) visitar(instruccion);
+    }
+
+    void visitarBuclePrincipal(NodoBuclePrincipal* bucle) {
+        for (Nodo* instruccion : bucle->instrucciones) visitar(instruccion);
+    }
+
+    void visitarLlamadaFuncion(NodoLlamadaFuncion* llamada) {
+        for (NodoExpresion*& argumento : llamada->argumentos) argumento = plegar(argumento);
+    }
+
+    // Devuelve la expresión plegada (la misma si no se pudo)
+    NodoExpresion* plegar(NodoExpresion* expr) {
+        auto operacion = comoNodo<NodoOperacionBinaria>(expr);
+        if (!operacion) return expr;
+        operacion->izquierda = plegar(operacion->izquierda);
+        operacion->derecha = plegar(operacion->derecha);
+
+        Constante a, b;
+        if (!constante(operacion->izquierda, a) || !constante(operacion->derecha, b)) return expr;
+
+        auto literal = arena.crear<NodoLiteral>();
+        literal->linea = operacion->linea;
+        literal->columna = operacion->columna;
+        if (precedenciaOperador(operacion->operador) == 1) {
+            bool resultado;
+            if (!comparar(operacion->operador, a, b, resultado)) return expr;
+            literal->valor = resultado ? "true" : "false";
+            literal->tipoDato = textoTipoDato(BOOLEANO);
+            return literal;
+        }
+
+        Constante resultado;
+        if (!operar(operacion->operador, a, b, resultado)) return expr;
+        literal->valor = arena.copiarTexto(texto(resultado));
+        literal->tipoDato = textoTipoDato(resultado.decimal ? DECIMAL : ENTERO);
+        return literal;
+    }
+
+    // Valor de un literal numérico o de una variable constante
+    bool constante(NodoExpresion* expr, Constante& valor) const {
+        if (auto variable = comoNodo<NodoVariable>(expr)) {
+            auto it = constantes.find(variable->simbolo);
+            if (it == constantes.end()) return false;
+            valor = it->second;
+            return true;
+        }
+        auto literal = comoNodo<NodoLiteral>(expr);
+        if (!literal) return false;
+        const char* inicio = literal->valor.data();
+        const char* fin = inicio + literal->valor.size();
+        if (literal->tipoDato == textoTipoDato(ENTERO)) {
+            valor.decimal = false;
+            auto [ptr, ec] = std::from_chars(inicio, fin, valor.entero);
+            return ec == std::errc() && ptr == fin && valor.entero >= ENTERO_MINIMO && valor.entero <= ENTERO_MAXIMO;
+        }
+        if (literal->tipoDato == textoTipoDato(DECIMAL)) {
+            std::string copia(literal->valor);
+            char* finNumero = nullptr;
+            valor.decimal = true;
+            valor.real = std::strtof(copia.c_str(), &finNumero);
+            return finNumero == copia.c_str() + copia.size() && std::isfinite(valor.real);
+        }
+        return false;
+    }
+
+    static bool operar(TokenType operador, const Constante& a, const Constante& b, Constante& resultado) {
+        if (a.decimal || b.decimal) {
+            float x = a.comoReal(), y = b.comoReal();
+            resultado.decimal = true;
+            switch (operador) {
+                case TOKEN_MAS: resultado.real = x + y; break;
+                case TOKEN_MENOS: resultado.real = x - y; break;
+                case TOKEN_MULT: resultado.real = x * y; break;
+                case TOKEN_DIV:
+                    if (y == 0) return false;
+                    resultado.real = x / y;
+                    break;
+                default: return false;
+            }
+            return std::isfinite(resultado.real);
+        }
+        resultado.decimal = false;
+        switch (operador) {
+            case TOKEN_MAS: resultado.entero = a.entero + b.entero; break;
+            case TOKEN_MENOS: resultado.entero = a.entero - b.entero; break;
+            case TOKEN_MULT: resultado.entero = a.entero * b.entero; break;
+            case TOKEN_DIV:
+                if (b.entero == 0) return false;
+                resultado.entero = a.entero / b.entero;
+                break;
+            default: return false;
+        }
+        return resultado.entero >= ENTERO_MINIMO && resultado.entero <= ENTERO_MAXIMO;
+    }
+
+    static bool comparar(TokenType operador, const Constante& a, const Constante& b, bool& resultado) {
+        if (a.decimal || b.decimal) {
+            float x = a.comoReal(), y = b.comoReal();
+            switch (operador) {
+                case TOKEN_IGUALDAD: resultado = x == y; return true;
+                case TOKEN_DESIGUALDAD: resultado = x != y; return true;
+                case TOKEN_MENOR_QUE: resultado = x < y; return true;
+                case TOKEN_MENOR_IGUAL: resultado = x <= y; return true;
+                case TOKEN_MAYOR_QUE: resultado = x > y; return true;
+                case TOKEN_MAYOR_IGUAL: resultado = x >= y; return true;
+                default: return false;
+            }
+        }
+        switch (operador) {
+            case TOKEN_IGUALDAD: resultado = a.entero == b.entero; return true;
+            case TOKEN_DESIGUALDAD: resultado = a.entero != b.entero; return true;
+            case TOKEN_MENOR_QUE: resultado = a.entero < b.entero; return true;
+            case TOKEN_MENOR_IGUAL: resultado = a.entero <= b.entero; return true;
+            case TOKEN_MAYOR_QUE: resultado = a.entero > b.entero; return true;
+            case TOKEN_MAYOR_IGUAL: resultado = a.entero >= b.entero; return true;
+            default: return false;
+        }
+    }
+
+    // Literal de C++: el float más corto que lo representa, siempre con
+    // punto o exponente para que no se lea como entero
+    static std::string texto(const Constante& valor) {
+        if (!valor.decimal) return std::to_string(valor.entero);
+        char buffer[32];
+        auto [fin, ec] = std::to_chars(buffer, buffer + sizeof(buffer), valor.real);
+        std::string resultado(buffer, ec == std::errc() ? fin : buffer);
+        if (resultado.find_first_of(".e") == std::string::npos) resultado += ".0";
+        return resultado;
+    }
+};
+
+// Pliega las operaciones constantes del árbol; los literales nuevos van al
+// arena del mismo árbol
+inline void plegarConstantes(ArbolSintactico& arbol) {
+    if (!arbol) return;
+    PlegadorConstantes(arbol.memoria()).visitar(arbol.get());
+}
+
+#endif // OPTIMIZADOR_H
@@ -2,9 +2,13 @@
 #define PARSER_H
 
 #include "lexer.h"
+#include "tokenStream.h"
+#include "bufferTokens.h"
 #include "simbolos.h"
 #include "errores.h"
+#include "arena.h"
 #include <vector>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <iostream>
@@ -25,129 +29,422 @@ enum TipoNodo {
     NODO_CONFIGURAR,
     NODO_BUCLE_PRINCIPAL,
     NODO_LLAMADA_FUNCION,
+    NODO_OPERACION_BINARIA,
 };
 
-// Tipo básico para expresiones
-enum class TipoExpresion {
-    VARIABLE,
-    LITERAL,
-    OPERACION
-};
-
+// Los nodos se crean en el Arena de su ArbolSintactico y se liberan todos
+// juntos sin llamar a sus destructores: textos y listas de hijos son vistas
+// sobre el mismo arena, nunca memoria propia del nodo.
+//
+// tipo es la única etiqueta de clase del nodo: la fija el constructor de
+// cada estructura (su TIPO) y es lo que usan comoNodo() y VisitanteAST
+// para despachar, sin RTTI.
 struct Nodo {
-    virtual ~Nodo() = default;
     TipoNodo tipo;
-    int linea;
-    int columna;
+    int linea = 0;
+    int columna = 0;
+
+protected:
+    explicit Nodo(TipoNodo tipo) : tipo(tipo) {}
 };
 
+// Literales y variables
 struct NodoExpresion : public Nodo {
-    TipoExpresion tipo;
+protected:
+    using Nodo::Nodo;
 };
 
+// tipoDato guarda el TipoDato como un texto de un carácter cuyo valor es el
+// del enum, igual que cuando era un std::string asignado desde el TipoDato
+// (semantic.h lo compara con "CADENA" y esa comparación no cambia)
+inline std::string_view textoTipoDato(TipoDato tipo) {
+    static const char codigos[] = {ENTERO, DECIMAL, CADENA, BOOLEANO, INDEFINIDO};
+    return std::string_view(codigos + tipo, 1);
+}
+
 struct NodoLiteral : public NodoExpresion {
-    std::string valor;
-    std::string tipoDato;  // Nuevo miembro requerido
+    static constexpr TipoNodo TIPO = NODO_LITERAL;
+    std::string_view valor;
+    std::string_view tipoDato;  // Nuevo miembro requerido
     
-    NodoLiteral() {
-        tipo = TipoExpresion::LITERAL;
-    }
+    NodoLiteral() : NodoExpresion(TIPO) {}
 };
 
 struct NodoVariable : public NodoExpresion {
-    std::string nombre;
-    std::string tipoDato;  // Nuevo miembro requerido
+    static constexpr TipoNodo TIPO = NODO_VARIABLE;
+    SimboloId simbolo = SIN_SIMBOLO; // Nombre internado
+    std::string_view tipoDato;  // Nuevo miembro requerido
     
-    NodoVariable() {
-        tipo = TipoExpresion::VARIABLE;
+    NodoVariable() : NodoExpresion(TIPO) {}
+
+    std::string_view nombre() const { return cadenasGlobales().texto(simbolo); }
+};
+
+// Precedencia de los operadores binarios (0 si el token no es uno):
+// comparaciones < suma y resta < producto y división
+inline int precedenciaOperador(TokenType tipo) {
+    switch (tipo) {
+        case TOKEN_IGUALDAD: case TOKEN_DESIGUALDAD:
+        case TOKEN_MENOR_QUE: case TOKEN_MENOR_IGUAL:
+        case TOKEN_MAYOR_QUE: case TOKEN_MAYOR_IGUAL: return 1;
+        case TOKEN_MAS: case TOKEN_MENOS: return 2;
+        case TOKEN_MULT: case TOKEN_DIV: return 3;
+        default: return 0;
+    }
+}
+
+// Operador en C++ (y en el código fuente)
+inline const char* textoOperador(TokenType tipo) {
+    switch (tipo) {
+        case TOKEN_IGUALDAD: return "==";
+        case TOKEN_DESIGUALDAD: return "!=";
+        case TOKEN_MENOR_QUE: return "<";
+        case TOKEN_MENOR_IGUAL: return "<=";
+        case TOKEN_MAYOR_QUE: return ">";
+        case TOKEN_MAYOR_IGUAL: return ">=";
+        case TOKEN_MAS: return "+";
+        case TOKEN_MENOS: return "-";
+        case TOKEN_MULT: return "*";
+        case TOKEN_DIV: return "/";
+        default: return "?";
     }
+}
+
+struct NodoOperacionBinaria : public NodoExpresion {
+    static constexpr TipoNodo TIPO = NODO_OPERACION_BINARIA;
+    TokenType operador = TOKEN_MAS;
+    NodoExpresion* izquierda = nullptr;
+    NodoExpresion* derecha = nullptr;
+
+    NodoOperacionBinaria() : NodoExpresion(TIPO) {}
 };
 
+// Un operando va entre paréntesis si su operador liga menos que el del
+// padre, o igual a la derecha (todos los operadores asocian a izquierda)
+inline bool necesitaParentesis(const NodoExpresion* operando, TokenType operadorPadre, bool aLaDerecha) {
+    if (operando->tipo != NODO_OPERACION_BINARIA) return false;
+    int propia = precedenciaOperador(static_cast<const NodoOperacionBinaria*>(operando)->operador);
+    int padre = precedenciaOperador(operadorPadre);
+    return propia < padre || (aLaDerecha && propia == padre);
+}
+
 struct NodoLlamadaFuncion : public Nodo {
-    std::string nombre;
-    std::vector<std::unique_ptr<NodoExpresion>> argumentos;
+    static constexpr TipoNodo TIPO = NODO_LLAMADA_FUNCION;
+    std::string_view nombre;
+    Lista<NodoExpresion*> argumentos;
+
+    NodoLlamadaFuncion() : Nodo(TIPO) {}
 };
 
 struct NodoDeclaracion : public Nodo {
-    std::string identificador;
-    std::unique_ptr<NodoExpresion> expresion;
-    TipoDato tipoDeclarado;
+    static constexpr TipoNodo TIPO = NODO_DECLARACION;
+    SimboloId simbolo = SIN_SIMBOLO; // Identificador internado
+    NodoExpresion* expresion = nullptr;
+    TipoDato tipoDeclarado = INDEFINIDO;
+
+    NodoDeclaracion() : Nodo(TIPO) {}
+
+    std::string_view identificador() const { return cadenasGlobales().texto(simbolo); }
 };
 
 struct NodoPrograma : public Nodo {
-    std::vector<std::unique_ptr<Nodo>> declaraciones;
+    static constexpr TipoNodo TIPO = NODO_PROGRAMA;
+    Lista<Nodo*> declaraciones;
+
+    NodoPrograma() : Nodo(TIPO) {}
 };
 
 struct NodoIncluir : public Nodo {
-    std::string archivo;
+    static constexpr TipoNodo TIPO = NODO_INCLUIR;
+    std::string_view archivo;
+
+    NodoIncluir() : Nodo(TIPO) {}
 };
 
 struct NodoConfigurar : public Nodo {
-    std::vector<std::unique_ptr<Nodo>> instrucciones;
+    static constexpr TipoNodo TIPO = NODO_CONFIGURAR;
+    Lista<Nodo*> instrucciones;
+
+    NodoConfigurar() : Nodo(TIPO) {}
 };
 
 struct NodoBuclePrincipal : public Nodo {
-    std::vector<std::unique_ptr<Nodo>> instrucciones;
+    static constexpr TipoNodo TIPO = NODO_BUCLE_PRINCIPAL;
+    Lista<Nodo*> instrucciones;
+
+    NodoBuclePrincipal() : Nodo(TIPO) {}
+};
+
+// Conversión comprobada por etiqueta (reemplaza a dynamic_cast): el nodo
+// como T, o nullptr si es de otro tipo
+template <typename T>
+T* comoNodo(Nodo* nodo) {
+    return nodo && nodo->tipo == T::TIPO ? static_cast<T*>(nodo) : nullptr;
+}
+
+template <typename T>
+const T* comoNodo(const Nodo* nodo) {
+    return nodo && nodo->tipo == T::TIPO ? static_cast<const T*>(nodo) : nullptr;
+}
+
+//--------------------------------------------------
+// Visitante del AST
+//--------------------------------------------------
+// Base CRTP para los recorridos del árbol (generación de código, JSON,
+// optimizaciones): visitar() despacha con un switch sobre la etiqueta y
+// llama al visitarX del visitante concreto, sin llamadas virtuales. Los
+// tipos que el visitante no redefine van a visitarOtro(), que por defecto
+// devuelve Resultado().
+template <typename Derivado, typename Resultado = void>
+class VisitanteAST {
+public:
+    Resultado visitar(Nodo* nodo) {
+        Derivado& visitante = static_cast<Derivado&>(*this);
+        switch (nodo->tipo) {
+            case NODO_PROGRAMA:        return visitante.visitarPrograma(static_cast<NodoPrograma*>(nodo));
+            case NODO_DECLARACION:     return visitante.visitarDeclaracion(static_cast<NodoDeclaracion*>(nodo));
+            case NODO_LITERAL:         return visitante.visitarLiteral(static_cast<NodoLiteral*>(nodo));
+            case NODO_VARIABLE:        return visitante.visitarVariable(static_cast<NodoVariable*>(nodo));
+            case NODO_INCLUIR:         return visitante.visitarIncluir(static_cast<NodoIncluir*>(nodo));
+            case NODO_CONFIGURAR:      return visitante.visitarConfigurar(static_cast<NodoConfigurar*>(nodo));
+            case NODO_BUCLE_PRINCIPAL: return visitante.visitarBuclePrincipal(static_cast<NodoBuclePrincipal*>(nodo));
+            case NODO_LLAMADA_FUNCION: return visitante.visitarLlamadaFuncion(static_cast<NodoLlamadaFuncion*>(nodo));
+            case NODO_OPERACION_BINARIA:
+                return visitante.visitarOperacionBinaria(static_cast<NodoOperacionBinaria*>(nodo));
+            default:                   return visitante.visitarOtro(nodo);
+        }
+    }
+
+protected:
+    Resultado visitarPrograma(NodoPrograma* nodo) { return otro(nodo); }
+    Resultado visitarDeclaracion(NodoDeclaracion* nodo) { return otro(nodo); }
+    Resultado visitarLiteral(NodoLiteral* nodo) { return otro(nodo); }
+    Resultado visitarVariable(NodoVariable* nodo) { return otro(nodo); }
+    Resultado visitarIncluir(NodoIncluir* nodo) { return otro(nodo); }
+    Resultado visitarConfigurar(NodoConfigurar* nodo) { return otro(nodo); }
+    Resultado visitarBuclePrincipal(NodoBuclePrincipal* nodo) { return otro(nodo); }
+    Resultado visitarLlamadaFuncion(NodoLlamadaFuncion* nodo) { return otro(nodo); }
+    Resultado visitarOperacionBinaria(NodoOperacionBinaria* nodo) { return otro(nodo); }
+    Resultado visitarOtro(Nodo*) { return Resultado(); }
+
+private:
+    Resultado otro(Nodo* nodo) { return static_cast<Derivado&>(*this).visitarOtro(nodo); }
+};
+
+// AST de una compilación: la raíz y el arena con todos sus nodos. Al
+// destruirse libera el árbol completo de una sola vez.
+class ArbolSintactico {
+public:
+    ArbolSintactico() = default;
+    ArbolSintactico(std::unique_ptr<Arena> arena, NodoPrograma* raiz)
+        : arena(std::move(arena)), raiz(raiz) {}
+    ArbolSintactico(ArbolSintactico&& otro) noexcept
+        : arena(std::move(otro.arena)), raiz(std::exchange(otro.raiz, nullptr)) {}
+    ArbolSintactico& operator=(ArbolSintactico&& otro) noexcept {
+        arena = std::move(otro.arena);
+        raiz = std::exchange(otro.raiz, nullptr);
+        return *this;
+    }
+
+    NodoPrograma* get() const { return raiz; }
+    NodoPrograma* operator->() const { return raiz; }
+    explicit operator bool() const { return raiz != nullptr; }
+
+    // Bytes reservados para nodos, textos y listas
+    size_t bytesReservados() const { return arena ? arena->bytesReservados() : 0; }
+
+    // Arena del árbol, para las pasadas que agregan nodos
+    Arena& memoria() { return *arena; }
+
+private:
+    std::unique_ptr<Arena> arena;
+    NodoPrograma* raiz = nullptr;
+};
+
+
+// Consulta a la tabla de símbolos hecha al analizar un elemento del
+// programa: el id y el estado que tenía el símbolo (estadoSimbolo). El
+// parser incremental las guarda para saber qué elementos dependen de qué
+// declaraciones.
+struct ConsultaSimbolo {
+    SimboloId id;
+    uint64_t estado;
 };
 
+// Lo que un elemento puede observar de un símbolo: si está declarado, su
+// tipo y su valor (la línea de declaración no afecta al análisis). 0 es
+// "no declarado".
+inline uint64_t estadoSimbolo(const Simbolo* simbolo) {
+    if (!simbolo) return 0;
+    uint64_t hash = 14695981039346656037ull;
+    hash = (hash ^ static_cast<uint64_t>(simbolo->tipo)) * 1099511628211ull;
+    for (unsigned char c : simbolo->valor) hash = (hash ^ c) * 1099511628211ull;
+    return hash | 1;
+}
+
+// Variable de una expresión cuya búsqueda en la tabla quedó pendiente: el
+// análisis en paralelo no conoce las declaraciones anteriores, así que
+// las resuelve al unir los tramos. error es cuántos errores del tramo la
+// preceden, para reportar "Variable no declarada" en el mismo orden.
+struct ReferenciaDiferida {
+    NodoVariable* variable;
+    size_t error;
+};
+
+// Instrucciones de un configurar o bucle_principal analizadas por
+// adelantado, fuera del orden del programa (ver parserParalelo.h). El
+// tramo empieza en la instrucción de la posición inicio y termina en la
+// primera que empiece en hasta o después, o al terminar el bloque.
+struct TramoInstrucciones {
+    size_t inicio = 0;
+    size_t hasta = 0;
+    bool bucle = false;        // bucle_principal o configurar
+    size_t fin = 0;            // Posición donde terminó
+    std::vector<Nodo*> instrucciones;
+    std::vector<Error> errores;
+    std::vector<ReferenciaDiferida> referencias;
+    std::unique_ptr<Arena> memoria = std::make_unique<Arena>(); // Nodos del tramo
+};
+
+// Punto de la lista de argumentos de una llamada desde el que el resto
+// de la lista solo depende de la posición: después de recuperarse de un
+// error, o donde la lista terminó. Una llamada sin cerrar se traga el
+// programa de error en error, y el análisis incremental anota estos
+// puntos para no volver a analizarla entera. Los conteos son de lo que
+// el parser llevaba hasta ahí.
+struct PuntoArgumentos {
+    size_t posicion;
+    NodoLlamadaFuncion* llamada;
+    size_t argumentos;
+    size_t errores;
+    size_t referencias;
+    bool fin;
+};
+
+// Lo que un análisis anterior sacó de la misma lista desde un punto hasta
+// otro, que se toma tal cual
+struct ArgumentosAnteriores {
+    Lista<NodoExpresion*> argumentos;
+    Lista<Error> errores;                  // Se mueven al tomarlos
+    size_t primerError = 0;                // Índice que tenía errores[0] en su análisis
+    Lista<ReferenciaDiferida> referencias;
+    size_t fin = 0;                        // Posición donde sigue la lista
+};
 
 //--------------------------------------------------
 // Clase principal del Parser
 //--------------------------------------------------
 class Parser {
+public:
+    // Resuelve los símbolos que no están en la tabla propia del parser
+    using ConsultaExterna = std::function<const Simbolo*(SimboloId)>;
+    using SeguirArgumentos = std::function<bool(const PuntoArgumentos&, ArgumentosAnteriores&)>;
+
 private:
-    std::vector<Token> tokens;
+    std::unique_ptr<TokenStream> flujoPropio; // Solo cuando el parser recibe un vector
+    TokenStream& flujo;
     size_t posActual = 0;
     TablaSimbolos tablaSimbolos;
-    std::unique_ptr<NodoPrograma> ast;
+    std::unique_ptr<Arena> arenaPropia; // Salvo que los nodos vayan a un arena ajeno
+    Arena* arena;
+    NodoPrograma* ast;
+
+    // Análisis por elementos (ver parserIncremental.h)
+    ConsultaExterna consultaExterna;
+    std::vector<ConsultaSimbolo>* consultas = nullptr;
+    SeguirArgumentos seguirArgumentos;
+
+    // Análisis en paralelo (ver parserParalelo.h)
+    std::vector<ReferenciaDiferida>* referenciasDiferidas = nullptr;
+    std::vector<TramoInstrucciones>* tramos = nullptr;
+    size_t siguienteTramo = 0;
+
+    // Pilas de trabajo: los hijos de cada bloque se apilan mientras se
+    // analizan y se copian juntos al arena al cerrarlo
+    std::vector<Nodo*> pilaNodos;
+    std::vector<NodoExpresion*> pilaExpresiones;
+    std::vector<const Simbolo*> resueltos; // Símbolos de las referencias de un tramo
 
     //Para insertar los errores en la tabla
     std::vector<Error>& errores;
+    LimiteErrores* limite = nullptr;
+
+    // Registra un error sintáctico o semántico si el límite lo permite
+    void reportar(Error error) {
+        if (limite && !limite->registrar()) return;
+        errores.push_back(std::move(error));
+    }
+
+    // Con el límite agotado el análisis termina como si llegara el fin del programa
+    bool detenido() const { return limite && limite->agotado(); }
 
     // Nueva estrategia de recuperación
     void recuperarError() {
         size_t posInicial = posActual;
-        // Avanza hasta encontrar un punto de sincronización
-        while (posActual < tokens.size() && 
-            actual().type != TOKEN_PUNTO_COMA && 
-            actual().type != TOKEN_LLAVE_DER && 
-            actual().type != TOKEN_FIN_PROGRAMA) {
-            posActual++;
+        // Avanza hasta encontrar un punto de sincronización: con el índice
+        // del lexer es un salto, sin él se recorren los tokens
+        if (!flujo.siguienteSincronizacion(posActual, posActual)) {
+            TokenType tipo;
+            while (flujo.tipoEn(posActual, tipo) && !BufferTokens::esSincronizacion(tipo)) {
+                posActual++;
+            }
         }
         if (posInicial == posActual) posActual++; // Prevenir loop
     }
 
     bool finalBloque() {
-        return actual().type == TOKEN_FIN_CONFIGURAR || 
-               actual().type == TOKEN_FIN_BUCLE ||
-               actual().type == TOKEN_FIN_PROGRAMA;
+        return tipoActual() == TOKEN_FIN_CONFIGURAR || 
+               tipoActual() == TOKEN_FIN_BUCLE ||
+               tipoActual() == TOKEN_FIN_PROGRAMA;
     }
 
     bool funcionesBuclePrincipal() {
-        return actual().type == TOKEN_ESCRIBIR || 
-               actual().type == TOKEN_ESPERAR;
+        return tipoActual() == TOKEN_ESCRIBIR || 
+               tipoActual() == TOKEN_ESPERAR;
     }
 
     // Helpers de análisis
-    Token& actual() {
-        if (posActual >= tokens.size()) {
-            static Token tokenError = {TOKEN_DESCONOCIDO, "", 0, 0};
-            if (posActual == tokens.size()) { // Solo registrar error una vez
-                errores.push_back({"Fin de archivo inesperado", tokens.back().line, tokens.back().column, "Sintactico"});
+    const Token& actual() {
+        const Token* token = flujo.en(posActual);
+        if (!token) {
+            static const Token tokenError = {TOKEN_DESCONOCIDO, SIN_SIMBOLO, "", 0, 0};
+            if (posActual == flujo.total()) { // Solo registrar error una vez
+                reportar({"Fin de archivo inesperado", flujo.ultimo().line, flujo.ultimo().column, "Sintactico"});
             }
             posActual++; // Evitar múltiples llamadas
             return tokenError;
         }
-        return tokens[posActual];
+        return *token;
     }
 
-    void avanzar() { if (posActual < tokens.size()) posActual++; }
+    // Solo el tipo del token actual; con un BufferTokens no arma el Token.
+    // Pasado el final se ve el fin del programa, para que ningún bucle de
+    // análisis siga avanzando sobre tokens que no existen.
+    TokenType tipoActual() {
+        if (detenido()) return TOKEN_FIN_PROGRAMA;
+        TokenType tipo;
+        if (flujo.tipoEn(posActual, tipo)) return tipo;
+        actual(); // Registra el fin de archivo inesperado
+        return TOKEN_FIN_PROGRAMA;
+    }
+
+    // Id internado del identificador actual. Los tokens que no vienen del
+    // lexer (listas armadas a mano) pueden no traerlo.
+    SimboloId simboloActual() {
+        const Token& token = actual();
+        return token.simbolo != SIN_SIMBOLO ? token.simbolo : cadenasGlobales().internar(token.value);
+    }
+
+    void avanzar() {
+        TokenType tipo;
+        if (flujo.tipoEn(posActual, tipo)) posActual++;
+    }
 
     void coincidir(TokenType esperado) {
-        if (actual().type != esperado) {
-            errores.push_back({
-                "Token inesperado. Esperado: " + tokenTypeToString(esperado) + 
-                ", Encontrado: " + tokenTypeToString(actual().type),
+        if (tipoActual() != esperado) {
+            reportar({
+                "Token inesperado. Esperado: " + std::string(tokenTypeToString(esperado)) + 
+                ", Encontrado: " + std::string(tokenTypeToString(tipoActual())),
                 actual().line, actual().column, "Sintactico"
             });
             recuperarError();
@@ -158,21 +455,134 @@ private:
 
 public:
 
+    // Comparte el límite de errores con el lexer (--max-errors)
+    void usarLimite(LimiteErrores& limiteErrores) { limite = &limiteErrores; }
+
     TablaSimbolos& obtenerTablaSimbolos() { 
             return tablaSimbolos; 
         }        
 
-    Parser(std::vector<Token> tokens, std::vector<Error>& errores) 
-        : tokens(std::move(tokens)), errores(errores), ast(new NodoPrograma) {
-        // Insertar token de fin automáticamente
-        if (!this->tokens.empty() && this->tokens.back().type != TOKEN_FIN_PROGRAMA) {
-            this->tokens.push_back({TOKEN_FIN_PROGRAMA, "", 0, 0});
-        }
-    }
+    // Analiza los tokens a medida que el flujo los produce
+    Parser(TokenStream& flujo, std::vector<Error>& errores)
+        : flujo(flujo), arenaPropia(std::make_unique<Arena>()), arena(arenaPropia.get()),
+          ast(arena->crear<NodoPrograma>()), errores(errores) {}
+
+    // Analiza una lista de tokens ya construida sin copiarla: la lista debe
+    // seguir viva mientras se use el parser. El token de fin lo agrega el
+    // flujo de forma virtual.
+    Parser(const std::vector<Token>& tokens, std::vector<Error>& errores)
+        : Parser(tokens.data(), tokens.size(), errores) {}
+
+    Parser(const Token* tokens, size_t cantidad, std::vector<Error>& errores)
+        : flujoPropio(std::make_unique<TokenStream>(tokens, cantidad)), flujo(*flujoPropio),
+          arenaPropia(std::make_unique<Arena>()), arena(arenaPropia.get()),
+          ast(arena->crear<NodoPrograma>()), errores(errores) {}
+
+    // Igual, pero los nodos se crean en un arena ajeno que debe vivir más
+    // que ellos (el parser incremental acumula ahí los de cada versión)
+    Parser(const Token* tokens, size_t cantidad, std::vector<Error>& errores, Arena& externa)
+        : flujoPropio(std::make_unique<TokenStream>(tokens, cantidad)), flujo(*flujoPropio),
+          arena(&externa), ast(arena->crear<NodoPrograma>()), errores(errores) {}
+
+    // Igual, recorriendo unos TokensEditables desde el índice desde
+    Parser(const TokensEditables& tokens, size_t desde, std::vector<Error>& errores, Arena& externa)
+        : flujoPropio(std::make_unique<TokenStream>(tokens, desde)), flujo(*flujoPropio),
+          arena(&externa), ast(arena->crear<NodoPrograma>()), errores(errores) {}
 
-    std::unique_ptr<NodoPrograma> analizar() {
+    // Se queda con una lista temporal (la mueve, no la copia)
+    Parser(std::vector<Token>&& tokens, std::vector<Error>& errores)
+        : flujoPropio(std::make_unique<TokenStream>(std::move(tokens))), flujo(*flujoPropio),
+          arenaPropia(std::make_unique<Arena>()), arena(arenaPropia.get()),
+          ast(arena->crear<NodoPrograma>()), errores(errores) {}
+
+    // Analiza tokens guardados en columnas (ver bufferTokens.h)
+    Parser(BufferTokens tokens, std::vector<Error>& errores)
+        : flujoPropio(std::make_unique<TokenStream>(std::move(tokens))), flujo(*flujoPropio),
+          arenaPropia(std::make_unique<Arena>()), arena(arenaPropia.get()),
+          ast(arena->crear<NodoPrograma>()), errores(errores) {}
+
+    // Con un arena ajeno el árbol devuelto no es dueño de sus nodos
+    ArbolSintactico analizar() {
         programa();
-        return std::move(ast);
+        return ArbolSintactico(std::move(arenaPropia), ast);
+    }
+
+    //--------------------------------------------------
+    // Análisis por elementos
+    //--------------------------------------------------
+    // El parser incremental analiza el programa de a un elemento de nivel
+    // superior (incluir, declaración, configurar, bucle_principal o un
+    // token inválido), desde la posición que elija.
+    size_t posicion() const { return posActual; }
+    void irA(size_t posicion) { posActual = posicion; }
+
+    void analizarEncabezado() { encabezado(); }
+    bool finDeElementos() { return tipoActual() == TOKEN_FIN_PROGRAMA; }
+    void analizarCierre() { coincidir(TOKEN_FIN_PROGRAMA); }
+
+    // Analiza el elemento que empieza en la posición actual. Devuelve false
+    // si no aporta una entrada a las declaraciones del programa (token
+    // inválido); si la aporta, nodo puede ser nulo cuando hubo un error.
+    bool analizarElemento(Nodo*& nodo) {
+        size_t antes = pilaNodos.size();
+        elementoPrograma();
+        if (pilaNodos.size() == antes) return false;
+        nodo = pilaNodos.back();
+        pilaNodos.pop_back();
+        return true;
+    }
+
+    // Los símbolos que no estén en la tabla propia se buscan aquí
+    void usarConsultaExterna(ConsultaExterna consulta) { consultaExterna = std::move(consulta); }
+
+    // Anota en destino cada consulta a la tabla (nullptr deja de anotar)
+    void anotarConsultas(std::vector<ConsultaSimbolo>* destino) { consultas = destino; }
+
+    // Los nodos que siguen se crean en destino: cada elemento y cada tramo
+    // de un cuerpo tienen su propio arena y se liberan al descartarlos
+    void usarArena(Arena& destino) { arena = &destino; }
+
+    // Avisa de cada PuntoArgumentos; si devuelve true, la lista sigue con
+    // lo que dejó en anteriores. Solo sin límite de errores.
+    void usarArgumentosAnteriores(SeguirArgumentos seguir) { seguirArgumentos = std::move(seguir); }
+
+    // Un configurar o bucle_principal también se analiza por partes, para
+    // reutilizar tramos de su cuerpo: analizarApertura consume el token que
+    // lo abre y devuelve su nodo todavía sin instrucciones, el cuerpo se
+    // analiza con analizarTramo hasta finDeCuerpo y analizarFinBloque
+    // consume el fin del bloque.
+    Nodo* analizarApertura() {
+        if (tipoActual() == TOKEN_CONFIGURAR) return abrirBloque<NodoConfigurar>();
+        return abrirBloque<NodoBuclePrincipal>();
+    }
+    bool finDeCuerpo() { return finalBloque(); }
+    void analizarFinBloque(bool bucle) { coincidir(bucle ? TOKEN_FIN_BUCLE : TOKEN_FIN_CONFIGURAR); }
+
+    //--------------------------------------------------
+    // Análisis en paralelo
+    //--------------------------------------------------
+    // Cada hilo analiza un tramo de instrucciones con su propio parser,
+    // que deja las variables sin resolver en destino. Los tokens deben
+    // traer su id internado (los del lexer lo traen), porque el hilo no
+    // puede internar en cadenasGlobales().
+    void diferirReferencias(std::vector<ReferenciaDiferida>* destino) { referenciasDiferidas = destino; }
+
+    // Analiza desde la posición actual el tramo de instrucciones que
+    // describe tramo y guarda sus nodos y la posición donde terminó
+    void analizarTramo(TramoInstrucciones& tramo, size_t base) {
+        instrucciones(tramo.bucle, tramo.hasta - base);
+        tramo.instrucciones.assign(pilaNodos.begin(), pilaNodos.end());
+        pilaNodos.clear();
+        tramo.fin = base + posActual;
+    }
+
+    // Tramos ya analizados (ordenados por inicio) que el análisis usa en
+    // lugar de volver a analizar, si el bloque pasa justo por su inicio.
+    // El parser se queda con la memoria de sus nodos.
+    void usarTramos(std::vector<TramoInstrucciones>& analizados) {
+        for (auto& tramo : analizados) arena->absorber(std::move(*tramo.memoria));
+        tramos = analizados.empty() ? nullptr : &analizados;
+        siguienteTramo = 0;
     }
 
     // Método para imprimir tabla de símbolos
@@ -184,8 +594,8 @@ public:
                 << std::setw(10) << "Linea"
                 << "Valor\n";
 
-        for (const auto& [nombre, simbolo] : tablaSimbolos.simbolos) {
-            std::cout << std::setw(20) << nombre
+        for (const auto& simbolo : tablaSimbolos.todos()) {
+            std::cout << std::setw(20) << simbolo.nombre()
                     << std::setw(15) << tipoDatoToString(simbolo.tipo)
                     << std::setw(10) << simbolo.lineaDeclaracion
                     << simbolo.valor << "\n"; // Mostramos el valor
@@ -197,15 +607,15 @@ public:
         std::cout << "\033[1;37m| Nombre             | Tipo          | Linea    | Valor             |\033[0m\n";
         std::cout << "\033[1;37m+--------------------+---------------+----------+-------------------+\033[0m\n";
     
-        for (const auto& [nombre, simbolo] : tablaSimbolos.simbolos) {
-            std::cout << "| " << std::setw(18) << nombre
+        for (const auto& simbolo : tablaSimbolos.todos()) {
+            std::cout << "| " << std::setw(18) << simbolo.nombre()
                       << "| " << std::setw(14) << tipoDatoToString(simbolo.tipo)
                       << "| " << std::setw(8) << simbolo.lineaDeclaracion
                       << "| " << std::setw(17) << simbolo.valor << " |\n";
         }
     }
     
-    std::string astToJson(const std::unique_ptr<NodoPrograma>& programa) {
+    std::string astToJson(const ArbolSintactico& programa) {
     std::stringstream json;
     json << "{\n";
     json << "  \"tipo\": \"Programa\",\n";
@@ -216,23 +626,23 @@ public:
         json << "    {\n";
         json << "      \"tipo\": \"" << tipoNodoToString(decl->tipo) << "\",\n";
         
-        if (auto nodoDecl = dynamic_cast<NodoDeclaracion*>(decl.get())) {
-            json << "      \"identificador\": \"" << nodoDecl->identificador << "\",\n";
+        if (auto nodoDecl = comoNodo<NodoDeclaracion>(decl)) {
+            json << "      \"identificador\": \"" << nodoDecl->identificador() << "\",\n";
             json << "      \"tipoDato\": \"" << tipoDatoToString(nodoDecl->tipoDeclarado) << "\",\n";
             if (nodoDecl->expresion) {
-                json << "      \"valor\": \"" << obtenerValorExpresion(nodoDecl->expresion.get()) << "\"\n";
+                json << "      \"valor\": \"" << obtenerValorExpresion(nodoDecl->expresion) << "\"\n";
             }
         }
-        else if (auto nodoConfig = dynamic_cast<NodoConfigurar*>(decl.get())) {
+        else if (auto nodoConfig = comoNodo<NodoConfigurar>(decl)) {
             json << "      \"instrucciones\": [\n";
             for (size_t j = 0; j < nodoConfig->instrucciones.size(); ++j) {
-                if (auto llamada = dynamic_cast<NodoLlamadaFuncion*>(nodoConfig->instrucciones[j].get())) {
+                if (auto llamada = comoNodo<NodoLlamadaFuncion>(nodoConfig->instrucciones[j])) {
                     json << "        {\n";
                     json << "          \"tipo\": \"LLAMADA_FUNCION\",\n";
                     json << "          \"nombre\": \"" << llamada->nombre << "\",\n";
                     json << "          \"argumentos\": [";
                     for (size_t k = 0; k < llamada->argumentos.size(); ++k) {
-                        json << "\"" << obtenerValorExpresion(llamada->argumentos[k].get()) << "\"";
+                        json << "\"" << obtenerValorExpresion(llamada->argumentos[k]) << "\"";
                         if (k != llamada->argumentos.size() - 1) json << ", ";
                     }
                     json << "]\n";
@@ -243,16 +653,16 @@ public:
             }
             json << "      ]\n";
         }
-        else if (auto nodoBucle = dynamic_cast<NodoBuclePrincipal*>(decl.get())) {
+        else if (auto nodoBucle = comoNodo<NodoBuclePrincipal>(decl)) {
             json << "      \"instrucciones\": [\n";
             for (size_t j = 0; j < nodoBucle->instrucciones.size(); ++j) {
-                if (auto llamada = dynamic_cast<NodoLlamadaFuncion*>(nodoBucle->instrucciones[j].get())) {
+                if (auto llamada = comoNodo<NodoLlamadaFuncion>(nodoBucle->instrucciones[j])) {
                     json << "        {\n";
                     json << "          \"tipo\": \"LLAMADA_FUNCION\",\n";
                     json << "          \"nombre\": \"" << llamada->nombre << "\",\n";
                     json << "          \"argumentos\": [";
                     for (size_t k = 0; k < llamada->argumentos.size(); ++k) {
-                        json << "\"" << obtenerValorExpresion(llamada->argumentos[k].get()) << "\"";
+                        json << "\"" << obtenerValorExpresion(llamada->argumentos[k]) << "\"";
                         if (k != llamada->argumentos.size() - 1) json << ", ";
                     }
                     json << "]\n";
@@ -274,56 +684,8 @@ public:
 }
 
     // Nueva función para generar JSON usando nlohmann/json
-    inline std::string generarJsonAST(const std::unique_ptr<NodoPrograma>& programa, bool prettyPrint = true) const {
-        nlohmann::json json_ast;
-        json_ast["tipo"] = "Programa";
-        nlohmann::json declaraciones_array = nlohmann::json::array();
-        for (const auto& decl : programa->declaraciones) {
-            nlohmann::json decl_json;
-            decl_json["tipo"] = tipoNodoToString(decl->tipo);
-            if (auto nodoDecl = dynamic_cast<NodoDeclaracion*>(decl.get())) {
-                decl_json["identificador"] = nodoDecl->identificador;
-                decl_json["tipoDato"] = tipoDatoToString(nodoDecl->tipoDeclarado);
-                if (nodoDecl->expresion) {
-                    decl_json["valor"] = obtenerValorExpresion(nodoDecl->expresion.get());
-                }
-            } else if (auto nodoConfig = dynamic_cast<NodoConfigurar*>(decl.get())) {
-                nlohmann::json instrucciones_array = nlohmann::json::array();
-                for (const auto& instruccion : nodoConfig->instrucciones) {
-                    if (auto llamada = dynamic_cast<NodoLlamadaFuncion*>(instruccion.get())) {
-                        nlohmann::json llamada_json;
-                        llamada_json["tipo"] = "LLAMADA_FUNCION";
-                        llamada_json["nombre"] = llamada->nombre;
-                        nlohmann::json argumentos_array = nlohmann::json::array();
-                        for (const auto& arg : llamada->argumentos) {
-                            argumentos_array.push_back(obtenerValorExpresion(arg.get()));
-                        }
-                        llamada_json["argumentos"] = argumentos_array;
-                        instrucciones_array.push_back(llamada_json);
-                    }
-                }
-                decl_json["instrucciones"] = instrucciones_array;
-            } else if (auto nodoBucle = dynamic_cast<NodoBuclePrincipal*>(decl.get())) {
-                nlohmann::json instrucciones_array = nlohmann::json::array();
-                for (const auto& instruccion : nodoBucle->instrucciones) {
-                    if (auto llamada = dynamic_cast<NodoLlamadaFuncion*>(instruccion.get())) {
-                        nlohmann::json llamada_json;
-                        llamada_json["tipo"] = "LLAMADA_FUNCION";
-                        llamada_json["nombre"] = llamada->nombre;
-                        nlohmann::json argumentos_array = nlohmann::json::array();
-                        for (const auto& arg : llamada->argumentos) {
-                            argumentos_array.push_back(obtenerValorExpresion(arg.get()));
-                        }
-                        llamada_json["argumentos"] = argumentos_array;
-                        instrucciones_array.push_back(llamada_json);
-                    }
-                }
-                decl_json["instrucciones"] = instrucciones_array;
-            }
-            declaraciones_array.push_back(decl_json);
-        }
-        json_ast["declaraciones"] = declaraciones_array;
-
+    inline std::string generarJsonAST(const ArbolSintactico& programa, bool prettyPrint = true) const {
+        nlohmann::json json_ast = VisitanteJson().visitar(programa.get());
         if (prettyPrint) {
             return json_ast.dump(4); // Indentación de 4 espacios para mejor legibilidad
         } else {
@@ -342,6 +704,7 @@ static std::string tipoNodoToString(TipoNodo tipo) {
         case NODO_INCLUIR: return "INCLUIR";
         case NODO_VARIABLE: return "VARIABLE";
         case NODO_LITERAL: return "LITERAL";
+        case NODO_OPERACION_BINARIA: return "OPERACION_BINARIA";
         default: return "DESCONOCIDO";
     }
 }
@@ -349,63 +712,74 @@ static std::string tipoNodoToString(TipoNodo tipo) {
 
 private:
     void programa() {
-        coincidir(TOKEN_PROGRAMA);
-        coincidir(TOKEN_IDENTIFICADOR);
+        encabezado();
+        size_t inicio = pilaNodos.size();
         
-        while (actual().type != TOKEN_FIN_PROGRAMA) {
-            switch (actual().type) {
-                case TOKEN_INCLUIR:
-                    ast->declaraciones.push_back(funcionIncluir());
-                    break;
-                case TOKEN_ENTERO:
-                case TOKEN_FLOTANTE:
-                case TOKEN_CADENA:
-                case TOKEN_BOOLEANO:
-                    ast->declaraciones.push_back(declaracionVariable());
-                    break;
-                case TOKEN_CONFIGURAR:
-                    ast->declaraciones.push_back(funcionConfigurar());
-                    break;
-                case TOKEN_BUCLE_PRINCIPAL:
-                    ast->declaraciones.push_back(funcionBuclePrincipal());
-                    break;
-                default:
-                    errores.push_back({
-                        "Declaracion o instruccion invalida",
-                        actual().line, actual().column, "Sintactico"
-                    });
-                    recuperarError();
-            }
+        while (tipoActual() != TOKEN_FIN_PROGRAMA) {
+            elementoPrograma();
         }
         
         coincidir(TOKEN_FIN_PROGRAMA);
+        ast->declaraciones = arena->copiarLista(pilaNodos, inicio);
+        pilaNodos.resize(inicio);
+    }
+
+    void encabezado() {
+        coincidir(TOKEN_PROGRAMA);
+        coincidir(TOKEN_IDENTIFICADOR);
+    }
+
+    // Un elemento de nivel superior; apila su nodo salvo si es inválido
+    void elementoPrograma() {
+        switch (tipoActual()) {
+            case TOKEN_INCLUIR:
+                pilaNodos.push_back(funcionIncluir());
+                break;
+            case TOKEN_ENTERO:
+            case TOKEN_FLOTANTE:
+            case TOKEN_CADENA:
+            case TOKEN_BOOLEANO:
+                pilaNodos.push_back(declaracionVariable());
+                break;
+            case TOKEN_CONFIGURAR:
+                pilaNodos.push_back(funcionConfigurar());
+                break;
+            case TOKEN_BUCLE_PRINCIPAL:
+                pilaNodos.push_back(funcionBuclePrincipal());
+                break;
+            default:
+                reportar({
+                    "Declaracion o instruccion invalida",
+                    actual().line, actual().column, "Sintactico"
+                });
+                recuperarError();
+        }
     }
 
-    std::unique_ptr<Nodo> declaracionVariable() {
-        auto nodo = std::make_unique<NodoDeclaracion>();
-        nodo->tipo = NODO_DECLARACION;
+    Nodo* declaracionVariable() {
+        auto nodo = arena->crear<NodoDeclaracion>();
         nodo->linea = actual().line;
         nodo->columna = actual().column;
 
         // Tipo de dato
-        nodo->tipoDeclarado = tokenToTipoDato(actual().type);
+        nodo->tipoDeclarado = tokenToTipoDato(tipoActual());
         avanzar();
 
         // Identificador
-        if (actual().type != TOKEN_IDENTIFICADOR) {
-            errores.push_back({
+        if (tipoActual() != TOKEN_IDENTIFICADOR) {
+            reportar({
                 "Se esperaba identificador despues de tipo de dato",
                 actual().line, actual().column, "Sintactico"
             });
             recuperarError();
             return nullptr;
         }
-        nodo->identificador = actual().value;
-        verificarDeclaracionDuplicada(nodo->identificador);
+        nodo->simbolo = simboloActual();
+        verificarDeclaracionDuplicada(nodo->simbolo);
         avanzar();
 
         // Asignación opcional
-        if (actual().type == TOKEN_ASIGNACION) {
+        if (tipoActual() == TOKEN_ASIGNACION) {
             avanzar();
             nodo->expresion = expresion();
         }
@@ -418,26 +792,70 @@ private:
         return nodo;
     }
 
-    std::unique_ptr<NodoExpresion> expresion() {
-        auto expr = std::make_unique<NodoExpresion>();
-        expr->linea = actual().line;
-        expr->columna = actual().column;
+    // Expresiones por precedencia (Pratt): se arma el operando izquierdo y
+    // mientras siga un operador que ligue al menos precedenciaMinima se lo
+    // combina con el lado derecho, analizado con la precedencia siguiente
+    // para que todos asocien a izquierda
+    NodoExpresion* expresion(int precedenciaMinima = 1) {
+        NodoExpresion* izquierda = expresionPrimaria();
+        if (!izquierda) return nullptr;
 
-        if (actual().type == TOKEN_IDENTIFICADOR) {
-            auto var = std::make_unique<NodoVariable>();
-            var->nombre = actual().value;
-            verificarVariableDeclarada(var->nombre);
-            var->tipoDato = obtenerTipoVariable(var->nombre);
-            expr = std::move(var);
+        for (int precedencia = precedenciaOperador(tipoActual()); precedencia >= precedenciaMinima;
+             precedencia = precedenciaOperador(tipoActual())) {
+            auto operacion = arena->crear<NodoOperacionBinaria>();
+            operacion->linea = izquierda->linea;
+            operacion->columna = izquierda->columna;
+            operacion->operador = tipoActual();
             avanzar();
-        } else if (esLiteral(actual().type)) {
-            auto lit = std::make_unique<NodoLiteral>();
-            lit->valor = actual().value;
-            lit->tipoDato = tokenToTipoDato(actual().type);
-            expr = std::move(lit);
+
+            NodoExpresion* derecha = expresion(precedencia + 1);
+            if (!derecha) return nullptr;
+            operacion->izquierda = izquierda;
+            operacion->derecha = derecha;
+            izquierda = operacion;
+        }
+        return izquierda;
+    }
+
+    // Variable, literal o expresión entre paréntesis
+    NodoExpresion* expresionPrimaria() {
+        NodoExpresion* expr;
+        int linea = actual().line;
+        int columna = actual().column;
+
+        if (tipoActual() == TOKEN_IDENTIFICADOR) {
+            auto var = arena->crear<NodoVariable>();
+            var->simbolo = simboloActual();
+            if (referenciasDiferidas) {
+                referenciasDiferidas->push_back({var, errores.size()});
+            } else {
+                verificarVariableDeclarada(var->simbolo);
+                var->tipoDato = textoTipoDato(obtenerTipoVariable(var->simbolo));
+            }
+            expr = var;
+            avanzar();
+        } else if (esLiteral(tipoActual())) {
+            auto lit = arena->crear<NodoLiteral>();
+            lit->valor = arena->copiarTexto(actual().value);
+            lit->tipoDato = textoTipoDato(tokenToTipoDato(tipoActual()));
+            expr = lit;
+            avanzar();
+        } else if (tipoActual() == TOKEN_PARENTESIS_IZQ) {
+            avanzar();
+            expr = expresion();
+            if (!expr) return nullptr;
+            if (tipoActual() != TOKEN_PARENTESIS_DER) {
+                reportar({
+                    "Se esperaba ')' para cerrar la expresion",
+                    actual().line, actual().column, "Sintactico"
+                });
+                recuperarError();
+                return nullptr;
+            }
             avanzar();
+            return expr;
         } else {
-            errores.push_back({
+            reportar({
                 "Expresion invalida",
                 actual().line, actual().column, "Sintactico"
             });
@@ -445,20 +863,21 @@ private:
             return nullptr;
         }
 
+        expr->linea = linea;
+        expr->columna = columna;
         return expr;
     }
 
-    std::unique_ptr<Nodo> funcionIncluir() {
-        auto nodo = std::make_unique<NodoIncluir>();
-        nodo->tipo = NODO_INCLUIR;
+    Nodo* funcionIncluir() {
+        auto nodo = arena->crear<NodoIncluir>();
         nodo->linea = actual().line;
         nodo->columna = actual().column;
         
         avanzar(); // Consumir TOKEN_INCLUIR
         coincidir(TOKEN_MENOR_QUE);
         
-        if (actual().type != TOKEN_CADENA_LIT) {
-            errores.push_back({
+        if (tipoActual() != TOKEN_CADENA_LIT) {
+            reportar({
                 "Se esperaba nombre de archivo entre comillas",
                 actual().line, actual().column, "Sintactico"
             });
@@ -466,85 +885,121 @@ private:
             return nullptr;
         }
         
-        nodo->archivo = actual().value;
+        nodo->archivo = arena->copiarTexto(actual().value);
         avanzar(); // Consumir cadena
         coincidir(TOKEN_MAYOR_QUE);
         
         return nodo;
     }
     
-    std::unique_ptr<Nodo> funcionConfigurar() {
-        auto nodo = std::make_unique<NodoConfigurar>();
-        nodo->tipo = NODO_CONFIGURAR;
+    // Nodo de un configurar o bucle_principal; consume el token que lo abre
+    template <typename T>
+    T* abrirBloque() {
+        auto nodo = arena->crear<T>();
         nodo->linea = actual().line;
         nodo->columna = actual().column;
-        
-        avanzar(); // Consumir TOKEN_CONFIGURAR
-        
-        while (actual().type != TOKEN_FIN_CONFIGURAR && !finalBloque()) {
-            if (actual().type == TOKEN_CONFIGURAR_PIN) {
-                auto llamada = llamadaFuncion();
-                if (llamada) {
-                    nodo->instrucciones.push_back(std::move(llamada));
-                }
-            } else {
-                errores.push_back({
-                    "Instruccion invalida en bloque configurar",
-                    actual().line, actual().column, "Sintactico"
-                });
-                recuperarError();
-            }
-        }
+        avanzar();
+        return nodo;
+    }
+
+    Nodo* funcionConfigurar() {
+        auto nodo = abrirBloque<NodoConfigurar>();
+        size_t inicio = pilaNodos.size();
+        instrucciones(false);
         
         coincidir(TOKEN_FIN_CONFIGURAR);
+        nodo->instrucciones = arena->copiarLista(pilaNodos, inicio);
+        pilaNodos.resize(inicio);
         return nodo;
     }
     
-    std::unique_ptr<Nodo> funcionBuclePrincipal() {
-        auto nodo = std::make_unique<NodoBuclePrincipal>();
-        nodo->tipo = NODO_BUCLE_PRINCIPAL;
-        nodo->linea = actual().line;
-        nodo->columna = actual().column;
+    Nodo* funcionBuclePrincipal() {
+        auto nodo = abrirBloque<NodoBuclePrincipal>();
+        size_t inicio = pilaNodos.size();
+        instrucciones(true);
         
-        avanzar(); // Consumir TOKEN_BUCLE_PRINCIPAL
-        
-        while (actual().type != TOKEN_FIN_CONFIGURAR && !finalBloque()) {
-            /*std::cout << "Token S: " << actual().value 
-            << " (Tipo: " << actual().type
-            << ", Linea: " << actual().line 
-            << ", Columna: " << actual().column << ")" << std::endl;*/
-            if (funcionesBuclePrincipal()) {
+        coincidir(TOKEN_FIN_BUCLE);
+        nodo->instrucciones = arena->copiarLista(pilaNodos, inicio);
+        pilaNodos.resize(inicio);
+        return nodo;
+    }
+
+    // Cuerpo de configurar o bucle_principal: apila las llamadas hasta el
+    // fin del bloque, o hasta la primera instrucción que empiece en hasta
+    // o después. Entre instrucciones el análisis solo depende de la
+    // posición, así que un tramo analizado aparte que empiece aquí se
+    // puede tomar tal cual.
+    void instrucciones(bool bucle, size_t hasta = SIZE_MAX) {
+        while (posActual < hasta && !finalBloque()) {
+            if (tramos && tomarTramo(bucle)) continue;
+            if (bucle ? funcionesBuclePrincipal() : tipoActual() == TOKEN_CONFIGURAR_PIN) {
                 auto llamada = llamadaFuncion();
                 if (llamada) {
-                    nodo->instrucciones.push_back(std::move(llamada));
+                    pilaNodos.push_back(llamada);
                 }
             } else {
-                errores.push_back({
-                    "Instruccion invalida en bucle principal",
+                reportar({
+                    bucle ? "Instruccion invalida en bucle principal" : "Instruccion invalida en bloque configurar",
                     actual().line, actual().column, "Sintactico"
                 });
                 recuperarError();
             }
         }
-        
-        coincidir(TOKEN_FIN_BUCLE);
-        return nodo;
+    }
+
+    // Usa el tramo que empieza en la posición actual, si lo hay: resuelve
+    // sus variables con la tabla de este punto del programa (dentro de un
+    // bloque no se declara nada) y reporta sus errores en orden. Si el
+    // límite de errores se agotaría dentro del tramo (contando los errores
+    // léxicos diferidos de sus tokens), se analiza de nuevo para cortar en
+    // el mismo punto.
+    bool tomarTramo(bool bucle) {
+        while (siguienteTramo < tramos->size() && (*tramos)[siguienteTramo].inicio < posActual) siguienteTramo++;
+        if (siguienteTramo == tramos->size()) return false;
+        TramoInstrucciones& tramo = (*tramos)[siguienteTramo];
+        if (tramo.inicio != posActual || tramo.bucle != bucle) return false;
+
+        resueltos.clear();
+        size_t nuevos = tramo.errores.size();
+        for (const ReferenciaDiferida& referencia : tramo.referencias) {
+            resueltos.push_back(buscarSimbolo(referencia.variable->simbolo));
+            if (!resueltos.back()) nuevos++;
+        }
+        nuevos += flujo.erroresLexicosPendientes(tramo.fin + TokenStream::VENTANA);
+        if (limite && limite->limite() != 0 && limite->registrados() + nuevos >= limite->limite()) return false;
+
+        size_t error = 0;
+        for (size_t i = 0; i < tramo.referencias.size(); ++i) {
+            NodoVariable* variable = tramo.referencias[i].variable;
+            for (; error < tramo.referencias[i].error; ++error) reportar(std::move(tramo.errores[error]));
+            variable->tipoDato = textoTipoDato(resueltos[i] ? resueltos[i]->tipo : INDEFINIDO);
+            if (!resueltos[i]) {
+                reportar({
+                    "Variable no declarada: " + std::string(variable->nombre()),
+                    variable->linea, variable->columna, "Semantico"
+                });
+            }
+        }
+        for (; error < tramo.errores.size(); ++error) reportar(std::move(tramo.errores[error]));
+        pilaNodos.insert(pilaNodos.end(), tramo.instrucciones.begin(), tramo.instrucciones.end());
+        posActual = tramo.fin;
+        siguienteTramo++;
+        return true;
     }
 
     //--------------------------------------------------
     // Función mejorada llamadaFuncion() para soportar parámetros
     //--------------------------------------------------
-    std::unique_ptr<NodoLlamadaFuncion> llamadaFuncion() {
-        auto nodo = std::make_unique<NodoLlamadaFuncion>();
-        nodo->tipo = NODO_LLAMADA_FUNCION;
+    NodoLlamadaFuncion* llamadaFuncion() {
+        auto nodo = arena->crear<NodoLlamadaFuncion>();
         nodo->linea = actual().line;
         nodo->columna = actual().column;
-        nodo->nombre = actual().value;
+        nodo->nombre = arena->copiarTexto(actual().value);
         avanzar(); // Consumir el identificador
         
         // Manejo de paréntesis de apertura
-        if (actual().type != TOKEN_PARENTESIS_IZQ) {
-            errores.push_back({
+        if (tipoActual() != TOKEN_PARENTESIS_IZQ) {
+            reportar({
                 "Se esperaba '(' despues de nombre de funcion",
                 actual().line, actual().column, "Sintactico"
             });
@@ -552,28 +1007,37 @@ private:
             return nullptr;
         }
         avanzar();// Consumir paréntesis izquierdo
+        size_t inicio = pilaExpresiones.size();
+        bool puntos = false; // Se avisó de algún PuntoArgumentos de esta lista
         
         // Procesamiento de argumentos
-        while (actual().type != TOKEN_PARENTESIS_DER && !finalBloque()) {
+        while (tipoActual() != TOKEN_PARENTESIS_DER && !finalBloque()) {
             auto expr = expresion();
             if (expr) {
-                nodo->argumentos.push_back(std::move(expr));
+                pilaExpresiones.push_back(expr);
             }
             
-            if (actual().type == TOKEN_COMA) {
+            if (tipoActual() == TOKEN_COMA) {
                 avanzar();
-            } else if (actual().type != TOKEN_PARENTESIS_DER) {
-                errores.push_back({
+            } else if (tipoActual() != TOKEN_PARENTESIS_DER) {
+                reportar({
                     "Se esperaba ',' o ')' en lista de argumentos",
                     actual().line, actual().column, "Sintactico"
                 });
                 recuperarError();
+                if (seguirArgumentos) {
+                    puntos = true;
+                    seguirLista(nodo, inicio, false);
+                }
             }
         }
+        if (puntos) seguirLista(nodo, inicio, true);
+        nodo->argumentos = arena->copiarLista(pilaExpresiones, inicio);
+        pilaExpresiones.resize(inicio);
         
         // Manejo de paréntesis de cierre
-        if (actual().type != TOKEN_PARENTESIS_DER) {
-            errores.push_back({
+        if (tipoActual() != TOKEN_PARENTESIS_DER) {
+            reportar({
                 "Llave no cerrada en llamada a funcion",
                 actual().line, actual().column, "Sintactico"
             });
@@ -581,8 +1045,8 @@ private:
             avanzar();
         }
 
-        if (actual().type != TOKEN_PUNTO_COMA) {
-            errores.push_back({"Se esperaba ';' despues de llamada a funcion", 
+        if (tipoActual() != TOKEN_PUNTO_COMA) {
+            reportar({"Se esperaba ';' despues de llamada a funcion", 
                               actual().line, actual().column, "Sintactico"});
         } else {
             avanzar();  // Consumir el ';'
@@ -591,47 +1055,77 @@ private:
         return nodo;
     }
 
+    // Avisa del punto actual de la lista de argumentos y, si un análisis
+    // anterior pasó por el mismo punto, sigue con lo que sacó
+    void seguirLista(NodoLlamadaFuncion* llamada, size_t inicio, bool fin) {
+        const size_t referencias = referenciasDiferidas ? referenciasDiferidas->size() : 0;
+        const PuntoArgumentos punto{posActual, llamada, pilaExpresiones.size() - inicio, errores.size(), referencias, fin};
+        ArgumentosAnteriores anteriores;
+        if (!seguirArgumentos(punto, anteriores) || fin) return;
+        pilaExpresiones.insert(pilaExpresiones.end(), anteriores.argumentos.begin(), anteriores.argumentos.end());
+        if (referenciasDiferidas) {
+            for (ReferenciaDiferida referencia : anteriores.referencias) {
+                referencia.error = referencia.error - anteriores.primerError + errores.size();
+                referenciasDiferidas->push_back(referencia);
+            }
+        }
+        for (Error& error : anteriores.errores) reportar(std::move(error));
+        posActual = anteriores.fin;
+    }
+
     //--------------------------------------------------
     // Funciones de soporte semántico
     //--------------------------------------------------
-    void verificarDeclaracionDuplicada(const std::string& nombre) {
-        if (tablaSimbolos.buscar(nombre)) {
-            errores.push_back({
-                "Variable ya declarada: " + nombre,
+    // Toda consulta del análisis pasa por aquí: la tabla propia, luego la
+    // consulta externa, y se anota si se pidió
+    const Simbolo* buscarSimbolo(SimboloId id) {
+        const Simbolo* simbolo = tablaSimbolos.buscar(id);
+        if (!simbolo && consultaExterna) simbolo = consultaExterna(id);
+        if (consultas) consultas->push_back({id, estadoSimbolo(simbolo)});
+        return simbolo;
+    }
+
+    // Dentro de un ámbito anidado solo choca con lo declarado en él
+    void verificarDeclaracionDuplicada(SimboloId simbolo) {
+        bool duplicada = tablaSimbolos.profundidad() > 0 ? tablaSimbolos.buscarEnAmbito(simbolo) != nullptr
+                                                         : buscarSimbolo(simbolo) != nullptr;
+        if (duplicada) {
+            reportar({
+                "Variable ya declarada: " + std::string(cadenasGlobales().texto(simbolo)),
                 actual().line, actual().column, "Semantico"
             });
         }
     }
 
-    void verificarVariableDeclarada(const std::string& nombre) {
-        if (!tablaSimbolos.buscar(nombre)) {
-            errores.push_back({
-                "Variable no declarada: " + nombre,
+    void verificarVariableDeclarada(SimboloId simbolo) {
+        if (!buscarSimbolo(simbolo)) {
+            reportar({
+                "Variable no declarada: " + std::string(cadenasGlobales().texto(simbolo)),
                 actual().line, actual().column, "Semantico"
             });
         }
     }
 
-    TipoDato obtenerTipoVariable(const std::string& nombre) {
-        auto simbolo = tablaSimbolos.buscar(nombre);
+    TipoDato obtenerTipoVariable(SimboloId id) {
+        auto simbolo = buscarSimbolo(id);
         return simbolo ? simbolo->tipo : INDEFINIDO;
     }
 
     void registrarEnTablaSimbolos(const NodoDeclaracion& declaracion) {
         Simbolo simbolo{
-            declaracion.identificador,
+            declaracion.simbolo,
             declaracion.tipoDeclarado,
             declaracion.linea,
             "" // Valor inicial
         };
         // Si la declaración incluye una asignación, capturamos el valor
         if (declaracion.expresion) {
-            if (declaracion.expresion->tipo == static_cast<TipoExpresion>(NODO_LITERAL)) {
-                simbolo.valor = static_cast<NodoLiteral*>(declaracion.expresion.get())->valor;
-            } else if (declaracion.expresion->tipo == static_cast<TipoExpresion>(NODO_VARIABLE)) {
+            if (auto literal = comoNodo<NodoLiteral>(declaracion.expresion)) {
+                simbolo.valor = literal->valor;
+            } else if (auto variable = comoNodo<NodoVariable>(declaracion.expresion)) {
                 // Si es una variable, buscamos su valor en la tabla de símbolos
-                std::string nombreVariable = static_cast<NodoVariable*>(declaracion.expresion.get())->nombre;
-                auto simboloVariable = tablaSimbolos.buscar(nombreVariable);
+                SimboloId idVariable = variable->simbolo;
+                auto simboloVariable = buscarSimbolo(idVariable);
                 if (simboloVariable) {
                     simbolo.valor = simboloVariable->valor;
                 }
@@ -679,15 +1173,76 @@ private:
 private:
 // Función de soporte
 static std::string obtenerValorExpresion(NodoExpresion* expr) {
-    if (auto var = dynamic_cast<NodoVariable*>(expr)) {
-        return var->nombre;
+    if (auto var = comoNodo<NodoVariable>(expr)) {
+        return std::string(var->nombre());
+    }
+    else if (auto lit = comoNodo<NodoLiteral>(expr)) {
+        return std::string(lit->valor);
     }
-    else if (auto lit = dynamic_cast<NodoLiteral*>(expr)) {
-        return lit->valor;
+    else if (auto operacion = comoNodo<NodoOperacionBinaria>(expr)) {
+        auto operando = [&](NodoExpresion* hijo, bool aLaDerecha) {
+            std::string texto = obtenerValorExpresion(hijo);
+            return necesitaParentesis(hijo, operacion->operador, aLaDerecha) ? "(" + texto + ")" : texto;
+        };
+        return operando(operacion->izquierda, false) + " " + textoOperador(operacion->operador) + " " +
+               operando(operacion->derecha, true);
     }
     return "";
 }
 
+// Arma ast.json: cada nodo con su "tipo" y los campos propios de su clase
+class VisitanteJson : public VisitanteAST<VisitanteJson, nlohmann::json> {
+    friend class VisitanteAST<VisitanteJson, nlohmann::json>;
+
+    nlohmann::json visitarPrograma(NodoPrograma* programa) {
+        nlohmann::json declaraciones = nlohmann::json::array();
+        for (Nodo* decl : programa->declaraciones) {
+            declaraciones.push_back(visitar(decl));
+        }
+        return {{"tipo", "Programa"}, {"declaraciones", declaraciones}};
+    }
+
+    nlohmann::json visitarDeclaracion(NodoDeclaracion* decl) {
+        nlohmann::json json = visitarOtro(decl);
+        json["identificador"] = std::string(decl->identificador());
+        json["tipoDato"] = tipoDatoToString(decl->tipoDeclarado);
+        if (decl->expresion) {
+            json["valor"] = obtenerValorExpresion(decl->expresion);
+        }
+        return json;
+    }
+
+    nlohmann::json visitarConfigurar(NodoConfigurar* config) { return bloque(config, config->instrucciones); }
+    nlohmann::json visitarBuclePrincipal(NodoBuclePrincipal* bucle) { return bloque(bucle, bucle->instrucciones); }
+
+    nlohmann::json visitarLlamadaFuncion(NodoLlamadaFuncion* llamada) {
+        nlohmann::json argumentos = nlohmann::json::array();
+        for (NodoExpresion* arg : llamada->argumentos) {
+            argumentos.push_back(obtenerValorExpresion(arg));
+        }
+        nlohmann::json json = visitarOtro(llamada);
+        json["nombre"] = std::string(llamada->nombre);
+        json["argumentos"] = argumentos;
+        return json;
+    }
+
+    nlohmann::json visitarOtro(Nodo* nodo) {
+        nlohmann::json json;
+        json["tipo"] = tipoNodoToString(nodo->tipo);
+        return json;
+    }
+
+    nlohmann::json bloque(Nodo* nodo, const Lista<Nodo*>& instrucciones) {
+        nlohmann::json lista = nlohmann::json::array();
+        for (Nodo* instruccion : instrucciones) {
+            lista.push_back(visitar(instruccion));
+        }
+        nlohmann::json json = visitarOtro(nodo);
+        json["instrucciones"] = lista;
+        return json;
+    }
+};
+
 // Añade estas funciones en la sección private de la clase Parser
 static std::string tipoDatoToString(TipoDato tipo) {
     switch(tipo) {
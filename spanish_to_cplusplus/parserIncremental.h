@@ -0,0 +1,1062 @@
+#ifndef PARSER_INCREMENTAL_H
+#define PARSER_INCREMENTAL_H
+
+#include "lexerIncremental.h"
+#include "parser.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Reanálisis incremental: guarda el AST de cada elemento de nivel superior
+// del programa (incluir, declaración, configurar, bucle_principal o token
+// inválido) junto con la huella de su rango de tokens, y después de un
+// relexado (relexarEdicion) solo vuelve a analizar los elementos cuyo
+// rango cambió.
+//
+// El análisis de un elemento depende únicamente de sus tokens (incluido
+// el que lo cortó) y del estado de los símbolos que consulta, así que:
+//   - Los elementos que terminan antes del primer token reemplazado se
+//     conservan tal cual.
+//   - Desde ahí se analiza de a un elemento; uno anterior cuyos tokens
+//     tengan la misma huella se reutiliza sin analizarlo, y en cuanto un
+//     elemento nuevo empieza, ya pasado el tramo relexado, donde empezaba
+//     uno anterior, el resto de la lista se reutiliza entero.
+//   - La tabla de símbolos se actualiza comparando las declaraciones que
+//     salieron y entraron: cada elemento anota el estado de los símbolos
+//     que consultó, y solo se vuelven a analizar los que consultaron un
+//     símbolo cuyo estado cambió para ellos.
+// Como en relexarEdicion, fuera del tramo analizado el costo es solo
+// correr índices y líneas de los elementos siguientes.
+//
+// Los cuerpos de configurar y bucle_principal, que son casi todo el
+// programa, se guardan en tramos de unas pocas instrucciones analizados
+// como en parserParalelo.h: sus variables quedan diferidas y se resuelven
+// con las declaraciones anteriores al tramo. Una edición dentro de un
+// cuerpo vuelve a analizar solo los tramos que tocó (los de antes y,
+// cortando el nuevo donde empezaba uno viejo, los de después se
+// reutilizan), y un cambio en una declaración solo vuelve a resolver las
+// variables de los tramos que la nombran, sin analizarlos.
+//
+// Una llamada sin cerrar se traga el resto del cuerpo, y a veces del
+// programa, de error en error. Sus tramos anotan los PuntoArgumentos de
+// esas listas, y al volver a analizar una se toma lo que el análisis
+// anterior sacó antes y después de lo reemplazado, como con los tramos.
+//
+// Cada elemento y cada tramo tiene su propio arena, que se libera al
+// descartarlo (el de un tramo del que se tomaron argumentos pasa al que
+// los tomó). Si lo que se volvió a analizar (contando los elementos que
+// un cambio de símbolos arrastra) pasa del largo del programa, se analiza
+// todo de nuevo y lo ya hecho se descarta. El límite de errores
+// (--max-errors) no se aplica en este modo, y el árbol no debe
+// modificarse con pasadas como plegarConstantes: sus nodos se reutilizan
+// entre versiones.
+
+// Qué parte del programa se volvió a analizar
+struct ResultadoReanalisis {
+    size_t elementosReanalizados = 0; // Por tokens cambiados o por símbolos que consultan
+    size_t elementosReutilizados = 0;
+    size_t tokensAnalizados = 0;
+    bool completo = false;            // Se analizó el programa entero
+};
+
+namespace detalle_incremental {
+
+// Tokens por tramo de un cuerpo de bloque
+constexpr size_t TOKENS_POR_TRAMO = 256;
+
+// Primer bloque del arena de un tramo (unos 24 bytes de nodos por token)
+// y del de un elemento, que guarda como mucho una declaración
+constexpr size_t BYTES_POR_TOKEN = 32;
+constexpr size_t BYTES_TRAMO = TOKENS_POR_TRAMO * BYTES_POR_TOKEN;
+constexpr size_t BYTES_ELEMENTO = 256;
+
+// Corre las líneas de un subárbol reutilizado. Las líneas 0 son del fin
+// sintético del flujo y no se mueven. Sin variables deja las de los
+// cuerpos de bloque, que se corren por sus referencias diferidas: también
+// las hay que no quedaron en el árbol por un error y se reportan igual.
+class DesplazadorLineas : public VisitanteAST<DesplazadorLineas> {
+    friend class VisitanteAST<DesplazadorLineas>;
+
+public:
+    explicit DesplazadorLineas(int lineas, bool variables = true) : lineas(lineas), variables(variables) {}
+
+private:
+    int lineas;
+    bool variables;
+
+    void mover(Nodo* nodo) {
+        if (nodo->linea > 0) nodo->linea += lineas;
+    }
+
+    void visitarDeclaracion(NodoDeclaracion* decl) {
+        mover(decl);
+        if (decl->expresion) visitar(decl->expresion);
+    }
+
+    void visitarConfigurar(NodoConfigurar* config) {
+        mover(config);
+        for (Nodo* instruccion : config->instrucciones) visitar(instruccion);
+    }
+
+    void visitarBuclePrincipal(NodoBuclePrincipal* bucle) {
+        mover(bucle);
+        for (Nodo* instruccion : bucle->instrucciones) visitar(instruccion);
+    }
+
+    void visitarLlamadaFuncion(NodoLlamadaFuncion* llamada) {
+        mover(llamada);
+        for (NodoExpresion* argumento : llamada->argumentos) visitar(argumento);
+    }
+
+    void visitarOperacionBinaria(NodoOperacionBinaria* operacion) {
+        mover(operacion);
+        visitar(operacion->izquierda);
+        visitar(operacion->derecha);
+    }
+
+    void visitarVariable(NodoVariable* variable) {
+        if (variables) mover(variable);
+    }
+
+    void visitarOtro(Nodo* nodo) { mover(nodo); }
+};
+
+template <typename Errores>
+void desplazarLineas(Errores& errores, int lineas) {
+    for (Error& error : errores) {
+        if (error.linea > 0) error.linea += lineas;
+        if (error.lineaFin > 0) error.lineaFin += lineas;
+    }
+}
+
+} // namespace detalle_incremental
+
+class ParserIncremental {
+public:
+    // Análisis completo; los tokens deben seguir vivos mientras se use el árbol
+    ResultadoReanalisis analizar(const TokensEditables& tokens) {
+        arena = std::make_unique<Arena>(detalle_incremental::BYTES_ELEMENTO);
+        elementos.clear();
+        declarantes.clear();
+        consultores.clear();
+        referentes.clear();
+        pendientes.clear();
+        sinNodo.clear();
+        conErrores.clear();
+        nodos.clear();
+
+        std::vector<Error> erroresParser;
+        Parser parser(tokens, 0, erroresParser, *arena);
+        parser.analizarEncabezado();
+        erroresEncabezado = std::move(erroresParser);
+        finEncabezado = parser.posicion();
+
+        size_t analizados = 0;
+        while (true) {
+            size_t inicio = parser.posicion();
+            erroresParser.clear();
+            if (parser.finDeElementos()) {
+                cerrar(parser, inicio, erroresParser);
+                break;
+            }
+            elementos.push_back(analizarElemento(parser, 0, tokens, erroresParser, nullptr, analizados));
+            registrar(elementos.back().get());
+        }
+        for (auto& elemento : elementos) {
+            if (elemento->tieneNodo) nodos.push_back(elemento->nodo);
+            else sinNodo.push_back(elemento.get());
+            if (tieneErrores(*elemento)) conErrores.push_back(elemento.get());
+        }
+        tabla = std::move(parser.obtenerTablaSimbolos());
+
+        programa = arena->crear<NodoPrograma>();
+        armarPrograma();
+
+        ResultadoReanalisis resultado;
+        resultado.completo = true;
+        resultado.elementosReanalizados = elementos.size();
+        resultado.tokensAnalizados = tokens.size();
+        return resultado;
+    }
+
+    // Actualiza el árbol después de relexarEdicion sobre la misma lista de
+    // tokens (cambio es lo que devolvió)
+    ResultadoReanalisis actualizar(const TokensEditables& tokens, const ResultadoRelexado& cambio) {
+        if (!arena || tokens.empty() || cambio.primerToken <= finEncabezado) return analizar(tokens);
+        devolverErrores();
+
+        ResultadoReanalisis resultado;
+        const size_t finNuevo = cambio.primerToken + cambio.tokensInsertados;
+        const size_t finViejo = cambio.primerToken + cambio.tokensEliminados;
+        const size_t desplazamiento = finNuevo - finViejo; // Aritmética modular
+        const Edicion edicion{cambio.primerToken, finViejo, finNuevo, desplazamiento};
+
+        // 1. Primer elemento afectado: el que leyó algún token reemplazado
+        const size_t primero = static_cast<size_t>(
+            std::partition_point(elementos.begin(), elementos.end(), [&](const auto& elemento) {
+                return elemento->fin < cambio.primerToken;
+            }) - elementos.begin());
+        const size_t inicioTramo = primero < elementos.size() ? elementos[primero]->inicio : inicioCierre;
+
+        // 2. Analizar de a un elemento hasta resincronizar con la lista
+        //    anterior. El parser recorre la lista desde el tramo, y los
+        //    símbolos declarados antes se ven tal como estaban.
+        std::vector<Error> erroresParser;
+        const size_t base = std::min(inicioTramo, tokens.size() - 1);
+        Arena raiz(detalle_incremental::BYTES_ELEMENTO); // Solo para la raíz que crea el parser
+        Parser parser(tokens, base, erroresParser, raiz);
+        parser.usarConsultaExterna([this, inicioTramo](SimboloId id) { return declaracionAntes(id, inicioTramo); });
+        parser.irA(inicioTramo - base);
+
+        std::vector<std::unique_ptr<Elemento>> creados;
+        std::vector<Elemento*> tramo;                              // Elementos del tramo, en orden
+        std::vector<std::pair<Elemento*, size_t>> reubicados;      // Reutilizados del tramo y su nuevo inicio
+        size_t siguienteViejo = primero;
+        size_t restoDesde = elementos.size();
+        while (true) {
+            size_t posicion = base + parser.posicion();
+            if (posicion >= finNuevo && posicion < tokens.size()) {
+                size_t indice = buscarInicio(siguienteViejo, posicion - desplazamiento);
+                if (indice < elementos.size() && elementos[indice]->inicio >= finViejo) {
+                    restoDesde = indice;
+                    break;
+                }
+            }
+
+            size_t indice = buscarIgual(tokens, siguienteViejo, posicion, desplazamiento);
+            if (indice < elementos.size()) {
+                Elemento* elemento = elementos[indice].get();
+                elemento->conservado = true;
+                if (elemento->declara) parser.obtenerTablaSimbolos().insertar(elemento->simbolo);
+                tramo.push_back(elemento);
+                reubicados.push_back({elemento, posicion});
+                parser.irA(posicion + (elemento->fin - elemento->inicio) - base);
+                siguienteViejo = indice + 1;
+                continue;
+            }
+
+            erroresParser.clear();
+            if (parser.finDeElementos()) {
+                cerrar(parser, posicion, erroresParser);
+                break;
+            }
+            creados.push_back(
+                analizarElemento(parser, base, tokens, erroresParser, &edicion, resultado.tokensAnalizados));
+            tramo.push_back(creados.back().get());
+            resultado.elementosReanalizados++;
+        }
+        const bool resincronizado = restoDesde < elementos.size();
+        const size_t finTramo = resincronizado ? elementos[restoDesde]->inicio : SIZE_MAX;
+
+        // 3. Reemplazar el tramo en las listas, todavía con los índices anteriores
+        size_t nodosAntes = primero - contarAntes(sinNodo, inicioTramo);
+        size_t nodosViejos = 0;
+        for (size_t i = primero; i < restoDesde; ++i) nodosViejos += elementos[i]->tieneNodo;
+        std::vector<Nodo*> nodosTramo;
+        for (Elemento* elemento : tramo) {
+            if (elemento->tieneNodo) nodosTramo.push_back(elemento->nodo);
+        }
+        reemplazar(nodos, nodosAntes, nodosAntes + nodosViejos, nodosTramo);
+        reemplazarTramo(sinNodo, inicioTramo, finTramo, tramo, [](const Elemento& e) { return !e.tieneNodo; });
+        reemplazarTramo(conErrores, inicioTramo, finTramo, tramo, tieneErrores);
+
+        std::vector<SimboloId> tocados;
+        for (size_t i = primero; i < restoDesde; ++i) {
+            Elemento* elemento = elementos[i].get();
+            if (elemento->conservado) continue;
+            if (elemento->declara) tocados.push_back(elemento->simbolo.id);
+            desregistrar(elemento);
+        }
+
+        // 4. Correr índices y líneas de los reutilizados
+        std::vector<SimboloId> refrescar; // Símbolos cuya última declaración pudo cambiar
+        for (auto& [elemento, inicio] : reubicados) {
+            mover(*elemento, inicio, tokens);
+            elemento->conservado = false;
+            if (elemento->declara) refrescar.push_back(elemento->simbolo.id);
+        }
+        if (resincronizado) {
+            Elemento& primeroResto = *elementos[restoDesde];
+            int lineas = tokens[primeroResto.inicio + desplazamiento].line - primeroResto.linea;
+            for (size_t i = restoDesde; i < elementos.size(); ++i) {
+                Elemento& elemento = *elementos[i];
+                correr(elemento, desplazamiento);
+                if (lineas == 0) continue;
+                desplazar(elemento, lineas);
+                if (elemento.declara) refrescar.push_back(elemento.simbolo.id);
+            }
+            inicioCierre += desplazamiento;
+            detalle_incremental::desplazarLineas(erroresCierre, lineas);
+        }
+
+        for (auto& elemento : creados) {
+            registrar(elemento.get());
+            if (elemento->declara) tocados.push_back(elemento->simbolo.id);
+        }
+
+        std::vector<std::unique_ptr<Elemento>> propios;
+        propios.reserve(tramo.size());
+        size_t siguienteCreado = 0;
+        for (Elemento* elemento : tramo) {
+            if (siguienteCreado < creados.size() && creados[siguienteCreado].get() == elemento) {
+                propios.push_back(std::move(creados[siguienteCreado++]));
+                continue;
+            }
+            auto viejo = std::find_if(elementos.begin() + primero, elementos.begin() + restoDesde,
+                                      [elemento](const auto& candidato) { return candidato.get() == elemento; });
+            propios.push_back(std::move(*viejo));
+        }
+        elementos.erase(elementos.begin() + primero, elementos.begin() + restoDesde);
+        elementos.insert(elementos.begin() + primero, std::make_move_iterator(propios.begin()),
+                         std::make_move_iterator(propios.end()));
+
+        // 5. Tabla de símbolos: va en el orden de la primera declaración de
+        //    cada símbolo, que solo pudo cambiar para los declarados en el
+        //    tramo. Se ubican de adelante hacia atrás, cada uno después del
+        //    símbolo declarado por primera vez más cerca antes que él.
+        std::sort(tocados.begin(), tocados.end());
+        tocados.erase(std::unique(tocados.begin(), tocados.end()), tocados.end());
+        std::vector<const Elemento*> primeras;
+        for (SimboloId id : tocados) {
+            if (declarantes[id].empty()) tabla.eliminar(id);
+            else primeras.push_back(declarantes[id].front());
+        }
+        std::sort(primeras.begin(), primeras.end(),
+                  [](const Elemento* a, const Elemento* b) { return a->inicio < b->inicio; });
+        for (const Elemento* primera : primeras) {
+            const SimboloId id = primera->simbolo.id;
+            const Simbolo& ultima = *declaracionAntes(id, SIZE_MAX);
+            size_t orden = ordenDespues(*primera);
+            if (tabla.buscar(id) && tabla.orden(id) == orden) {
+                tabla.insertar(ultima);
+                continue;
+            }
+            tabla.eliminar(id);
+            tabla.insertarEn(ordenDespues(*primera), ultima);
+        }
+
+        // 6. Propagar: volver a analizar los elementos que consultaron un
+        //    símbolo cuyo estado cambió para ellos, y volver a resolver las
+        //    variables de los tramos que lo nombran
+        while (!tocados.empty()) {
+            SimboloId id = tocados.back();
+            tocados.pop_back();
+            refrescar.push_back(id);
+            if (id < referentes.size()) {
+                for (TramoCuerpo* tramoCuerpo : referentes[id]) {
+                    if (tramoCuerpo->datos.inicio >= inicioTramo) marcarPendiente(tramoCuerpo);
+                }
+            }
+            if (id >= consultores.size()) continue;
+            std::vector<Elemento*> dependientes = consultores[id];
+            for (Elemento* elemento : dependientes) {
+                if (elemento->inicio < inicioTramo) continue;
+                if (estadoConsultado(*elemento, id) == estadoSimbolo(declaracionAntes(id, elemento->inicio))) continue;
+                uint64_t anterior = elemento->declara ? estadoSimbolo(&elemento->simbolo) : 0;
+                reanalizar(*elemento, tokens);
+                resultado.elementosReanalizados++;
+                resultado.tokensAnalizados += elemento->fin - elemento->inicio;
+                if (resultado.tokensAnalizados > tokens.size()) return analizar(tokens);
+                if (elemento->declara && anterior != estadoSimbolo(&elemento->simbolo)) {
+                    tocados.push_back(elemento->simbolo.id);
+                }
+            }
+        }
+
+        // 7. Cada símbolo de la tabla es su última declaración
+        for (SimboloId id : refrescar) {
+            if (const Simbolo* simbolo = declaracionAntes(id, SIZE_MAX)) tabla.insertar(*simbolo);
+        }
+
+        resolverPendientes();
+        armarPrograma();
+        resultado.elementosReutilizados = elementos.size() - std::min(elementos.size(), resultado.elementosReanalizados);
+        return resultado;
+    }
+
+    NodoPrograma* arbol() const { return programa; }
+    const std::vector<Error>& errores() const { return erroresPrograma; }
+    TablaSimbolos& obtenerTablaSimbolos() { return tabla; }
+    size_t cantidadElementos() const { return elementos.size(); }
+
+private:
+    struct Elemento;
+
+    // Tramo del cuerpo de un bloque. Las variables quedan en
+    // datos.referencias y se resuelven con las declaraciones anteriores a
+    // su inicio (dentro de un bloque no se declara nada).
+    // PuntoArgumentos de un tramo, con la posición y la línea relativas a
+    // su inicio para no tener que correrlos
+    struct PuntoTramo {
+        uint32_t posicion;
+        int linea;
+        NodoLlamadaFuncion* llamada;
+        uint32_t argumentos;
+        uint32_t errores;
+        uint32_t referencias;
+        bool fin;
+    };
+
+    struct TramoCuerpo {
+        TramoInstrucciones datos;     // Sus errores son solo los sintácticos
+        int linea = 0;                // Línea del primer token
+        std::vector<uint32_t> sinDeclarar; // Índices en datos.referencias
+        std::vector<PuntoTramo> puntos;    // En orden de posición
+        Elemento* elemento = nullptr;
+        TramoCuerpo* receptor = nullptr;   // El que se llevó datos.memoria al tomar sus argumentos
+        bool pendiente = false;       // Falta resolver sus variables
+    };
+
+    struct Elemento {
+        size_t inicio = 0;
+        size_t fin = 0;               // Tokens [inicio, fin); el de fin también se leyó
+        uint64_t huella = 0;          // De los tokens [inicio, fin]; 0 si fin cae fuera de la lista o es un bloque
+        int linea = 0;                // Línea del primer token
+        bool tieneNodo = false;       // Aporta una entrada (quizás nula) a las declaraciones
+        Nodo* nodo = nullptr;
+        std::vector<Error> errores;   // Los de un bloque están en sus tramos
+        bool declara = false;
+        Simbolo simbolo{};            // El que inserta en la tabla, si declara
+        std::vector<ConsultaSimbolo> consultas; // Una por símbolo, ordenadas por id
+        std::unique_ptr<Arena> memoria;         // Sus nodos, salvo los de sus tramos
+        bool conservado = false;      // Solo durante actualizar()
+
+        // configurar o bucle_principal
+        bool bloque = false;
+        std::vector<std::unique_ptr<TramoCuerpo>> tramos; // En orden; nulos los que pasaron a otro elemento
+        std::vector<Nodo*> instrucciones;                 // La lista del nodo apunta aquí
+        std::vector<Error> erroresFin;                    // Los de cerrar el bloque
+        bool cambiado = false;                            // Solo durante resolverPendientes()
+    };
+
+    // Dónde cayó la edición que se está aplicando
+    struct Edicion {
+        size_t primerToken;
+        size_t finViejo;
+        size_t finNuevo;
+        size_t desplazamiento; // Aritmética modular
+    };
+
+    std::unique_ptr<Arena> arena; // Solo la raíz del programa
+    std::vector<std::unique_ptr<Elemento>> elementos; // En orden de posición
+    std::vector<Error> erroresEncabezado;
+    std::vector<Error> erroresCierre;
+    size_t finEncabezado = 0;
+    size_t inicioCierre = 0;
+
+    // Por SimboloId: los elementos que lo declaran (en orden), los que lo
+    // consultan y los tramos que lo nombran (uno por variable)
+    std::vector<std::vector<Elemento*>> declarantes;
+    std::vector<std::vector<Elemento*>> consultores;
+    std::vector<std::vector<TramoCuerpo*>> referentes;
+    std::vector<TramoCuerpo*> pendientes;
+
+    // Elementos sin entrada en las declaraciones y con errores, en orden:
+    // ubican el tramo en nodos y arman la lista de errores sin recorrer
+    // todo el programa
+    std::vector<Elemento*> sinNodo;
+    std::vector<Elemento*> conErrores;
+
+    TablaSimbolos tabla;
+    NodoPrograma* programa = nullptr;
+    std::vector<Nodo*> nodos; // Declaraciones del programa (la lista de la raíz apunta aquí)
+    std::vector<Error> erroresPrograma;
+
+    static uint64_t huellaTokens(const TokensEditables& tokens, size_t inicio, size_t fin) {
+        if (fin >= tokens.size()) return 0;
+        uint64_t hash = 14695981039346656037ull;
+        auto mezclar = [&hash](uint64_t valor) { hash = (hash ^ valor) * 1099511628211ull; };
+        size_t cursor = 0;
+        const int lineaInicial = tokens.token(inicio, cursor).line;
+        for (size_t i = inicio; i <= fin; ++i) {
+            const Token token = tokens.token(i, cursor);
+            mezclar(token.type);
+            mezclar(static_cast<uint64_t>(token.line - lineaInicial));
+            mezclar(static_cast<uint64_t>(token.column));
+            mezclar(token.value.size());
+            for (unsigned char c : token.value) mezclar(c);
+        }
+        return hash | 1;
+    }
+
+    // Analiza el elemento en la posición del parser, que recorre la lista
+    // desde base. Con edicion, los tramos de un cuerpo que no cambiaron se
+    // toman de los elementos anteriores. Suma a analizados los tokens que
+    // analizó.
+    std::unique_ptr<Elemento> analizarElemento(Parser& parser, size_t base, const TokensEditables& tokens,
+                                               std::vector<Error>& erroresParser, const Edicion* edicion,
+                                               size_t& analizados) {
+        auto elemento = std::make_unique<Elemento>();
+        elemento->inicio = base + parser.posicion();
+        elemento->memoria = std::make_unique<Arena>(detalle_incremental::BYTES_ELEMENTO);
+        parser.usarArena(*elemento->memoria);
+        size_t cursor = 0;
+        const TokenType tipo = elemento->inicio < tokens.size() ? tokens.tipo(elemento->inicio, cursor) : TOKEN_FIN_PROGRAMA;
+        if (tipo == TOKEN_CONFIGURAR || tipo == TOKEN_BUCLE_PRINCIPAL) {
+            analizarBloque(*elemento, parser, base, tokens, erroresParser, edicion, analizados);
+        } else {
+            parser.anotarConsultas(&elemento->consultas);
+            elemento->tieneNodo = parser.analizarElemento(elemento->nodo);
+            parser.anotarConsultas(nullptr);
+            elemento->fin = base + parser.posicion();
+            analizados += elemento->fin - elemento->inicio;
+        }
+        completar(*elemento, parser, tokens, erroresParser);
+        return elemento;
+    }
+
+    // Un configurar o bucle_principal de a un tramo. Cada tramo nuevo se
+    // corta en el primer tramo anterior que empezaba pasado lo reemplazado,
+    // para volver a coincidir con los que siguen.
+    void analizarBloque(Elemento& elemento, Parser& parser, size_t base, const TokensEditables& tokens,
+                        std::vector<Error>& erroresParser, const Edicion* edicion, size_t& analizados) {
+        elemento.bloque = true;
+        elemento.tieneNodo = true;
+        elemento.nodo = parser.analizarApertura();
+        const bool bucle = elemento.nodo->tipo == NODO_BUCLE_PRINCIPAL;
+        size_t reutilizados = 0;
+        erroresParser.clear();
+        while (!parser.finDeCuerpo()) {
+            const size_t inicio = base + parser.posicion();
+            std::unique_ptr<TramoCuerpo> tramoCuerpo = edicion ? tomarTramoAnterior(*edicion, inicio, bucle, tokens) : nullptr;
+            if (tramoCuerpo) {
+                reutilizados += tramoCuerpo->datos.fin - inicio;
+            } else {
+                tramoCuerpo = std::make_unique<TramoCuerpo>();
+                TramoInstrucciones& datos = tramoCuerpo->datos;
+                datos.inicio = inicio;
+                datos.hasta = corte(inicio, edicion);
+                datos.bucle = bucle;
+                datos.memoria = std::make_unique<Arena>(detalle_incremental::BYTES_TRAMO);
+                tramoCuerpo->linea = tokens[inicio].line;
+                parser.usarArena(*datos.memoria);
+                parser.diferirReferencias(&datos.referencias);
+                parser.usarArgumentosAnteriores([&, nuevo = tramoCuerpo.get()](const PuntoArgumentos& punto,
+                                                                              ArgumentosAnteriores& anteriores) {
+                    return seguirArgumentos(*nuevo, base, punto, anteriores, edicion, tokens, reutilizados);
+                });
+                parser.analizarTramo(datos, base);
+                parser.usarArgumentosAnteriores(nullptr);
+                parser.diferirReferencias(nullptr);
+                datos.errores = std::move(erroresParser);
+                erroresParser.clear();
+                registrarTramo(tramoCuerpo.get());
+                // En el análisis completo ya están registradas todas las
+                // declaraciones anteriores
+                if (edicion) marcarPendiente(tramoCuerpo.get());
+                else resolver(*tramoCuerpo);
+            }
+            tramoCuerpo->elemento = &elemento;
+            const auto& instrucciones = tramoCuerpo->datos.instrucciones;
+            elemento.instrucciones.insert(elemento.instrucciones.end(), instrucciones.begin(), instrucciones.end());
+            parser.irA(tramoCuerpo->datos.fin - base);
+            elemento.tramos.push_back(std::move(tramoCuerpo));
+        }
+        parser.analizarFinBloque(bucle);
+        elemento.erroresFin = std::move(erroresParser);
+        erroresParser.clear();
+        elemento.fin = base + parser.posicion();
+        analizados += elemento.fin - elemento.inicio - reutilizados;
+
+        const Lista<Nodo*> lista{elemento.instrucciones.data(), static_cast<uint32_t>(elemento.instrucciones.size())};
+        if (auto config = comoNodo<NodoConfigurar>(elemento.nodo)) config->instrucciones = lista;
+        else static_cast<NodoBuclePrincipal*>(elemento.nodo)->instrucciones = lista;
+    }
+
+    // Fin del tramo nuevo que empieza en inicio: el primer tramo anterior
+    // que empezaba pasado lo reemplazado, si no queda lejos
+    size_t corte(size_t inicio, const Edicion* edicion) const {
+        const size_t porDefecto = inicio + detalle_incremental::TOKENS_POR_TRAMO;
+        if (!edicion) return porDefecto;
+        const size_t desde = inicio < edicion->finNuevo ? edicion->finViejo : inicio - edicion->desplazamiento + 1;
+        Elemento* viejo = elementoEn(desde);
+        if (!viejo) return porDefecto;
+        auto it = primerTramoDesde(*viejo, desde);
+        if (it == viejo->tramos.end()) return porDefecto;
+        const size_t siguiente = (*it)->datos.inicio + edicion->desplazamiento;
+        return siguiente - inicio <= 2 * detalle_incremental::TOKENS_POR_TRAMO ? siguiente : porDefecto;
+    }
+
+    // Saca de su elemento anterior (que se descarta) el tramo que se puede
+    // usar tal cual en inicio: uno que terminaba antes del primer token
+    // reemplazado o uno que empezaba pasado lo reemplazado
+    std::unique_ptr<TramoCuerpo> tomarTramoAnterior(const Edicion& edicion, size_t inicio, bool bucle,
+                                            const TokensEditables& tokens) {
+        size_t viejo;
+        if (inicio < edicion.primerToken) viejo = inicio;
+        else if (inicio >= edicion.finNuevo) viejo = inicio - edicion.desplazamiento;
+        else return nullptr;
+        Elemento* anterior = elementoEn(viejo);
+        if (!anterior) return nullptr;
+        auto it = primerTramoDesde(*anterior, viejo);
+        if (it == anterior->tramos.end() || (*it)->datos.inicio != viejo || (*it)->datos.bucle != bucle ||
+            !(*it)->datos.memoria) {
+            return nullptr;
+        }
+        if (inicio < edicion.primerToken && (*it)->datos.fin >= edicion.primerToken) return nullptr;
+
+        std::unique_ptr<TramoCuerpo> tramoCuerpo = std::move(*it);
+        correrTramo(*tramoCuerpo, inicio - viejo);
+        const int lineas = tokens[inicio].line - tramoCuerpo->linea;
+        if (lineas != 0) {
+            detalle_incremental::DesplazadorLineas desplazador(lineas, false);
+            for (Nodo* instruccion : tramoCuerpo->datos.instrucciones) desplazador.visitar(instruccion);
+            desplazarTramo(*tramoCuerpo, lineas);
+        }
+        return tramoCuerpo;
+    }
+
+    // Anota en el tramo que se analiza cada PuntoArgumentos. Si un tramo
+    // anterior tenía el mismo punto fuera de lo reemplazado, se toma lo
+    // que sacó desde ahí: antes de lo reemplazado, hasta su último punto
+    // que no lo leyó, y pasado lo reemplazado, hasta el fin de la lista.
+    // Suma a reutilizados los tokens que tomó.
+    bool seguirArgumentos(TramoCuerpo& tramoCuerpo, size_t base, const PuntoArgumentos& punto,
+                          ArgumentosAnteriores& anteriores, const Edicion* edicion, const TokensEditables& tokens,
+                          size_t& reutilizados) {
+        const size_t posicion = base + punto.posicion;
+        const int linea = posicion < tokens.size() ? tokens[posicion].line : tramoCuerpo.linea;
+        const PuntoTramo nuevo{static_cast<uint32_t>(posicion - tramoCuerpo.datos.inicio), linea - tramoCuerpo.linea,
+                               punto.llamada, static_cast<uint32_t>(punto.argumentos),
+                               static_cast<uint32_t>(punto.errores), static_cast<uint32_t>(punto.referencias), punto.fin};
+        tramoCuerpo.puntos.push_back(nuevo);
+        if (punto.fin || !edicion || posicion >= tokens.size()) return false;
+
+        size_t viejo;
+        if (posicion < edicion->primerToken) viejo = posicion;
+        else if (posicion >= edicion->finNuevo) viejo = posicion - edicion->desplazamiento;
+        else return false;
+        Elemento* elemento = elementoEn(viejo);
+        if (!elemento) return false;
+        auto siguiente = primerTramoDesde(*elemento, viejo + 1);
+        if (siguiente == elemento->tramos.begin() || !*std::prev(siguiente)) return false;
+        TramoCuerpo& anterior = **std::prev(siguiente);
+        const TramoInstrucciones& datos = anterior.datos;
+        if (datos.memoria) {
+            // Con demasiados nodos muertos de tomas anteriores se analiza de nuevo
+            const size_t vivos = detalle_incremental::BYTES_POR_TOKEN * (datos.fin - datos.inicio);
+            if (datos.memoria->bytesReservados() > 4 * vivos + detalle_incremental::BYTES_TRAMO) return false;
+        } else if (anterior.receptor != &tramoCuerpo) {
+            return false;
+        }
+
+        // Las llamadas no se anidan: los puntos entre desde y hasta son
+        // todos de la misma lista
+        const auto& puntos = anterior.puntos;
+        auto desde = std::lower_bound(puntos.begin(), puntos.end(), viejo - datos.inicio,
+                                      [](const PuntoTramo& otro, size_t valor) { return otro.posicion < valor; });
+        if (desde == puntos.end() || datos.inicio + desde->posicion != viejo || desde->fin) return false;
+        auto hasta = desde;
+        if (posicion < edicion->primerToken) {
+            for (auto it = desde + 1; it != puntos.end() && datos.inicio + it->posicion < edicion->primerToken; ++it) {
+                if (it->llamada == desde->llamada) hasta = it;
+            }
+            if (hasta == desde) return false;
+        } else {
+            for (++hasta; hasta != puntos.end() && !(hasta->fin && hasta->llamada == desde->llamada); ++hasta) {}
+            if (hasta == puntos.end()) return false;
+        }
+
+        if (datos.memoria) {
+            tramoCuerpo.datos.memoria->absorber(std::move(*anterior.datos.memoria));
+            anterior.datos.memoria.reset();
+            anterior.receptor = &tramoCuerpo;
+        }
+        anteriores.argumentos = {desde->llamada->argumentos.datos + desde->argumentos, hasta->argumentos - desde->argumentos};
+        anteriores.errores = {anterior.datos.errores.data() + desde->errores, hasta->errores - desde->errores};
+        anteriores.primerError = desde->errores;
+        anteriores.referencias = {anterior.datos.referencias.data() + desde->referencias,
+                                  hasta->referencias - desde->referencias};
+        anteriores.fin = datos.inicio + hasta->posicion + (posicion - viejo) - base;
+        reutilizados += hasta->posicion - desde->posicion;
+
+        const int lineas = linea - (anterior.linea + desde->linea);
+        if (lineas != 0) {
+            detalle_incremental::DesplazadorLineas desplazador(lineas, false);
+            for (NodoExpresion* argumento : anteriores.argumentos) desplazador.visitar(argumento);
+            for (const ReferenciaDiferida& referencia : anteriores.referencias) {
+                if (referencia.variable->linea > 0) referencia.variable->linea += lineas;
+            }
+            detalle_incremental::desplazarLineas(anteriores.errores, lineas);
+        }
+
+        // Los puntos tomados pasan al tramo nuevo; el fin de la lista lo
+        // anota el parser al salir de ella
+        for (auto it = desde + 1; it <= hasta && !it->fin; ++it) {
+            tramoCuerpo.puntos.push_back({nuevo.posicion + (it->posicion - desde->posicion),
+                                          nuevo.linea + (it->linea - desde->linea), punto.llamada,
+                                          nuevo.argumentos + (it->argumentos - desde->argumentos),
+                                          nuevo.errores + (it->errores - desde->errores),
+                                          nuevo.referencias + (it->referencias - desde->referencias), false});
+        }
+        return true;
+    }
+
+    // Elemento anterior que contiene la posición, o nullptr
+    Elemento* elementoEn(size_t posicion) const {
+        auto it = std::upper_bound(elementos.begin(), elementos.end(), posicion,
+                                   [](size_t valor, const auto& elemento) { return valor < elemento->inicio; });
+        if (it == elementos.begin()) return nullptr;
+        Elemento* elemento = std::prev(it)->get();
+        return posicion < elemento->fin ? elemento : nullptr;
+    }
+
+    // Primer tramo del elemento que empieza en posicion o después. Los
+    // nulos (ya tomados) siempre están antes de lo que se busca, porque
+    // la lista se recorre hacia adelante.
+    static std::vector<std::unique_ptr<TramoCuerpo>>::iterator primerTramoDesde(Elemento& elemento, size_t posicion) {
+        return std::lower_bound(elemento.tramos.begin(), elemento.tramos.end(), posicion,
+                                [](const auto& tramoCuerpo, size_t valor) {
+                                    return !tramoCuerpo || tramoCuerpo->datos.inicio < valor;
+                                });
+    }
+
+    void completar(Elemento& elemento, Parser& parser, const TokensEditables& tokens,
+                   std::vector<Error>& erroresParser) {
+        elemento.linea = elemento.inicio < tokens.size() ? tokens[elemento.inicio].line : 0;
+        if (elemento.bloque) {
+            elemento.huella = 0; // Se reutiliza de a tramos, no entero
+        } else {
+            elemento.errores = std::move(erroresParser);
+            elemento.huella = huellaTokens(tokens, elemento.inicio, elemento.fin);
+        }
+        elemento.declara = false;
+        if (auto decl = comoNodo<NodoDeclaracion>(elemento.nodo)) {
+            elemento.declara = true;
+            elemento.simbolo = *parser.obtenerTablaSimbolos().buscar(decl->simbolo);
+        }
+
+        // Las consultas repetidas a un símbolo vieron todas el mismo estado
+        auto& consultas = elemento.consultas;
+        std::sort(consultas.begin(), consultas.end(),
+                  [](const ConsultaSimbolo& a, const ConsultaSimbolo& b) { return a.id < b.id; });
+        consultas.erase(std::unique(consultas.begin(), consultas.end(),
+                                    [](const ConsultaSimbolo& a, const ConsultaSimbolo& b) { return a.id == b.id; }),
+                        consultas.end());
+    }
+
+    // Vuelve a analizar un elemento en su lugar (mismos tokens, otros
+    // símbolos). Solo consultan la tabla los elementos que no son bloques.
+    void reanalizar(Elemento& elemento, const TokensEditables& tokens) {
+        desregistrar(&elemento);
+        quitarOrdenado(conErrores, &elemento);
+
+        std::vector<Error> erroresParser;
+        const size_t base = std::min(elemento.inicio, tokens.size() - 1);
+        const size_t inicio = elemento.inicio;
+        elemento.memoria = std::make_unique<Arena>(detalle_incremental::BYTES_ELEMENTO);
+        Parser parser(tokens, base, erroresParser, *elemento.memoria);
+        parser.usarConsultaExterna([this, inicio](SimboloId id) { return declaracionAntes(id, inicio); });
+        parser.irA(inicio - base);
+        parser.finDeElementos();
+        elemento.consultas.clear();
+        parser.anotarConsultas(&elemento.consultas);
+        elemento.nodo = nullptr;
+        elemento.tieneNodo = parser.analizarElemento(elemento.nodo);
+        parser.anotarConsultas(nullptr);
+        completar(elemento, parser, tokens, erroresParser);
+
+        registrar(&elemento);
+        if (tieneErrores(elemento)) insertarOrdenado(conErrores, &elemento);
+        if (elemento.tieneNodo) {
+            size_t indice = static_cast<size_t>(
+                std::lower_bound(elementos.begin(), elementos.end(), inicio,
+                                 [](const auto& otro, size_t valor) { return otro->inicio < valor; }) -
+                elementos.begin());
+            nodos[indice - contarAntes(sinNodo, inicio)] = elemento.nodo;
+        }
+    }
+
+    void cerrar(Parser& parser, size_t inicio, std::vector<Error>& erroresParser) {
+        inicioCierre = inicio;
+        parser.analizarCierre();
+        erroresCierre = std::move(erroresParser);
+    }
+
+    //--------------------------------------------------
+    // Variables de los tramos
+    //--------------------------------------------------
+    void marcarPendiente(TramoCuerpo* tramoCuerpo) {
+        if (tramoCuerpo->pendiente) return;
+        tramoCuerpo->pendiente = true;
+        pendientes.push_back(tramoCuerpo);
+    }
+
+    // Como Parser::tomarTramo: cada variable ve la última declaración
+    // anterior al tramo. Las que no la tienen quedan anotadas, y su error
+    // se arma en armarPrograma.
+    void resolver(TramoCuerpo& tramoCuerpo) {
+        const TramoInstrucciones& datos = tramoCuerpo.datos;
+        tramoCuerpo.sinDeclarar.clear();
+        for (size_t i = 0; i < datos.referencias.size(); ++i) {
+            NodoVariable* variable = datos.referencias[i].variable;
+            const Simbolo* simbolo = declaracionAntes(variable->simbolo, datos.inicio);
+            variable->tipoDato = textoTipoDato(simbolo ? simbolo->tipo : INDEFINIDO);
+            if (!simbolo) tramoCuerpo.sinDeclarar.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    static bool tieneErrores(const Elemento& elemento) {
+        if (!elemento.errores.empty() || !elemento.erroresFin.empty()) return true;
+        for (const auto& tramoCuerpo : elemento.tramos) {
+            if (!tramoCuerpo->datos.errores.empty() || !tramoCuerpo->sinDeclarar.empty()) return true;
+        }
+        return false;
+    }
+
+    // Resuelve los tramos pendientes y corrige qué bloques tienen errores
+    void resolverPendientes() {
+        std::vector<Elemento*> cambiados;
+        for (TramoCuerpo* tramoCuerpo : pendientes) {
+            resolver(*tramoCuerpo);
+            tramoCuerpo->pendiente = false;
+            Elemento* elemento = tramoCuerpo->elemento;
+            if (elemento->cambiado) continue;
+            elemento->cambiado = true;
+            cambiados.push_back(elemento);
+        }
+        pendientes.clear();
+        for (Elemento* elemento : cambiados) {
+            elemento->cambiado = false;
+            const size_t indice = contarAntes(conErrores, elemento->inicio);
+            const bool estaba = indice < conErrores.size() && conErrores[indice] == elemento;
+            if (estaba == tieneErrores(*elemento)) continue;
+            if (estaba) conErrores.erase(conErrores.begin() + indice);
+            else conErrores.insert(conErrores.begin() + indice, elemento);
+        }
+    }
+
+    //--------------------------------------------------
+    // Reubicación
+    //--------------------------------------------------
+    // Reubica un elemento reutilizado en otra posición de la lista
+    void mover(Elemento& elemento, size_t inicio, const TokensEditables& tokens) {
+        int lineas = tokens[inicio].line - elemento.linea;
+        correr(elemento, inicio - elemento.inicio);
+        desplazar(elemento, lineas);
+    }
+
+    // Corre los índices de un elemento y sus tramos (aritmética modular)
+    static void correr(Elemento& elemento, size_t desplazamiento) {
+        elemento.inicio += desplazamiento;
+        elemento.fin += desplazamiento;
+        for (auto& tramoCuerpo : elemento.tramos) correrTramo(*tramoCuerpo, desplazamiento);
+    }
+
+    static void correrTramo(TramoCuerpo& tramoCuerpo, size_t desplazamiento) {
+        tramoCuerpo.datos.inicio += desplazamiento;
+        tramoCuerpo.datos.hasta += desplazamiento;
+        tramoCuerpo.datos.fin += desplazamiento;
+    }
+
+    void desplazar(Elemento& elemento, int lineas) {
+        if (lineas == 0) return;
+        elemento.linea += lineas;
+        if (elemento.nodo) detalle_incremental::DesplazadorLineas(lineas, !elemento.bloque).visitar(elemento.nodo);
+        detalle_incremental::desplazarLineas(elemento.errores, lineas);
+        if (elemento.declara && elemento.simbolo.lineaDeclaracion > 0) elemento.simbolo.lineaDeclaracion += lineas;
+        for (auto& tramoCuerpo : elemento.tramos) desplazarTramo(*tramoCuerpo, lineas);
+        detalle_incremental::desplazarLineas(elemento.erroresFin, lineas);
+    }
+
+    // Las líneas del tramo y de sus variables; los demás nodos se corren aparte
+    static void desplazarTramo(TramoCuerpo& tramoCuerpo, int lineas) {
+        tramoCuerpo.linea += lineas;
+        for (const ReferenciaDiferida& referencia : tramoCuerpo.datos.referencias) {
+            if (referencia.variable->linea > 0) referencia.variable->linea += lineas;
+        }
+        detalle_incremental::desplazarLineas(tramoCuerpo.datos.errores, lineas);
+    }
+
+    // Índice del elemento anterior que empezaba en inicio (buscando desde
+    // desde), o elementos.size()
+    size_t buscarInicio(size_t desde, size_t inicio) const {
+        auto it = std::lower_bound(elementos.begin() + desde, elementos.end(), inicio,
+                                   [](const auto& elemento, size_t valor) { return elemento->inicio < valor; });
+        return it != elementos.end() && (*it)->inicio == inicio ? static_cast<size_t>(it - elementos.begin())
+                                                                : elementos.size();
+    }
+
+    // Un elemento anterior con los mismos tokens que los que empiezan en
+    // posicion: se prueba el que empezaba en el mismo índice y el que
+    // empezaba en el índice desplazado por la edición
+    size_t buscarIgual(const TokensEditables& tokens, size_t desde, size_t posicion, size_t desplazamiento) const {
+        for (size_t inicio : {posicion, posicion - desplazamiento}) {
+            size_t indice = buscarInicio(desde, inicio);
+            if (indice == elementos.size()) continue;
+            const Elemento& elemento = *elementos[indice];
+            if (elemento.huella != 0 &&
+                elemento.huella == huellaTokens(tokens, posicion, posicion + (elemento.fin - elemento.inicio))) {
+                return indice;
+            }
+        }
+        return elementos.size();
+    }
+
+    // Lugar en la tabla que sigue a los símbolos declarados por primera
+    // vez antes del elemento
+    size_t ordenDespues(const Elemento& elemento) const {
+        size_t indice = static_cast<size_t>(
+            std::lower_bound(elementos.begin(), elementos.end(), elemento.inicio,
+                             [](const auto& otro, size_t valor) { return otro->inicio < valor; }) -
+            elementos.begin());
+        while (indice > 0) {
+            const Elemento& anterior = *elementos[--indice];
+            if (anterior.declara && declarantes[anterior.simbolo.id].front() == &anterior) {
+                return tabla.orden(anterior.simbolo.id) + 1;
+            }
+        }
+        return 0;
+    }
+
+    // Estado del símbolo justo antes de la posición: su última declaración
+    const Simbolo* declaracionAntes(SimboloId id, size_t posicion) const {
+        if (id >= declarantes.size()) return nullptr;
+        const auto& lista = declarantes[id];
+        size_t antes = contarAntes(lista, posicion);
+        return antes > 0 ? &lista[antes - 1]->simbolo : nullptr;
+    }
+
+    static uint64_t estadoConsultado(const Elemento& elemento, SimboloId id) {
+        auto it = std::lower_bound(elemento.consultas.begin(), elemento.consultas.end(), id,
+                                   [](const ConsultaSimbolo& consulta, SimboloId valor) { return consulta.id < valor; });
+        return it != elemento.consultas.end() && it->id == id ? it->estado : 0;
+    }
+
+    //--------------------------------------------------
+    // Listas de elementos ordenadas por posición
+    //--------------------------------------------------
+    static size_t contarAntes(const std::vector<Elemento*>& lista, size_t posicion) {
+        return static_cast<size_t>(
+            std::lower_bound(lista.begin(), lista.end(), posicion,
+                             [](const Elemento* elemento, size_t valor) { return elemento->inicio < valor; }) -
+            lista.begin());
+    }
+
+    static void insertarOrdenado(std::vector<Elemento*>& lista, Elemento* elemento) {
+        lista.insert(lista.begin() + contarAntes(lista, elemento->inicio), elemento);
+    }
+
+    static void quitarOrdenado(std::vector<Elemento*>& lista, Elemento* elemento) {
+        size_t indice = contarAntes(lista, elemento->inicio);
+        if (indice < lista.size() && lista[indice] == elemento) lista.erase(lista.begin() + indice);
+    }
+
+    template <typename T>
+    static void reemplazar(std::vector<T>& lista, size_t desde, size_t hasta, const std::vector<T>& nuevos) {
+        if (hasta - desde == nuevos.size()) {
+            std::copy(nuevos.begin(), nuevos.end(), lista.begin() + desde);
+            return;
+        }
+        lista.erase(lista.begin() + desde, lista.begin() + hasta);
+        lista.insert(lista.begin() + desde, nuevos.begin(), nuevos.end());
+    }
+
+    // Cambia los elementos de la lista que empiezan en [desde, hasta) por
+    // los del tramo que cumplen la condición
+    template <typename Condicion>
+    static void reemplazarTramo(std::vector<Elemento*>& lista, size_t desde, size_t hasta,
+                                const std::vector<Elemento*>& tramo, Condicion condicion) {
+        std::vector<Elemento*> nuevos;
+        for (Elemento* elemento : tramo) {
+            if (condicion(*elemento)) nuevos.push_back(elemento);
+        }
+        reemplazar(lista, contarAntes(lista, desde), contarAntes(lista, hasta), nuevos);
+    }
+
+    // Quita una aparición de valor de una lista sin orden
+    template <typename T>
+    static void quitarUno(std::vector<T*>& lista, T* valor) {
+        auto it = std::find(lista.begin(), lista.end(), valor);
+        if (it == lista.end()) return;
+        *it = lista.back();
+        lista.pop_back();
+    }
+
+    void registrar(Elemento* elemento) {
+        if (elemento->declara) {
+            if (elemento->simbolo.id >= declarantes.size()) declarantes.resize(elemento->simbolo.id + 1);
+            insertarOrdenado(declarantes[elemento->simbolo.id], elemento);
+        }
+        for (const ConsultaSimbolo& consulta : elemento->consultas) {
+            if (consulta.id >= consultores.size()) consultores.resize(consulta.id + 1);
+            consultores[consulta.id].push_back(elemento);
+        }
+    }
+
+    // Los tramos se registran al analizarlos, y siguen registrados si pasan
+    // a otro elemento
+    void registrarTramo(TramoCuerpo* tramoCuerpo) {
+        for (const ReferenciaDiferida& referencia : tramoCuerpo->datos.referencias) {
+            const SimboloId id = referencia.variable->simbolo;
+            if (id >= referentes.size()) referentes.resize(id + 1);
+            referentes[id].push_back(tramoCuerpo);
+        }
+    }
+
+    void desregistrar(Elemento* elemento) {
+        if (elemento->declara) quitarOrdenado(declarantes[elemento->simbolo.id], elemento);
+        for (const ConsultaSimbolo& consulta : elemento->consultas) quitarUno(consultores[consulta.id], elemento);
+        for (const auto& tramoCuerpo : elemento->tramos) {
+            if (!tramoCuerpo) continue;
+            for (const ReferenciaDiferida& referencia : tramoCuerpo->datos.referencias) {
+                quitarUno(referentes[referencia.variable->simbolo], tramoCuerpo.get());
+            }
+        }
+    }
+
+    //--------------------------------------------------
+    // Errores del programa
+    //--------------------------------------------------
+    // Recorre los errores de los elementos en el orden del programa. Un
+    // "Variable no declarada" de un tramo llega como (nullptr, su variable),
+    // en su lugar entre los sintácticos.
+    template <typename Visitante>
+    void recorrerErrores(Visitante&& visitar) {
+        for (Elemento* elemento : conErrores) {
+            for (Error& error : elemento->errores) visitar(&error, nullptr);
+            for (auto& tramoCuerpo : elemento->tramos) {
+                TramoInstrucciones& datos = tramoCuerpo->datos;
+                size_t error = 0;
+                for (uint32_t indice : tramoCuerpo->sinDeclarar) {
+                    const ReferenciaDiferida& referencia = datos.referencias[indice];
+                    for (; error < referencia.error; ++error) visitar(&datos.errores[error], nullptr);
+                    visitar(nullptr, referencia.variable);
+                }
+                for (; error < datos.errores.size(); ++error) visitar(&datos.errores[error], nullptr);
+            }
+            for (Error& error : elemento->erroresFin) visitar(&error, nullptr);
+        }
+    }
+
+    // Los errores de los elementos se mueven a erroresPrograma, porque
+    // copiarlos cuesta casi lo mismo que volver a analizar el programa
+    // cuando son muchos, y devolverErrores los regresa a su lugar antes de
+    // tocar los elementos. Entre una y otra la lista de elementos no cambia.
+    void armarPrograma() {
+        erroresPrograma = erroresEncabezado;
+        recorrerErrores([this](Error* error, const NodoVariable* variable) {
+            if (error) {
+                erroresPrograma.push_back(std::move(*error));
+                return;
+            }
+            erroresPrograma.push_back({"Variable no declarada: " + std::string(variable->nombre()), variable->linea,
+                                       variable->columna, "Semantico"});
+        });
+        erroresPrograma.insert(erroresPrograma.end(), erroresCierre.begin(), erroresCierre.end());
+        programa->declaraciones = Lista<Nodo*>{nodos.data(), static_cast<uint32_t>(nodos.size())};
+    }
+
+    void devolverErrores() {
+        size_t indice = erroresEncabezado.size();
+        recorrerErrores([this, &indice](Error* error, const NodoVariable*) {
+            if (error) *error = std::move(erroresPrograma[indice]);
+            indice++;
+        });
+        erroresPrograma.clear();
+    }
+};
+
+#endif // PARSER_INCREMENTAL_H
@@ -0,0 +1,109 @@
+#ifndef PARSER_PARALELO_H
+#define PARSER_PARALELO_H
+
+#include "lexerParalelo.h"
+#include "parser.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Análisis sintáctico en paralelo de los cuerpos de configurar y
+// bucle_principal, que en los programas generados llegan a tener cientos
+// de miles de llamadas.
+//
+// Una pasada previa busca en la lista de tokens cada TOKEN_CONFIGURAR o
+// TOKEN_BUCLE_PRINCIPAL y el fin de bloque que lo sigue, y corta los
+// cuerpos largos en tramos justo después de un ';' seguido del comienzo
+// de una instrucción. Cada tramo se analiza en su propio hilo con un
+// parser aparte, desde su inicio hasta la primera instrucción que empiece
+// en el corte siguiente o después.
+//
+// Lo único que ata un bloque al resto del programa son las variables de
+// los argumentos. El hilo las deja sin resolver (ReferenciaDiferida) y el
+// parser principal, al pasar por el inicio del tramo, las busca en su
+// tabla, que es la de ese punto del programa, e intercala los "Variable no
+// declarada" con los errores del tramo. Así el árbol, la tabla y los
+// diagnósticos salen idénticos (y en el mismo orden) que en serie.
+//
+// Los cortes son una suposición: si una recuperación de errores salta por
+// encima de un corte, o un bloque no empieza donde la pasada previa creyó,
+// el parser principal nunca llega a ese inicio y analiza esa parte en
+// serie hasta volver a coincidir con el inicio de un tramo.
+
+namespace detalle_paralelo {
+
+// Tamaño mínimo de un tramo, en tokens; por debajo no compensa repartir
+constexpr size_t TAM_MINIMO_TRAMO = size_t(1) << 15;
+
+inline bool iniciaInstruccion(TokenType tipo, bool bucle) {
+    return bucle ? tipo == TOKEN_ESCRIBIR || tipo == TOKEN_ESPERAR : tipo == TOKEN_CONFIGURAR_PIN;
+}
+
+inline bool terminaBloque(TokenType tipo) {
+    return tipo == TOKEN_FIN_CONFIGURAR || tipo == TOKEN_FIN_BUCLE || tipo == TOKEN_FIN_PROGRAMA;
+}
+
+} // namespace detalle_paralelo
+
+// Analiza en paralelo (0 hilos = tantos como núcleos) los tramos de los
+// cuerpos de bloque de una lista de tokens del lexer, para pasarlos a
+// Parser::usarTramos con la misma lista. Si los cuerpos no alcanzan para
+// dos tramos no devuelve ninguno.
+inline std::vector<TramoInstrucciones> analizarTramosEnParalelo(
+    const std::vector<Token>& tokens, unsigned hilos = 0,
+    size_t tamMinimoTramo = detalle_paralelo::TAM_MINIMO_TRAMO) {
+    using namespace detalle_paralelo;
+    if (hilos == 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+    if (tamMinimoTramo == 0) tamMinimoTramo = 1;
+    std::vector<TramoInstrucciones> tramos;
+    if (hilos == 1) return tramos;
+
+    // 1. Cuerpos de bloque: del token siguiente al que abre hasta el fin
+    struct Cuerpo {
+        size_t inicio;
+        size_t fin;
+        bool bucle;
+    };
+    std::vector<Cuerpo> cuerpos;
+    size_t totalCuerpos = 0;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens[i].type != TOKEN_CONFIGURAR && tokens[i].type != TOKEN_BUCLE_PRINCIPAL) continue;
+        size_t fin = i + 1;
+        while (fin < tokens.size() && !terminaBloque(tokens[fin].type)) fin++;
+        if (fin - (i + 1) >= tamMinimoTramo) {
+            cuerpos.push_back({i + 1, fin, tokens[i].type == TOKEN_BUCLE_PRINCIPAL});
+            totalCuerpos += fin - (i + 1);
+        }
+        i = fin;
+    }
+    if (totalCuerpos < 2 * tamMinimoTramo) return tramos;
+
+    // 2. Cortes: unos cuatro tramos por hilo
+    size_t tamTramo = std::max(tamMinimoTramo, totalCuerpos / (size_t(hilos) * 4));
+    for (const Cuerpo& cuerpo : cuerpos) {
+        size_t inicio = cuerpo.inicio;
+        while (inicio < cuerpo.fin) {
+            size_t corte = std::min(inicio + tamTramo, cuerpo.fin);
+            while (corte < cuerpo.fin && !(tokens[corte - 1].type == TOKEN_PUNTO_COMA &&
+                                           iniciaInstruccion(tokens[corte].type, cuerpo.bucle))) {
+                corte++;
+            }
+            tramos.emplace_back();
+            tramos.back().inicio = inicio;
+            tramos.back().hasta = corte;
+            tramos.back().bucle = cuerpo.bucle;
+            inicio = corte;
+        }
+    }
+
+    // 3. Cada tramo con su parser, sobre la lista desde su inicio
+    ejecutarEnParalelo(tramos.size(), hilos, [&](size_t i) {
+        TramoInstrucciones& tramo = tramos[i];
+        Parser parser(tokens.data() + tramo.inicio, tokens.size() - tramo.inicio, tramo.errores, *tramo.memoria);
+        parser.diferirReferencias(&tramo.referencias);
+        parser.analizarTramo(tramo, tramo.inicio);
+    });
+    return tramos;
+}
+
+#endif // PARSER_PARALELO_H
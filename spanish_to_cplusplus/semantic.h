@@ -6,44 +6,27 @@
 #include <fstream>  // Para manejo de archivos
 #include <vector>   // Para std::vector
 
-class AnalizadorSemantico {
+// Genera salida.cpp recorriendo el AST con VisitanteAST
+class AnalizadorSemantico : public VisitanteAST<AnalizadorSemantico> {
+    friend class VisitanteAST<AnalizadorSemantico>;
+
 private:
     std::vector<Error>& errores;
     TablaSimbolos& tablaSimbolos;
     std::ostringstream codigoIntermedio;
     
-    void generarCodigo(Nodo* nodo) {
-        switch(nodo->tipo) {
-            case NODO_PROGRAMA:
-                generarPrograma(static_cast<NodoPrograma*>(nodo));
-                break;
-            case NODO_DECLARACION:
-                generarDeclaracion(static_cast<NodoDeclaracion*>(nodo));
-                break;
-            case NODO_CONFIGURAR:
-                generarConfigurar(static_cast<NodoConfigurar*>(nodo));
-                break;
-            case NODO_BUCLE_PRINCIPAL:
-                generarBuclePrincipal(static_cast<NodoBuclePrincipal*>(nodo));
-                break;
-            case NODO_LLAMADA_FUNCION:
-                generarLlamadaFuncion(static_cast<NodoLlamadaFuncion*>(nodo));
-                break;
-        }
-    }
-
-  void generarPrograma(NodoPrograma* programa) {
+  void visitarPrograma(NodoPrograma* programa) {
     // Generar declaraciones globales primero
     for (auto& decl : programa->declaraciones) {
         if (decl->tipo == NODO_DECLARACION) {
-            generarCodigo(decl.get());
+            visitar(decl);
         }
     }
     
     codigoIntermedio << "\nvoid setup() {\n";
     for (auto& decl : programa->declaraciones) {
         if (decl->tipo == NODO_CONFIGURAR) {
-            generarCodigo(decl.get());
+            visitar(decl);
         }
     }
     codigoIntermedio << "}\n\n";
@@ -51,13 +34,13 @@ private:
     codigoIntermedio << "void loop() {\n";
     for (auto& decl : programa->declaraciones) {
         if (decl->tipo == NODO_BUCLE_PRINCIPAL) {
-            generarCodigo(decl.get());
+            visitar(decl);
         }
     }
     codigoIntermedio << "}\n";
 }
 
-void generarDeclaracion(NodoDeclaracion* decl) {
+void visitarDeclaracion(NodoDeclaracion* decl) {
     std::string tipoCpp;
     std::string valorTraducido = "";
     
@@ -72,8 +55,8 @@ void generarDeclaracion(NodoDeclaracion* decl) {
             tipoCpp = "String";
             // Traducir valores especiales
             if (decl->expresion) {
-                if (auto lit = dynamic_cast<NodoLiteral*>(decl->expresion.get())) {
-                    std::string valor = lit->valor;
+                if (auto lit = comoNodo<NodoLiteral>(decl->expresion)) {
+                    std::string_view valor = lit->valor;
                     if (valor == "SALIDA") {
                         tipoCpp = "int";
                         valorTraducido = "OUTPUT";
@@ -100,43 +83,56 @@ void generarDeclaracion(NodoDeclaracion* decl) {
             tipoCpp = "auto";
     }
     
-    codigoIntermedio << tipoCpp << " " << decl->identificador;
+    codigoIntermedio << tipoCpp << " " << decl->identificador();
     
     if (!valorTraducido.empty()) {
         codigoIntermedio << " = " << valorTraducido;
     } else if (decl->expresion) {
         codigoIntermedio << " = ";
-        generarExpresion(decl->expresion.get());
+        visitar(decl->expresion);
     }
     
     codigoIntermedio << ";\n";
 }
 
-    void generarExpresion(NodoExpresion* expr) {
-        if (auto var = dynamic_cast<NodoVariable*>(expr)) {
-            codigoIntermedio << var->nombre;
-        } else if (auto lit = dynamic_cast<NodoLiteral*>(expr)) {
-            if (lit->tipoDato == "CADENA") {
-                codigoIntermedio << "\"" << lit->valor << "\"";
-            } else {
-                codigoIntermedio << lit->valor;
-            }
+    void visitarVariable(NodoVariable* var) {
+        codigoIntermedio << var->nombre();
+    }
+
+    void visitarOperacionBinaria(NodoOperacionBinaria* operacion) {
+        generarOperando(operacion->izquierda, operacion->operador, false);
+        codigoIntermedio << " " << textoOperador(operacion->operador) << " ";
+        generarOperando(operacion->derecha, operacion->operador, true);
+    }
+
+    void generarOperando(NodoExpresion* operando, TokenType operador, bool aLaDerecha) {
+        bool parentesis = necesitaParentesis(operando, operador, aLaDerecha);
+        if (parentesis) codigoIntermedio << "(";
+        visitar(operando);
+        if (parentesis) codigoIntermedio << ")";
+    }
+
+    void visitarLiteral(NodoLiteral* lit) {
+        if (lit->tipoDato == "CADENA") {
+            codigoIntermedio << "\"" << lit->valor << "\"";
+        } else {
+            codigoIntermedio << lit->valor;
         }
     }
 
-    void generarConfigurar(NodoConfigurar* config) {
+    void visitarConfigurar(NodoConfigurar* config) {
         for (auto& instr : config->instrucciones) {
-            generarCodigo(instr.get());
+            visitar(instr);
         }
     }
 
-    void generarBuclePrincipal(NodoBuclePrincipal* bucle) {
+    void visitarBuclePrincipal(NodoBuclePrincipal* bucle) {
         for (auto& instr : bucle->instrucciones) {
-            generarCodigo(instr.get());
+            visitar(instr);
         }
     }
 
- void generarLlamadaFuncion(NodoLlamadaFuncion* llamada) {
+ void visitarLlamadaFuncion(NodoLlamadaFuncion* llamada) {
     if (llamada->nombre == "configurar_pin") {
         codigoIntermedio << "pinMode(";
     } else if (llamada->nombre == "escribir") {
@@ -146,9 +142,9 @@ void generarDeclaracion(NodoDeclaracion* decl) {
     }
 
     for (size_t i = 0; i < llamada->argumentos.size(); ++i) {
-        if (auto lit = dynamic_cast<NodoLiteral*>(llamada->argumentos[i].get())) {
+        if (auto lit = comoNodo<NodoLiteral>(llamada->argumentos[i])) {
             if (lit->tipoDato == "CADENA") {
-                std::string valor = lit->valor;
+                std::string_view valor = lit->valor;
                 // Traducir valores simbólicos de Arduino
                 if (valor == "SALIDA") codigoIntermedio << "OUTPUT";
                 else if (valor == "ALTO") codigoIntermedio << "HIGH";
@@ -158,7 +154,7 @@ void generarDeclaracion(NodoDeclaracion* decl) {
                 codigoIntermedio << lit->valor;
             }
         } else {
-            generarExpresion(llamada->argumentos[i].get());
+            visitar(llamada->argumentos[i]);
         }
         
         if (i != llamada->argumentos.size() - 1) codigoIntermedio << ", ";
@@ -173,7 +169,7 @@ public:
 
     void analizar(NodoPrograma* programa) {
         codigoIntermedio << "#include <Arduino.h>\n\n";
-        generarCodigo(programa);
+        visitar(programa);
     }
 
     void guardarEnArchivo(const std::string& nombreArchivo) {
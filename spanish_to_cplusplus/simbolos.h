@@ -1,9 +1,12 @@
 #ifndef SIMBOLOS_H
 #define SIMBOLOS_H
 
+#include "cadenas.h"
+#include <algorithm>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <variant>
+#include <vector>
 
 enum TipoDato {
     ENTERO,
@@ -13,27 +16,200 @@ enum TipoDato {
     INDEFINIDO
 };
 
+// El nombre no se copia: se guarda el id internado en cadenasGlobales()
 struct Simbolo {
-    std::string nombre;
+    SimboloId id;
     TipoDato tipo;
     int lineaDeclaracion;
     std::string valor;
+
+    std::string_view nombre() const { return cadenasGlobales().texto(id); }
 };
 
+// Tabla de símbolos con direccionamiento abierto, como TablaCadenas: un
+// arreglo plano de casillas con el hash del id y la posición del símbolo,
+// sin nodos ni una copia de la clave. Los símbolos quedan en un vector en
+// orden de declaración, y la memoria depende de cuántos se declaran, no de
+// cuántos identificadores haya internado el programa.
+//
+// Ámbitos anidados con un registro para deshacer: una declaración dentro
+// de un ámbito se agrega al final de simbolos (y tapa a la de un ámbito de
+// afuera si tiene el mismo nombre) y anota lo que tenía su casilla.
+// Cerrar el ámbito recorre solo sus propias anotaciones, así que abrir y
+// cerrar cuestan O(1) amortizado por declaración, sin importar la
+// profundidad, y buscar sigue siendo una sola búsqueda en las casillas.
 class TablaSimbolos {
+private:
+    // posicion es la del símbolo en simbolos + 1 (0 = casilla libre). El
+    // hash es una biyección del id, así que comparar hashes es comparar
+    // ids y una búsqueda no lee los símbolos.
+    struct Casilla {
+        uint32_t hash = 0;
+        uint32_t posicion = 0;
+    };
+
+    // Lo que había en la casilla antes de una declaración en un ámbito
+    // anidado (anterior = 0: el nombre no estaba declarado)
+    struct Sombra {
+        uint32_t hash;
+        uint32_t anterior;
+    };
+
+    // Dónde empieza cada ámbito abierto en simbolos y en deshacer
+    struct Ambito {
+        uint32_t primerSimbolo;
+        uint32_t primeraSombra;
+    };
+
+    static constexpr size_t TAM_INICIAL = 16; // Potencia de dos
+
+    std::vector<Simbolo> simbolos;
+    std::vector<Casilla> casillas; // Sondeo lineal, ocupación hasta la mitad
+    std::vector<Sombra> deshacer;
+    std::vector<Ambito> ambitos;   // Vacío = solo el ámbito global
+
 public:
-    std::unordered_map<std::string, Simbolo> simbolos;
-    
+    // Declara el símbolo en el ámbito actual; si ya estaba declarado en él
+    // lo reemplaza
     void insertar(const Simbolo& simbolo) {
-        simbolos[simbolo.nombre] = simbolo;
+        reservarUno();
+        uint32_t hash = mezclar(simbolo.id);
+        Casilla& casilla = casillas[ubicar(hash)];
+        if (casilla.posicion > inicioAmbito()) {
+            simbolos[casilla.posicion - 1] = simbolo;
+            return;
+        }
+        if (!ambitos.empty()) deshacer.push_back({hash, casilla.posicion});
+        simbolos.push_back(simbolo);
+        casilla = {hash, static_cast<uint32_t>(simbolos.size())};
+    }
+
+    Simbolo* buscar(SimboloId id) {
+        if (casillas.empty()) return nullptr;
+        const Casilla& casilla = casillas[ubicar(mezclar(id))];
+        return casilla.posicion == 0 ? nullptr : &simbolos[casilla.posicion - 1];
+    }
+
+    Simbolo* buscar(std::string_view nombre) {
+        SimboloId id = cadenasGlobales().buscar(nombre);
+        return id == SIN_SIMBOLO ? nullptr : buscar(id);
+    }
+
+    // Solo si está declarado en el ámbito actual (para las redeclaraciones)
+    Simbolo* buscarEnAmbito(SimboloId id) {
+        Simbolo* simbolo = buscar(id);
+        return simbolo && static_cast<size_t>(simbolo - simbolos.data()) >= inicioAmbito() ? simbolo : nullptr;
+    }
+
+    void abrirAmbito() {
+        ambitos.push_back({static_cast<uint32_t>(simbolos.size()), static_cast<uint32_t>(deshacer.size())});
+    }
+
+    // Olvida las declaraciones del ámbito actual y vuelve a mostrar las
+    // que tapaban
+    void cerrarAmbito() {
+        if (ambitos.empty()) return;
+        Ambito ambito = ambitos.back();
+        ambitos.pop_back();
+        for (size_t i = deshacer.size(); i-- > ambito.primeraSombra;) {
+            size_t casilla = ubicar(deshacer[i].hash);
+            if (deshacer[i].anterior != 0) {
+                casillas[casilla].posicion = deshacer[i].anterior;
+            } else {
+                liberar(casilla);
+            }
+        }
+        deshacer.resize(ambito.primeraSombra);
+        simbolos.erase(simbolos.begin() + ambito.primerSimbolo, simbolos.end());
     }
 
-    Simbolo* buscar(const std::string& nombre) {
-        auto it = simbolos.find(nombre);
-        return (it != simbolos.end()) ? &it->second : nullptr;
+    // Ámbitos abiertos dentro del global
+    size_t profundidad() const { return ambitos.size(); }
+
+    // Los símbolos de los ámbitos abiertos, en orden de declaración
+    const std::vector<Simbolo>& todos() const { return simbolos; }
+
+    // El parser incremental reordena la tabla con estas tres; solo valen
+    // con el ámbito global.
+    //
+    // Lugar del símbolo en el orden de declaración (debe estar declarado)
+    size_t orden(SimboloId id) const { return casillas[ubicar(mezclar(id))].posicion - 1; }
+
+    // Inserta un símbolo no declarado en un lugar del orden de declaración
+    void insertarEn(size_t orden, const Simbolo& simbolo) {
+        reservarUno();
+        correrPosiciones(orden, 1);
+        uint32_t hash = mezclar(simbolo.id);
+        casillas[ubicar(hash)] = {hash, static_cast<uint32_t>(orden + 1)};
+        simbolos.insert(simbolos.begin() + orden, simbolo);
+    }
+
+    // Quita un símbolo; los siguientes corren un lugar en el orden
+    void eliminar(SimboloId id) {
+        if (casillas.empty()) return;
+        size_t libre = ubicar(mezclar(id));
+        if (casillas[libre].posicion == 0) return;
+        size_t orden = casillas[libre].posicion - 1;
+        liberar(libre);
+        simbolos.erase(simbolos.begin() + orden);
+        correrPosiciones(orden, -1);
+    }
+
+    void limpiar() {
+        simbolos.clear();
+        casillas.clear();
+        deshacer.clear();
+        ambitos.clear();
+    }
+
+private:
+    // Multiplicación por una constante impar: biyectiva en 32 bits y, con
+    // ids consecutivos, sin colisiones en los bits bajos
+    static uint32_t mezclar(SimboloId id) { return id * 0x9E3779B1u; }
+
+    // Casilla del hash, o la libre donde iría
+    size_t ubicar(uint32_t hash) const {
+        size_t mascara = casillas.size() - 1;
+        size_t i = hash & mascara;
+        while (casillas[i].posicion != 0 && casillas[i].hash != hash) i = (i + 1) & mascara;
+        return i;
+    }
+
+    size_t inicioAmbito() const { return ambitos.empty() ? 0 : ambitos.back().primerSimbolo; }
+
+    // Vacía una casilla. Las que siguen en la racha y no pueden quedar
+    // antes de su lugar ideal se corren al hueco, para no cortar su sondeo.
+    void liberar(size_t libre) {
+        size_t mascara = casillas.size() - 1;
+        for (size_t i = (libre + 1) & mascara; casillas[i].posicion != 0; i = (i + 1) & mascara) {
+            size_t ideal = casillas[i].hash & mascara;
+            if (((i - ideal) & mascara) >= ((i - libre) & mascara)) {
+                casillas[libre] = casillas[i];
+                libre = i;
+            }
+        }
+        casillas[libre] = Casilla();
+    }
+
+    // Deja lugar para un símbolo más sin pasar la mitad de ocupación. Al
+    // rearmar, la declaración más interna de cada nombre pisa a las de
+    // afuera porque viene después.
+    void reservarUno() {
+        if ((simbolos.size() + 1) * 2 <= casillas.size()) return;
+        casillas.assign(std::max(TAM_INICIAL, casillas.size() * 2), Casilla());
+        for (size_t i = 0; i < simbolos.size(); ++i) {
+            uint32_t hash = mezclar(simbolos[i].id);
+            casillas[ubicar(hash)] = {hash, static_cast<uint32_t>(i + 1)};
+        }
     }
 
-    void limpiar() { simbolos.clear(); }
+    // Suma delta a la posición de los símbolos desde el orden indicado: una
+    // pasada de corrido por las casillas en lugar de buscar cada uno
+    void correrPosiciones(size_t desde, int delta) {
+        const uint32_t limite = static_cast<uint32_t>(desde);
+        const uint32_t suma = static_cast<uint32_t>(delta);
+        for (Casilla& casilla : casillas) casilla.posicion += casilla.posicion > limite ? suma : 0;
+    }
 };
 
 inline std::string tipoDatoToString(TipoDato tipo) {
@@ -0,0 +1,313 @@
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+#include "lexer.h"
+#include "bufferTokens.h"
+#include "tokensEditables.h"
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Flujo de tokens del que el parser va tirando a medida que avanza.
+// Con un AnalizadorLexico como origen, los tokens se producen bajo demanda
+// y solo se guarda una ventana circular pequeña, así que la memoria no
+// depende del tamaño del archivo. También puede recorrer una lista de
+// tokens ya construida, propia o prestada (puntero y cantidad, sin
+// copiarla), o un BufferTokens: en ese caso tipoEn() lee el arreglo denso
+// de tipos y los Token completos (con línea y columna) solo se arman
+// cuando alguien los pide. Lo mismo con unos TokensEditables prestados,
+// que se recorren desde el índice que se indique.
+//
+// La secuencia siempre termina con un TOKEN_FIN_PROGRAMA sintético (salvo
+// que el último token ya lo sea), igual que hacía el parser al recibir el
+// vector completo. Ese token no se agrega a la lista: en() lo devuelve al
+// llegar al final, así que una lista prestada nunca se modifica.
+//
+// Los consumidores registrados con alConsumir() reciben cada token del
+// origen en el momento en que se produce, y los de alTerminar() se llaman
+// una vez al producirse el TOKEN_EOF. Sirven para la tabla de tokens y
+// tokens.json sin tener que materializar la lista.
+//
+// Con una lista analizada de antemano, diferirErroresLexicos() hace que
+// sus errores léxicos se cobren al límite compartido con el parser recién
+// al producirse su token, como si el lexer corriera bajo demanda: los
+// errores y los tokens entregados son los mismos que con el lexer como
+// origen, aunque el límite se agote a mitad del archivo.
+class TokenStream {
+public:
+    using Consumidor = std::function<void(const Token&)>;
+    using AlTerminar = std::function<void()>;
+
+    // Tamaño de la ventana de tokens retenidos (potencia de dos)
+    static constexpr size_t VENTANA = 16;
+
+    explicit TokenStream(AnalizadorLexico& lexer) : lexer(&lexer) {}
+
+    // Se queda con la lista (sin copiarla)
+    explicit TokenStream(std::vector<Token>&& tokens) : propia(std::move(tokens)) {
+        lista = propia.data();
+        cantidadLista = propia.size();
+        if (cantidadLista == 0) terminado = true;
+    }
+
+    // Recorre una lista ajena, que debe seguir viva mientras se use el flujo
+    TokenStream(const Token* tokens, size_t cantidad) : lista(tokens), cantidadLista(cantidad) {
+        if (cantidadLista == 0) terminado = true;
+    }
+
+    explicit TokenStream(const std::vector<Token>& tokens) : TokenStream(tokens.data(), tokens.size()) {}
+
+    explicit TokenStream(BufferTokens tokens)
+        : columnas(std::make_unique<BufferTokens>(std::move(tokens))) {
+        if (columnas->empty()) terminado = true;
+        indicesVentana.fill(std::numeric_limits<size_t>::max());
+    }
+
+    // Recorre tokens desde el índice desde (que pasa a ser el 0 del flujo);
+    // la lista debe seguir viva y sin cambios mientras se use el flujo
+    TokenStream(const TokensEditables& tokens, size_t desde) : editables(&tokens), inicioEditables(desde) {
+        if (desde >= editables->size()) terminado = true;
+        indicesVentana.fill(std::numeric_limits<size_t>::max());
+    }
+
+    TokenStream(const TokenStream&) = delete;
+    TokenStream& operator=(const TokenStream&) = delete;
+
+    // Con false, siguienteSincronizacion() no usa el índice del BufferTokens
+    // y la recuperación de errores recorre los tipos (para comparar ambos)
+    void usarIndiceSincronizacion(bool usar) { indiceSincronizacion = usar; }
+
+    void alConsumir(Consumidor consumidor) { consumidores.push_back(std::move(consumidor)); }
+    void alTerminar(AlTerminar accion) { alTerminarAcciones.push_back(std::move(accion)); }
+
+    // Para una lista (o BufferTokens) que el lexer produjo sobre fuente con
+    // un tope de errores propio: errores son los que reportó, y llamadas,
+    // por cada uno, el índice del token que entregó la llamada donde se
+    // reportó (analizadorLexico). Cada error se cobra a limite y se pasa a
+    // destino al producirse ese token. Si el límite se agota, lo que queda
+    // del flujo es lo que habría entregado el lexer detenido: el fin de
+    // archivo, o el token en curso y el fin de archivo.
+    void diferirErroresLexicos(std::string_view fuente, std::vector<Error> errores, std::vector<size_t> llamadas,
+                               std::vector<Error>& destino, LimiteErrores& limite) {
+        diferidos = std::make_unique<ErroresDiferidos>(
+            ErroresDiferidos{fuente, std::move(errores), std::move(llamadas), 0, &destino, destino.size(), &limite});
+    }
+
+    // Errores léxicos diferidos que todavía no se cobraron y se cobrarán
+    // al producir los tokens anteriores a hasta
+    size_t erroresLexicosPendientes(size_t hasta) const {
+        if (!diferidos || cortado()) return 0;
+        auto desde = diferidos->llamadas.begin() + diferidos->cobrados;
+        return static_cast<size_t>(std::lower_bound(desde, diferidos->llamadas.end(), hasta) - desde);
+    }
+
+    // Token en la posición indicada, o nullptr si la secuencia es más corta.
+    // Solo se puede pedir hasta VENTANA tokens por detrás del más reciente.
+    const Token* en(size_t indice) {
+        saltarHasta(indice);
+        while (indice >= total() && !terminado) producir();
+        if (indice >= total()) return nullptr;
+        if (indice == producidos) return &finSintetico;
+        if (indice >= inicioCorte) return &corte[indice - inicioCorte];
+        if (columnas || editables) return &armar(indice);
+        if (!lexer) return &lista[indice];
+        if (producidos - indice > VENTANA) {
+            throw std::logic_error("TokenStream: token fuera de la ventana retenida");
+        }
+        return &ventana[indice & (VENTANA - 1)];
+    }
+
+    // Tipo del token en la posición indicada sin armar el Token; false si
+    // la secuencia es más corta
+    bool tipoEn(size_t indice, TokenType& tipo) {
+        saltarHasta(indice);
+        while (indice >= total() && !terminado) producir();
+        if (indice >= total()) return false;
+        if (indice == producidos) tipo = finSintetico.type;
+        else if (indice >= inicioCorte) tipo = corte[indice - inicioCorte].type;
+        else if (columnas) tipo = columnas->tipo(indice);
+        else if (editables) tipo = editables->tipo(inicioEditables + indice, cursorEditables);
+        else tipo = en(indice)->type;
+        return true;
+    }
+
+    // Primera posición en desde o después cuyo tipo es un punto de
+    // sincronización (BufferTokens::esSincronizacion), la misma a la que
+    // llegaría avanzar con tipoEn(). Solo se sabe sin recorrer los tokens
+    // con un BufferTokens, que trae el índice del lexer; si no, false.
+    // Cada búsqueda parte de donde quedó la anterior en el índice.
+    bool siguienteSincronizacion(size_t desde, size_t& posicion) {
+        if (!columnas || !indiceSincronizacion || cortado()) return false;
+        posicion = columnas->siguienteSincronizacion(desde, pistaSincronizacion);
+        // Sin ninguno queda el fin sintético, o desde si ya pasó el final
+        if (posicion == columnas->size()) posicion = std::max(desde, columnas->size());
+        return true;
+    }
+
+    // Último token de la secuencia completa; termina de leer el origen
+    const Token& ultimo() {
+        drenar();
+        return tieneFinSintetico ? finSintetico : *en(producidos - 1);
+    }
+
+    // Cantidad de tokens conocidos hasta ahora (incluye el fin sintético al terminar)
+    size_t total() const { return producidos + (tieneFinSintetico ? 1 : 0); }
+
+    // Produce el resto de los tokens para que los consumidores los reciban
+    void drenar() {
+        while (!terminado) producir();
+    }
+
+private:
+    AnalizadorLexico* lexer = nullptr;
+    const Token* lista = nullptr; // Lista recorrida: la propia o una prestada
+    size_t cantidadLista = 0;
+    std::vector<Token> propia;
+    std::unique_ptr<BufferTokens> columnas;
+    std::array<Token, VENTANA> ventana{};
+    std::array<size_t, VENTANA> indicesVentana{}; // Con columnas o editables: qué token guarda cada celda
+    const TokensEditables* editables = nullptr;
+    size_t inicioEditables = 0;
+    size_t cursorEditables = 0;
+    bool indiceSincronizacion = true;
+    size_t pistaSincronizacion = 0; // Posición en el índice de la última búsqueda
+    size_t producidos = 0;
+    bool terminado = false;
+    Token finSintetico{TOKEN_FIN_PROGRAMA, SIN_SIMBOLO, "", 0, 0};
+    bool tieneFinSintetico = false;
+    std::vector<Consumidor> consumidores;
+    std::vector<AlTerminar> alTerminarAcciones;
+
+    struct ErroresDiferidos {
+        std::string_view fuente;
+        std::vector<Error> errores;
+        std::vector<size_t> llamadas;
+        size_t cobrados;
+        std::vector<Error>* destino;
+        size_t inicioDestino;   // Errores que destino ya tenía
+        LimiteErrores* limite;
+    };
+    std::unique_ptr<ErroresDiferidos> diferidos;
+    // Tokens que reemplazan al resto de la lista desde inicioCorte, cuando
+    // el límite detiene al lexer
+    std::vector<Token> corte;
+    size_t inicioCorte = std::numeric_limits<size_t>::max();
+
+    bool cortado() const { return inicioCorte != std::numeric_limits<size_t>::max(); }
+
+    // Antes de producir el token producidos: con el límite ya agotado el
+    // lexer no habría vuelto a escanear, y si no se cobran los errores de
+    // la llamada que lo entrega
+    void cobrarErroresLexicos() {
+        ErroresDiferidos& d = *diferidos;
+        if (d.limite->agotado()) {
+            inicioCorte = producidos;
+            corte.push_back(finTrasAnterior());
+            return;
+        }
+        while (d.cobrados < d.errores.size() && d.llamadas[d.cobrados] == producidos) {
+            d.limite->registrar();
+            d.destino->push_back(d.errores[d.cobrados++]);
+            if (d.limite->agotado()) {
+                relexarHastaAgotar();
+                return;
+            }
+        }
+    }
+
+    // Fin de archivo donde el lexer quedó tras entregar el token anterior
+    // (los tokens entregados no cruzan líneas; las cadenas suman sus comillas)
+    Token finTrasAnterior() {
+        const std::string_view fin = diferidos->fuente.substr(diferidos->fuente.size());
+        if (producidos == 0) return Token{TOKEN_EOF, SIN_SIMBOLO, fin, 1, 1};
+        const Token& anterior = *en(producidos - 1);
+        int largo = static_cast<int>(anterior.value.size()) + (anterior.type == TOKEN_CADENA_LIT ? 2 : 0);
+        return Token{TOKEN_EOF, SIN_SIMBOLO, fin, anterior.line, anterior.column + largo};
+    }
+
+    // El último error cobrado agotó el límite: se repite el lexer en serie
+    // hasta ese mismo error (su racha ya no se extiende) y se toma lo que
+    // entrega desde la llamada en curso. Cuesta volver a analizar el
+    // prefijo, una sola vez por compilación
+    void relexarHastaAgotar() {
+        ErroresDiferidos& d = *diferidos;
+        std::vector<Error> rehechos;
+        LimiteErrores tope(d.cobrados, d.limite->agrupar());
+        AnalizadorLexico lexer(d.fuente, rehechos);
+        lexer.usarLimite(tope);
+        for (size_t i = 0; i < producidos; ++i) lexer.siguiente();
+        inicioCorte = producidos;
+        do {
+            corte.push_back(lexer.siguiente());
+        } while (corte.back().type != TOKEN_EOF);
+        d.destino->resize(d.inicioDestino);
+        d.destino->insert(d.destino->end(), rehechos.begin(), rehechos.end());
+    }
+
+    // Arma (una sola vez mientras siga en la ventana) el Token de un índice
+    const Token& armar(size_t indice) {
+        size_t celda = indice & (VENTANA - 1);
+        if (indicesVentana[celda] != indice) {
+            ventana[celda] = columnas ? columnas->token(indice)
+                                      : editables->token(inicioEditables + indice, cursorEditables);
+            indicesVentana[celda] = indice;
+        }
+        return ventana[celda];
+    }
+
+    // Con un BufferTokens o unos TokensEditables se llega a cualquier índice
+    // sin pasar por los anteriores, si nadie tiene que ver cada token: el
+    // parser incremental salta así lo que toma de un análisis anterior. El
+    // último token se sigue produciendo para detectar el final
+    void saltarHasta(size_t indice) {
+        if (indice <= producidos || terminado || !consumidores.empty() || diferidos) return;
+        size_t cantidad;
+        if (columnas) cantidad = columnas->size();
+        else if (editables) cantidad = editables->size() - inicioEditables;
+        else return;
+        producidos = std::max(producidos, std::min(indice, cantidad - 1));
+    }
+
+    void producir() {
+        const Token* token = nullptr;
+        TokenType tipo;
+        size_t cantidad = 0;
+        if (diferidos && !cortado()) cobrarErroresLexicos();
+        if (lexer) {
+            Token& siguiente = ventana[producidos & (VENTANA - 1)];
+            siguiente = lexer->siguiente();
+            token = &siguiente;
+            tipo = token->type;
+        } else if (producidos >= inicioCorte) {
+            token = &corte[producidos - inicioCorte];
+            tipo = token->type;
+        } else if (columnas) {
+            tipo = columnas->tipo(producidos); // El Token solo se arma si hay consumidores
+            cantidad = columnas->size();
+        } else if (editables) {
+            tipo = editables->tipo(inicioEditables + producidos, cursorEditables);
+            cantidad = editables->size() - inicioEditables;
+        } else {
+            token = &lista[producidos];
+            tipo = token->type;
+            cantidad = cantidadLista;
+        }
+        producidos++;
+        if (!consumidores.empty()) {
+            if (!token) token = &armar(producidos - 1);
+            for (auto& consumidor : consumidores) consumidor(*token);
+        }
+        if (tipo == TOKEN_EOF || (!lexer && producidos == cantidad)) {
+            terminado = true;
+            tieneFinSintetico = tipo != TOKEN_FIN_PROGRAMA;
+            for (auto& accion : alTerminarAcciones) accion();
+        }
+    }
+};
+
+#endif // TOKEN_STREAM_H
@@ -0,0 +1,216 @@
+#ifndef TOKENS_EDITABLES_H
+#define TOKENS_EDITABLES_H
+
+#include "lexer.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Lista de tokens de un texto que se edita (ver lexerIncremental.h). En
+// lugar de un vector de Token guarda bloques de unos cientos de tokens,
+// cada uno con el offset de su valor en el texto en vez de un puntero, y
+// por bloque un desplazamiento en bytes y líneas que todavía no se aplicó
+// a sus tokens. Así, después de una edición, correr lo que sigue cuesta un
+// ajuste por bloque y no uno por token, y agregar o quitar tokens solo
+// mueve los del bloque donde cayó la edición. Que el texto cambie de lugar
+// en memoria no cuesta nada: los Token se arman al pedirlos, apuntando al
+// texto actual.
+//
+// Los offsets son de 32 bits: el texto no puede pasar de 4 GiB.
+
+class TokensEditables {
+public:
+    // tokens debe ser lo que el lexer produjo sobre texto
+    TokensEditables(std::string_view texto, const std::vector<Token>& tokens, size_t tokensPorBloque = 512)
+        : textoActual(texto), porBloque(std::max<size_t>(tokensPorBloque, 2)) {
+        if (texto.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("TokensEditables: el texto supera los 4 GiB");
+        }
+        std::vector<Guardado> guardados;
+        guardados.reserve(tokens.size());
+        for (const Token& token : tokens) guardados.push_back(guardar(token));
+        cantidad = guardados.size();
+        bloques = partir(std::move(guardados), 0);
+    }
+
+    size_t size() const { return cantidad; }
+    bool empty() const { return cantidad == 0; }
+    std::string_view texto() const { return textoActual; }
+
+    // Token en la posición indicada. cursor es el bloque donde quedó la
+    // lectura anterior y queda actualizado: leyendo en orden no se busca.
+    Token token(size_t indice, size_t& cursor) const {
+        const Bloque& bloque = bloques[ubicar(indice, cursor)];
+        const Guardado& guardado = bloque.tokens[indice - bloque.inicio];
+        return Token{static_cast<TokenType>(guardado.tipo), guardado.simbolo,
+                     textoActual.substr(guardado.offset + bloque.bytes, guardado.longitud),
+                     guardado.linea + bloque.lineas, guardado.columna};
+    }
+
+    Token operator[](size_t indice) const {
+        size_t cursor = 0;
+        return token(indice, cursor);
+    }
+
+    TokenType tipo(size_t indice, size_t& cursor) const {
+        const Bloque& bloque = bloques[ubicar(indice, cursor)];
+        return static_cast<TokenType>(bloque.tokens[indice - bloque.inicio].tipo);
+    }
+
+    // Bytes [inicio, fin) que ocupa el token; las cadenas incluyen sus comillas
+    size_t inicio(size_t indice, size_t& cursor) const {
+        const Bloque& bloque = bloques[ubicar(indice, cursor)];
+        const Guardado& guardado = bloque.tokens[indice - bloque.inicio];
+        return static_cast<uint32_t>(guardado.offset + bloque.bytes) - (guardado.tipo == TOKEN_CADENA_LIT ? 1 : 0);
+    }
+
+    size_t fin(size_t indice, size_t& cursor) const {
+        const Bloque& bloque = bloques[ubicar(indice, cursor)];
+        const Guardado& guardado = bloque.tokens[indice - bloque.inicio];
+        return static_cast<uint32_t>(guardado.offset + bloque.bytes) + guardado.longitud +
+               (guardado.tipo == TOKEN_CADENA_LIT ? 1 : 0);
+    }
+
+    // Copia de la lista completa como vector de Token
+    std::vector<Token> lista() const {
+        std::vector<Token> resultado;
+        resultado.reserve(cantidad);
+        size_t cursor = 0;
+        for (size_t i = 0; i < cantidad; ++i) resultado.push_back(token(i, cursor));
+        return resultado;
+    }
+
+    // Cambia los tokens [desde, hasta) por nuevos, producidos sobre
+    // nuevoTexto, y corre bytes (en aritmética modular) y lineas los que
+    // siguen. Solo se reescribe el bloque de la edición; los siguientes
+    // acumulan el desplazamiento.
+    void reemplazar(std::string_view nuevoTexto, size_t desde, size_t hasta, const std::vector<Token>& nuevos,
+                    size_t bytes, int lineas) {
+        if (nuevoTexto.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("TokensEditables: el texto supera los 4 GiB");
+        }
+        if (desde > hasta || hasta > cantidad) throw std::out_of_range("TokensEditables: rango fuera de la lista");
+        textoActual = nuevoTexto;
+        const uint32_t corrimiento = static_cast<uint32_t>(bytes);
+
+        // Se rearman los bloques [primero, ultimo): del que tiene a desde
+        // al que tiene a hasta, cuyos tokens de después se corren aquí
+        size_t cursor = 0;
+        const size_t primero = bloques.empty() ? 0 : ubicar(std::min(desde, cantidad - 1), cursor);
+        size_t ultimo = hasta < cantidad ? ubicar(hasta, cursor) + 1 : bloques.size();
+        const size_t inicioPrimero = primero < bloques.size() ? bloques[primero].inicio : 0;
+
+        std::vector<Guardado> armados;
+        bool insertados = false;
+        auto insertar = [&] {
+            for (const Token& token : nuevos) armados.push_back(guardar(token));
+            insertados = true;
+        };
+        for (size_t b = primero; b < ultimo; ++b) {
+            const Bloque& bloque = bloques[b];
+            for (size_t i = 0; i < bloque.tokens.size(); ++i) {
+                const size_t indice = bloque.inicio + i;
+                if (indice == desde) insertar();
+                if (indice >= desde && indice < hasta) continue;
+                Guardado guardado = bloque.tokens[i];
+                guardado.offset += bloque.bytes;
+                guardado.linea += bloque.lineas;
+                if (indice >= hasta) {
+                    guardado.offset += corrimiento;
+                    guardado.linea += lineas;
+                }
+                armados.push_back(guardado);
+            }
+        }
+        if (!insertados) insertar(); // desde era el final de la lista
+
+        const size_t quitados = hasta - desde;
+        for (size_t b = ultimo; b < bloques.size(); ++b) {
+            bloques[b].inicio = bloques[b].inicio - quitados + nuevos.size();
+            bloques[b].bytes += corrimiento;
+            bloques[b].lineas += lineas;
+        }
+        cantidad = cantidad - quitados + nuevos.size();
+
+        // Un bloque que quedó chico se junta con el siguiente
+        if (armados.size() < porBloque / 2 && ultimo < bloques.size()) {
+            const Bloque& siguiente = bloques[ultimo];
+            for (Guardado guardado : siguiente.tokens) {
+                guardado.offset += siguiente.bytes;
+                guardado.linea += siguiente.lineas;
+                armados.push_back(guardado);
+            }
+            ultimo++;
+        }
+        std::vector<Bloque> partes = partir(std::move(armados), inicioPrimero);
+        bloques.erase(bloques.begin() + primero, bloques.begin() + ultimo);
+        bloques.insert(bloques.begin() + primero, std::make_move_iterator(partes.begin()),
+                       std::make_move_iterator(partes.end()));
+    }
+
+private:
+    struct Guardado {
+        uint32_t offset;
+        uint32_t longitud;
+        int linea;
+        int columna;
+        SimboloId simbolo;
+        uint8_t tipo;
+    };
+
+    // Los tokens de un bloque están corridos bytes y lineas respecto de
+    // lo guardado
+    struct Bloque {
+        size_t inicio = 0; // Índice de su primer token en la lista
+        std::vector<Guardado> tokens;
+        uint32_t bytes = 0;
+        int lineas = 0;
+    };
+
+    std::string_view textoActual;
+    size_t porBloque;
+    size_t cantidad = 0;
+    std::vector<Bloque> bloques; // Nunca vacíos
+
+    Guardado guardar(const Token& token) const {
+        return Guardado{static_cast<uint32_t>(token.value.data() - textoActual.data()),
+                        static_cast<uint32_t>(token.value.size()), token.line, token.column, token.simbolo,
+                        static_cast<uint8_t>(token.type)};
+    }
+
+    // Bloque que contiene indice, empezando por el del cursor y el siguiente
+    size_t ubicar(size_t indice, size_t& cursor) const {
+        for (size_t b = cursor; b < std::min(cursor + 2, bloques.size()); ++b) {
+            if (indice >= bloques[b].inicio && indice - bloques[b].inicio < bloques[b].tokens.size()) {
+                return cursor = b;
+            }
+        }
+        cursor = static_cast<size_t>(
+            std::upper_bound(bloques.begin(), bloques.end(), indice,
+                             [](size_t valor, const Bloque& bloque) { return valor < bloque.inicio; }) -
+            bloques.begin()) - 1;
+        return cursor;
+    }
+
+    // Corta tokens (ya sin desplazamientos pendientes) en bloques de
+    // porBloque; el último se queda con el resto si no llega al doble
+    std::vector<Bloque> partir(std::vector<Guardado> tokens, size_t inicio) const {
+        std::vector<Bloque> partes;
+        if (tokens.size() <= 2 * porBloque) {
+            if (!tokens.empty()) partes.push_back(Bloque{inicio, std::move(tokens), 0, 0});
+            return partes;
+        }
+        size_t desde = 0;
+        while (desde < tokens.size()) {
+            size_t hasta = tokens.size() - desde < 2 * porBloque ? tokens.size() : desde + porBloque;
+            partes.push_back(Bloque{inicio + desde,
+                                    std::vector<Guardado>(tokens.begin() + desde, tokens.begin() + hasta), 0, 0});
+            desde = hasta;
+        }
+        return partes;
+    }
+};
+
+#endif // TOKENS_EDITABLES_H